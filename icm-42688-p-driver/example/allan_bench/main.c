@@ -0,0 +1,147 @@
+/**
+ * @file main.c
+ * @brief Host tool: Allan variance throughput in hours of data per second
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   allan_bench [hours] [odr_hz] [threads]
+ *
+ * Generates `hours` (default 1) of samples at `odr_hz` (default 1000) with
+ * white noise of NOISE_LSB on every axis plus a slow bias random walk, then
+ * times the streaming estimator (push every sample, then report) and the
+ * offline estimator with 1 thread and with `threads` (default: online CPUs).
+ * Prints the time taken, hours of data processed per second of wall time and
+ * nanoseconds per sample. Fails if an estimator's random walk fit for
+ * gyro x is more than 10 % off the injected white noise.
+ *
+ * Build: gcc -O2 -std=gnu99 -o allan_bench main.c ../../src/allan.c -I../../inc -lm -lpthread
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../inc/allan.h"
+
+#define NOISE_LSB   8.0     /**< White noise, LSB RMS per sample */
+#define WALK_LSB    0.002   /**< Bias random walk step, LSB RMS per sample */
+#define GYRO_SCALE  (1.0f / 16.4f)
+#define ACCEL_SCALE (9.80665f / 2048.0f)
+
+/**
+ * @brief Monotonic time
+ * @return Seconds
+ */
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Deterministic standard normal value (Box-Muller)
+ * @param state Generator state
+ * @return Value with zero mean and unit variance
+ */
+static double gauss(uint64_t *state) {
+    double u[2];
+    for(int i = 0; i < 2; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        u[i] = ((double)(*state >> 11) + 0.5) / 9007199254740992.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(6.283185307179586 * u[1]);
+}
+
+/**
+ * @brief Generate white noise plus bias random walk on every axis
+ * @param s Output samples
+ * @param count Number of samples
+ */
+static void generate(icm42688_data_t *s, uint32_t count) {
+    uint64_t rng = 0xA11A5EEDull;
+    double bias[ICM42688_ALLAN_AXES] = { 0 };
+
+    for(uint32_t n = 0; n < count; n++) {
+        int16_t v[ICM42688_ALLAN_AXES];
+        for(int a = 0; a < ICM42688_ALLAN_AXES; a++) {
+            bias[a] += WALK_LSB * gauss(&rng);
+            v[a] = (int16_t)lrint(bias[a] + NOISE_LSB * gauss(&rng));
+        }
+        s[n].accel_x = v[0];
+        s[n].accel_y = v[1];
+        s[n].accel_z = v[2];
+        s[n].gyro_x = v[3];
+        s[n].gyro_y = v[4];
+        s[n].gyro_z = v[5];
+        s[n].temp = 0;
+    }
+}
+
+/**
+ * @brief Print one result line and check the gyro x random walk fit
+ * @param name Estimator
+ * @param seconds Processing time
+ * @param count Number of samples
+ * @param hours Hours of data
+ * @param rep Report
+ * @param expect Expected random walk, deg/s * sqrt(s)
+ * @return 1 if the fit is off, 0 otherwise
+ */
+static int result(const char *name, double seconds, uint32_t count, double hours,
+                  const icm42688_allan_report_t *rep, double expect) {
+    double arw = rep->fit[3].random_walk;
+    int bad = fabs(arw - expect) > 0.1 * expect;
+
+    printf("%-12s %9.3f %12.1f %10.2f %8u %12.5f%s\n", name, seconds, hours / seconds, 1e9 * seconds / count,
+           rep->octaves, arw, bad ? "  FAIL" : "");
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    static icm42688_allan_t av;
+    static icm42688_allan_report_t rep;
+    double hours = argc > 1 ? strtod(argv[1], NULL) : 1.0;
+    double odr = argc > 2 ? strtod(argv[2], NULL) : 1000.0;
+    unsigned threads = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 10) : 0;
+    double samples = hours * 3600.0 * odr;
+    char name[16];
+    int failed = 0;
+
+    if(odr <= 0.0 || samples < 1000.0 || samples > 4e9) {
+        fprintf(stderr, "usage: %s [hours] [odr_hz] [threads]\n", argv[0]);
+        return 1;
+    }
+    if(threads == 0) threads = (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t count = (uint32_t)samples;
+    icm42688_data_t *s = malloc((size_t)count * sizeof(*s));
+    if(!s) return 1;
+    generate(s, count);
+
+    /* White noise sigma per sample -> sigma * scale / sqrt(odr) at tau = 1 s */
+    double expect = NOISE_LSB * GYRO_SCALE / sqrt(odr);
+    printf("%.2f h at %.0f Hz (%u samples), noise %.1f LSB, expected ARW %.5f deg/s*sqrt(s)\n\n", hours, odr,
+           count, NOISE_LSB, expect);
+    printf("%-12s %9s %12s %10s %8s %12s\n", "estimator", "seconds", "hours/s", "ns/sample", "octaves", "arw gyro x");
+
+    double start = now_s();
+    if(icm42688_allan_init(&av, (float)odr, ACCEL_SCALE, GYRO_SCALE) != 0) return 1;
+    for(uint32_t n = 0; n < count; n++) icm42688_allan_push(&av, &s[n]);
+    if(icm42688_allan_report(&av, &rep) != 0) return 1;
+    failed |= result("streaming", now_s() - start, count, hours, &rep, expect);
+
+    start = now_s();
+    if(icm42688_allan_offline(s, count, (float)odr, ACCEL_SCALE, GYRO_SCALE, 1, &rep) != 0) return 1;
+    failed |= result("offline x1", now_s() - start, count, hours, &rep, expect);
+
+    start = now_s();
+    if(icm42688_allan_offline(s, count, (float)odr, ACCEL_SCALE, GYRO_SCALE, threads, &rep) != 0) return 1;
+    snprintf(name, sizeof(name), "offline x%u", threads);
+    failed |= result(name, now_s() - start, count, hours, &rep, expect);
+
+    free(s);
+    return failed;
+}
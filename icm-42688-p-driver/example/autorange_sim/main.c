@@ -0,0 +1,308 @@
+/**
+ * @file main.c
+ * @brief Host test: auto-ranging against a simulated sensor with FIFO latency
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   autorange_sim [batch] [seconds] [bus_us]
+ *
+ * Simulates a 1 kHz sensor behind a fake register bus: ACCEL_CONFIG0 and
+ * GYRO_CONFIG0 hold the full-scale selection, every sample is quantized and
+ * railed with the range programmed when it is taken, and FIFO_COUNTH/L
+ * reports the samples queued in a sample FIFO. In the FIFO runs every bus
+ * transfer takes `bus_us` (default 250) of sensor time, so samples keep
+ * landing in the FIFO while the range is being switched; a write applies at
+ * the end of its transfer and a count read includes what landed during it.
+ * The motion is 1 g plus
+ * periodic shocks of 3, 6 and 12 g and rotation bursts of 100, 400 and
+ * 1500 dps, the largest ones needing several range steps.
+ *
+ * Three runs over the same motion:
+ *   fifo    batches of `batch` samples (default 20) through
+ *           icm42688_autorange_process_fifo
+ *   naive   the same batches, every sample through icm42688_autorange_process
+ *           (decodes queued samples with the new range)
+ *   polled  the newest sample every period through icm42688_autorange_process
+ * For each run prints range switches, samples decoded with the wrong range
+ * (unflagged and while settling), saturated samples and the largest error of
+ * correctly scaled samples in finest-range LSB. Fails if the fifo or polled
+ * run decodes an unflagged sample with the wrong range.
+ *
+ * Build: gcc -O2 -std=gnu99 -o autorange_sim main.c ../../src/autorange.c ../../src/icm-42688.c -I../../inc -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../inc/autorange.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ODR_HZ     1000
+#define PERIOD_US  (1000000 / ODR_HZ)
+#define FIFO_MAX   (ICM42688_FIFO_SIZE / ICM42688_FIFO_PACKET3_SIZE)
+#define BATCH_MAX  FIFO_MAX
+
+typedef enum { RUN_FIFO, RUN_NAIVE, RUN_POLLED, RUNS } run_t;
+
+static const char *const run_names[RUNS] = { "fifo", "naive", "polled" };
+
+/**
+ * @brief Sample as taken by the simulated sensor
+ */
+typedef struct {
+    icm42688_data_t raw;  /**< Quantized, railed values */
+    uint8_t accel_fs;     /**< Accel range in effect */
+    uint8_t gyro_fs;      /**< Gyro range in effect */
+    double accel_g;       /**< True accel x, g */
+    double gyro_dps;      /**< True gyro z, dps */
+} sim_sample_t;
+
+static uint8_t accel_config0, gyro_config0;
+static sim_sample_t fifo[FIFO_MAX];
+static uint16_t fifo_head, fifo_count;
+static uint32_t sim_n, sim_us, sim_bus_us;
+static int fifo_overrun;
+
+static void take_sample(uint32_t n, sim_sample_t *s);
+
+/**
+ * @brief Let sensor time pass, queueing the samples taken meanwhile
+ * @param us Microseconds
+ */
+static void sensor_advance(uint32_t us) {
+    for(sim_us += us; sim_us >= PERIOD_US; sim_us -= PERIOD_US) {
+        if(fifo_count == FIFO_MAX) {
+            fifo_overrun = 1;
+            return;
+        }
+        take_sample(sim_n++, &fifo[(fifo_head + fifo_count++) % FIFO_MAX]);
+    }
+}
+
+/**
+ * @brief Fake bus read: range registers and FIFO count
+ * @param reg Register
+ * @param data Output buffer
+ * @param len Length
+ * @return 0, or -2 for registers the simulation does not model
+ */
+static int fake_read(uint8_t reg, uint8_t *data, uint16_t len) {
+    sensor_advance(sim_bus_us);
+    if(reg == ICM42688_REG_ACCEL_CONFIG0 && len == 1) {
+        data[0] = accel_config0;
+    } else if(reg == ICM42688_REG_GYRO_CONFIG0 && len == 1) {
+        data[0] = gyro_config0;
+    } else if(reg == ICM42688_REG_FIFO_COUNTH && len == 2) {
+        uint16_t bytes = (uint16_t)(fifo_count * ICM42688_FIFO_PACKET3_SIZE);
+        data[0] = (uint8_t)(bytes >> 8);
+        data[1] = (uint8_t)bytes;
+    } else {
+        return -2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fake bus write: range registers
+ * @param reg Register
+ * @param data Data
+ * @param len Length
+ * @return 0, or -2 for registers the simulation does not model
+ */
+static int fake_write(uint8_t reg, uint8_t *data, uint16_t len) {
+    sensor_advance(sim_bus_us);
+    if(len != 1) return -2;
+    if(reg == ICM42688_REG_ACCEL_CONFIG0) {
+        accel_config0 = data[0];
+    } else if(reg == ICM42688_REG_GYRO_CONFIG0) {
+        gyro_config0 = data[0];
+    } else {
+        return -2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Quantize with a range and rail at the 16-bit limits
+ * @param value Physical value
+ * @param lsb_per_unit Sensitivity of the range
+ * @return Raw value
+ */
+static int16_t quantize(double value, double lsb_per_unit) {
+    double v = round(value * lsb_per_unit);
+    if(v > 32767.0) return 32767;
+    if(v < -32768.0) return -32768;
+    return (int16_t)v;
+}
+
+/**
+ * @brief Motion at sample n: 1 g with shocks, rotation bursts
+ * @param n Sample index
+ * @param accel_g Output: accel x in g
+ * @param gyro_dps Output: gyro z in dps
+ */
+static void motion(uint32_t n, double *accel_g, double *gyro_dps) {
+    static const double shock_g[3] = { 3.0, 6.0, 12.0 };
+    static const double burst_dps[3] = { 100.0, 400.0, 1500.0 };
+    uint32_t period = n / 1500, phase = n % 1500;
+
+    *accel_g = 1.0;
+    *gyro_dps = 0.0;
+    if(phase >= 300 && phase < 310) *accel_g += shock_g[period % 3] * sin(M_PI * (phase - 300) / 10.0);
+    if(phase >= 800 && phase < 1000) *gyro_dps = burst_dps[period % 3] * sin(M_PI * (phase - 800) / 200.0);
+}
+
+/**
+ * @brief Take one sample with the ranges currently programmed
+ * @param n Sample index
+ * @param s Output sample
+ */
+static void take_sample(uint32_t n, sim_sample_t *s) {
+    memset(s, 0, sizeof(*s));
+    motion(n, &s->accel_g, &s->gyro_dps);
+    s->accel_fs = accel_config0 >> 5;
+    s->gyro_fs = gyro_config0 >> 5;
+    s->raw.accel_x = quantize(s->accel_g, 2048.0 * (1 << s->accel_fs));
+    s->raw.gyro_z = quantize(s->gyro_dps, 16.384 * (1 << s->gyro_fs));
+}
+
+/**
+ * @brief Per-run results
+ */
+typedef struct {
+    uint32_t switches;     /**< Range changes */
+    uint32_t wrong;        /**< Unflagged samples decoded with the wrong range */
+    uint32_t wrong_flagged;/**< Settling samples decoded with the wrong range */
+    uint32_t saturated;    /**< Samples with a railed axis */
+    double max_err;        /**< Largest error of correctly scaled, unsaturated samples, finest LSB */
+} result_t;
+
+/**
+ * @brief Score one decoded sample against the simulated truth
+ * @param s Simulated sample
+ * @param out Decoded sample
+ * @param r Results
+ */
+static void score(const sim_sample_t *s, const icm42688_ranged_sample_t *out, result_t *r) {
+    int wrong = out->accel_fs != s->accel_fs || out->gyro_fs != s->gyro_fs;
+
+    if(out->sat_mask) r->saturated++;
+    if(wrong) {
+        if(out->flags) {
+            r->wrong_flagged++;
+        } else {
+            r->wrong++;
+        }
+        return;
+    }
+    if(out->sat_mask) return;
+
+    /* Quantization of the coarse ranges is up to half their LSB */
+    double ea = fabs(out->accel[0] - s->accel_g * 16384.0) / (1 << (ICM42688_ACCEL_FS_2G - out->accel_fs));
+    double eg = fabs(out->gyro[2] - s->gyro_dps * 2097.152) / (1 << (ICM42688_GYRO_FS_15_625DPS - out->gyro_fs));
+    if(ea > r->max_err) r->max_err = ea;
+    if(eg > r->max_err) r->max_err = eg;
+}
+
+/**
+ * @brief Run the controller over the simulated motion
+ * @param run Read path
+ * @param batch FIFO batch size in samples
+ * @param bus_us Sensor time per bus transfer in the FIFO runs
+ * @param samples Number of sensor samples
+ * @param r Output results
+ * @return 0 on success, negative value on error
+ */
+static int simulate(run_t run, uint16_t batch, uint32_t bus_us, uint32_t samples, result_t *r) {
+    static icm42688_autorange_t ar;
+    static icm42688_data_t raw[BATCH_MAX];
+    static icm42688_ranged_sample_t out[BATCH_MAX];
+    static sim_sample_t taken[BATCH_MAX];
+    icm42688_t dev;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.bus.read = fake_read;
+    dev.bus.write = fake_write;
+    memset(r, 0, sizeof(*r));
+    accel_config0 = gyro_config0 = 0;
+    fifo_head = fifo_count = 0;
+    sim_n = sim_us = sim_bus_us = 0;
+    fifo_overrun = 0;
+
+    if(icm42688_autorange_init(&ar, &dev, NULL, ICM42688_ACCEL_FS_2G, ICM42688_GYRO_FS_250DPS) != 0) return -1;
+
+    if(run == RUN_POLLED) {
+        for(uint32_t n = 0; n < samples; n++) {
+            sim_sample_t s;
+            take_sample(n, &s);
+            if(icm42688_autorange_process(&ar, &s.raw, &out[0]) < 0) return -2;
+            score(&s, &out[0], r);
+        }
+        r->switches = ar.accel.switches + ar.gyro.switches;
+        return 0;
+    }
+
+    sim_bus_us = bus_us;
+    while(sim_n < samples) {
+        if(fifo_count < batch) {
+            sensor_advance(PERIOD_US);
+            if(fifo_overrun) return -3;
+            continue;
+        }
+
+        /* Watermark: the host pops the batch, the next samples queue up behind it */
+        for(uint16_t i = 0; i < batch; i++) {
+            taken[i] = fifo[fifo_head];
+            raw[i] = taken[i].raw;
+            fifo_head = (uint16_t)((fifo_head + 1) % FIFO_MAX);
+            fifo_count--;
+        }
+        if(run == RUN_FIFO) {
+            if(icm42688_autorange_process_fifo(&ar, raw, batch, ICM42688_FIFO_PACKET3_SIZE, out) < 0) return -2;
+        } else {
+            for(uint16_t i = 0; i < batch; i++) {
+                if(icm42688_autorange_process(&ar, &raw[i], &out[i]) < 0) return -2;
+            }
+        }
+        if(fifo_overrun) return -3;
+        for(uint16_t i = 0; i < batch; i++) score(&taken[i], &out[i], r);
+    }
+    r->switches = ar.accel.switches + ar.gyro.switches;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    uint16_t batch = argc > 1 ? (uint16_t)strtoul(argv[1], NULL, 10) : 20;
+    double seconds = argc > 2 ? strtod(argv[2], NULL) : 60.0;
+    uint32_t bus_us = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 250;
+    uint32_t samples = (uint32_t)(seconds * ODR_HZ);
+    int failed = 0;
+
+    if(batch == 0 || batch >= FIFO_MAX || samples < 1500 || bus_us > PERIOD_US) {
+        fprintf(stderr, "usage: %s [batch 1..%d] [seconds >= 1.5] [bus_us <= %d]\n", argv[0], FIFO_MAX - 1,
+                PERIOD_US);
+        return 1;
+    }
+
+    printf("%u samples at %d Hz, FIFO batches of %u, %u us per bus transfer\n\n", samples, ODR_HZ, batch, bus_us);
+    printf("%-7s %9s %12s %14s %10s %14s\n", "run", "switches", "wrong range", "wrong, flagged", "saturated",
+           "max err (LSB)");
+    for(int run = 0; run < RUNS; run++) {
+        result_t r;
+        int ret = simulate((run_t)run, batch, bus_us, samples, &r);
+        if(ret != 0) {
+            printf("%-7s simulation error %d\n", run_names[run], ret);
+            return 1;
+        }
+        int bad = run != RUN_NAIVE && r.wrong;
+        printf("%-7s %9u %12u %14u %10u %14.1f%s\n", run_names[run], r.switches, r.wrong, r.wrong_flagged,
+               r.saturated, r.max_err, bad ? "  FAIL" : "");
+        if(bad) failed = 1;
+    }
+    return failed;
+}
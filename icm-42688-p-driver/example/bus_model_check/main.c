@@ -0,0 +1,148 @@
+/**
+ * @file main.c
+ * @brief Host test: bus timing model and capacity planner
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   bus_model_check
+ *
+ * Compares single-transaction times with values counted by hand from the
+ * I2C and SPI frame layouts, checks that the planner rejects invalid
+ * configurations (zero or oversized FIFO watermark, unknown strategy,
+ * device count out of range) and that its totals are consistent: bus
+ * utilization is the sum of the per-device occupancy, payload matches the
+ * strategy, and FIFO bursts beat per-sample reads on the same bus. Prints
+ * one line per check and exits nonzero if any fails.
+ *
+ * Build: gcc -O2 -std=gnu99 -o bus_model_check main.c ../../src/bus_model.c -I../../inc -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "../../inc/bus_model.h"
+#include "../../inc/icm-42688.h"
+
+static int failures;
+
+/**
+ * @brief Report one check
+ * @param ok Check result
+ * @param what Description
+ */
+static void check(int ok, const char *what) {
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if(!ok) failures++;
+}
+
+/**
+ * @brief Describe a device
+ * @param odr_hz Output data rate
+ * @param strategy Read strategy
+ * @param watermark FIFO watermark in samples (0 for per-sample reads)
+ * @return Device description
+ */
+static icm42688_bus_device_t device(uint32_t odr_hz, icm42688_read_strategy_t strategy, uint16_t watermark) {
+    icm42688_bus_device_t d;
+    memset(&d, 0, sizeof(d));
+    d.odr_hz = odr_hz;
+    d.strategy = strategy;
+    d.sample_bytes = strategy == ICM42688_READ_FIFO_BURST ? ICM42688_FIFO_PACKET3_SIZE : 14;
+    d.watermark = watermark;
+    return d;
+}
+
+/**
+ * @brief Transaction times against hand-counted frames
+ */
+static void check_transactions(void) {
+    icm42688_bus_timing_t i2c, spi;
+
+    check(icm42688_bus_timing_default(&i2c, ICM42688_BUS_I2C, 400000) == 0, "I2C 400 kHz timing");
+    check(icm42688_bus_timing_default(&spi, ICM42688_BUS_SPI, 8000000) == 0, "SPI 8 MHz timing");
+    check(icm42688_bus_timing_default(&i2c, (icm42688_bus_type_t)7, 400000) != 0, "unknown bus type rejected");
+    check(icm42688_bus_timing_default(&i2c, ICM42688_BUS_I2C, 0) != 0, "zero clock rejected");
+    icm42688_bus_timing_default(&i2c, ICM42688_BUS_I2C, 400000);
+
+    /* 39 bits at 2.5 us, tBUF 1.3 us, 4 byte gaps of 0.2 us, 3 us HAL call */
+    check(icm42688_bus_read_ns(&i2c, 1) == 97500 + 1300 + 800 + 3000, "I2C 1-byte read");
+    /* 156 bits, 17 byte gaps */
+    check(icm42688_bus_read_ns(&i2c, 14) == 390000 + 1300 + 3400 + 3000, "I2C 14-byte read");
+    /* 29 bits, 3 byte gaps */
+    check(icm42688_bus_write_ns(&i2c, 1) == 72500 + 1300 + 600 + 3000, "I2C 1-byte write");
+    /* 120 bits at 125 ns, CS 1 us, 15 byte gaps of 0.5 us, two 1.5 us HAL calls */
+    check(icm42688_bus_read_ns(&spi, 14) == 15000 + 1000 + 7500 + 3000, "SPI 14-byte read");
+    check(icm42688_bus_read_ns(NULL, 14) == 0, "NULL timing yields zero");
+}
+
+/**
+ * @brief Parameter validation of the planner
+ */
+static void check_validation(void) {
+    static icm42688_bus_plan_t plan;
+    icm42688_bus_timing_t t;
+    icm42688_bus_device_t d[ICM42688_BUS_MAX_DEVICES + 1];
+    uint16_t capacity = ICM42688_FIFO_SIZE / ICM42688_FIFO_PACKET3_SIZE;
+
+    icm42688_bus_timing_default(&t, ICM42688_BUS_SPI, 8000000);
+    for(int i = 0; i <= ICM42688_BUS_MAX_DEVICES; i++) d[i] = device(1000, ICM42688_READ_PER_SAMPLE, 0);
+
+    check(icm42688_bus_plan(&t, d, 0, &plan) == -1, "zero devices rejected");
+    check(icm42688_bus_plan(&t, d, ICM42688_BUS_MAX_DEVICES + 1, &plan) == -1, "too many devices rejected");
+    check(icm42688_bus_plan(&t, d, ICM42688_BUS_MAX_DEVICES, &plan) == 0, "maximum device count accepted");
+
+    d[0] = device(1000, ICM42688_READ_FIFO_BURST, 0);
+    check(icm42688_bus_plan(&t, d, 1, &plan) == -1, "zero watermark rejected");
+    d[0] = device(1000, ICM42688_READ_FIFO_BURST, capacity);
+    check(icm42688_bus_plan(&t, d, 1, &plan) == -1, "watermark filling the FIFO rejected");
+    d[0] = device(1000, ICM42688_READ_FIFO_BURST, 60000);
+    check(icm42688_bus_plan(&t, d, 1, &plan) == -1, "oversized watermark rejected");
+    d[0] = device(1000, ICM42688_READ_FIFO_BURST, (uint16_t)(capacity - 1));
+    check(icm42688_bus_plan(&t, d, 1, &plan) == 0, "watermark one below capacity accepted");
+    d[0] = device(1000, (icm42688_read_strategy_t)5, 0);
+    check(icm42688_bus_plan(&t, d, 1, &plan) == -1, "unknown strategy rejected");
+    d[0] = device(0, ICM42688_READ_PER_SAMPLE, 0);
+    check(icm42688_bus_plan(&t, d, 1, &plan) == -1, "zero ODR rejected");
+}
+
+/**
+ * @brief Consistency of planner totals
+ */
+static void check_plans(void) {
+    static icm42688_bus_plan_t per_sample, burst;
+    icm42688_bus_timing_t t;
+    icm42688_bus_device_t d[3];
+    uint64_t busy = 0;
+
+    icm42688_bus_timing_default(&t, ICM42688_BUS_I2C, 1000000);
+
+    for(int i = 0; i < 3; i++) d[i] = device(1000, ICM42688_READ_PER_SAMPLE, 0);
+    check(icm42688_bus_plan(&t, d, 3, &per_sample) == 0, "3 x 1 kHz per-sample plan");
+    for(int i = 0; i < 3; i++) busy += per_sample.device[i].bus_ns_per_sec;
+    check(fabs(per_sample.utilization - busy / 1e9) < 1e-6, "utilization is the sum of device occupancy");
+    check(per_sample.bytes_per_sec == 3 * 1000 * 14, "per-sample payload");
+    check(per_sample.device[0].worst_latency_ns == 3 * per_sample.device[0].transaction_ns,
+          "per-sample worst latency waits for every device");
+
+    for(int i = 0; i < 3; i++) d[i] = device(1000, ICM42688_READ_FIFO_BURST, 20);
+    check(icm42688_bus_plan(&t, d, 3, &burst) == 0, "3 x 1 kHz FIFO/20 plan");
+    check(burst.bytes_per_sec == 3 * 50 * (3 + 20 * ICM42688_FIFO_PACKET3_SIZE), "burst payload");
+    check(burst.utilization < per_sample.utilization, "bursts use less bus time than per-sample reads");
+    check(burst.feasible, "bursts are feasible at 1 MHz");
+    check(fabs(burst.headroom - (1.0f - burst.utilization)) < 1e-6, "headroom complements utilization");
+
+    icm42688_bus_timing_default(&t, ICM42688_BUS_I2C, 100000);
+    for(int i = 0; i < 3; i++) d[i] = device(8000, ICM42688_READ_PER_SAMPLE, 0);
+    check(icm42688_bus_plan(&t, d, 3, &per_sample) == 0 && !per_sample.feasible,
+          "3 x 8 kHz per-sample on 100 kHz I2C is infeasible");
+}
+
+int main(void) {
+    check_transactions();
+    check_validation();
+    check_plans();
+
+    printf("\n%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
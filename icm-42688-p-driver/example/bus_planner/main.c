@@ -0,0 +1,145 @@
+/**
+ * @file main.c
+ * @brief Host tool: bus capacity planner for ICM-42688 deployments
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   bus_planner <i2c|spi> <clock_hz> <device> [<device> ...]
+ *
+ * Device syntax:
+ *   <odr_hz>:sample            read_all (14 bytes) per sample
+ *   <odr_hz>:fifo:<watermark>  FIFO packet 3 burst every <watermark> samples
+ *   <n>x<device>               n identical devices
+ *
+ * Example:
+ *   bus_planner i2c 400000 3x1000:sample
+ *   bus_planner i2c 400000 3x1000:fifo:20
+ *   bus_planner spi 8000000 3x8000:fifo:32
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../inc/bus_model.h"
+#include "../../inc/icm-42688.h"
+
+/**
+ * @brief Parse one device argument
+ * @param arg Argument string
+ * @param dev Pointer to device description
+ * @param repeat Pointer to repeat count
+ * @return 0 on success, negative value on error
+ */
+static int parse_device(const char *arg, icm42688_bus_device_t *dev, unsigned *repeat) {
+    char buf[64];
+    char *p = buf;
+    char *x;
+
+    strncpy(buf, arg, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    *repeat = 1;
+    if((x = strchr(p, 'x')) != NULL) {
+        *x = '\0';
+        *repeat = (unsigned)strtoul(p, NULL, 10);
+        p = x + 1;
+    }
+
+    char *odr = strtok(p, ":");
+    char *mode = strtok(NULL, ":");
+    char *wm = strtok(NULL, ":");
+    if(!odr || !mode || *repeat == 0) return -1;
+
+    memset(dev, 0, sizeof(*dev));
+    dev->odr_hz = (uint32_t)strtoul(odr, NULL, 10);
+
+    if(strcmp(mode, "sample") == 0) {
+        dev->strategy = ICM42688_READ_PER_SAMPLE;
+        dev->sample_bytes = 14;
+    } else if(strcmp(mode, "fifo") == 0 && wm) {
+        dev->strategy = ICM42688_READ_FIFO_BURST;
+        dev->sample_bytes = ICM42688_FIFO_PACKET3_SIZE;
+        unsigned long w = strtoul(wm, NULL, 10);
+        if(w == 0 || w > UINT16_MAX) return -1;
+        dev->watermark = (uint16_t)w;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    icm42688_bus_timing_t timing;
+    icm42688_bus_device_t devs[ICM42688_BUS_MAX_DEVICES];
+    static icm42688_bus_plan_t plan;
+    uint8_t count = 0;
+
+    if(argc < 4) {
+        fprintf(stderr, "usage: %s <i2c|spi> <clock_hz> <odr>:sample|<odr>:fifo:<wm> ...\n", argv[0]);
+        return 1;
+    }
+
+    icm42688_bus_type_t type;
+    if(strcmp(argv[1], "i2c") == 0) {
+        type = ICM42688_BUS_I2C;
+    } else if(strcmp(argv[1], "spi") == 0) {
+        type = ICM42688_BUS_SPI;
+    } else {
+        fprintf(stderr, "invalid bus: %s (expected i2c or spi)\n", argv[1]);
+        return 1;
+    }
+    if(icm42688_bus_timing_default(&timing, type, (uint32_t)strtoul(argv[2], NULL, 10)) != 0) {
+        fprintf(stderr, "invalid bus clock\n");
+        return 1;
+    }
+
+    for(int i = 3; i < argc; i++) {
+        icm42688_bus_device_t dev;
+        unsigned repeat;
+
+        if(parse_device(argv[i], &dev, &repeat) != 0) {
+            fprintf(stderr, "invalid device: %s\n", argv[i]);
+            return 1;
+        }
+        while(repeat--) {
+            if(count >= ICM42688_BUS_MAX_DEVICES) {
+                fprintf(stderr, "too many devices (max %d)\n", ICM42688_BUS_MAX_DEVICES);
+                return 1;
+            }
+            devs[count++] = dev;
+        }
+    }
+
+    if(icm42688_bus_plan(&timing, devs, count, &plan) != 0) {
+        fprintf(stderr, "invalid configuration\n");
+        return 1;
+    }
+
+    printf("bus: %s @ %lu Hz, %u device(s)\n\n", type == ICM42688_BUS_SPI ? "SPI" : "I2C",
+           (unsigned long)timing.clock_hz, count);
+    printf("dev  odr_hz  strategy      read_us  reads/s  busy_ms/s  worst_latency_us  keeps_up\n");
+
+    for(uint8_t i = 0; i < count; i++) {
+        const icm42688_bus_device_plan_t *r = &plan.device[i];
+        char strategy[16];
+
+        if(devs[i].strategy == ICM42688_READ_FIFO_BURST) {
+            snprintf(strategy, sizeof(strategy), "fifo/%u", devs[i].watermark);
+        } else {
+            snprintf(strategy, sizeof(strategy), "sample");
+        }
+
+        printf("%3u  %6lu  %-12s  %7.1f  %7lu  %9.2f  %16.1f  %s\n", i, (unsigned long)devs[i].odr_hz, strategy,
+               r->transaction_ns / 1000.0, (unsigned long)r->reads_per_sec, r->bus_ns_per_sec / 1e6,
+               r->worst_latency_ns / 1000.0, r->keeps_up ? "yes" : "NO");
+    }
+
+    printf("\nutilization: %.1f %%\n", plan.utilization * 100.0f);
+    printf("headroom:    %.1f %%\n", plan.headroom * 100.0f);
+    printf("payload:     %lu B/s\n", (unsigned long)plan.bytes_per_sec);
+    printf("verdict:     %s\n", plan.feasible ? "OK" : "NOT FEASIBLE");
+
+    return plan.feasible ? 0 : 2;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file main.c
+ * @brief Host tool: reduction ratio and reconstruction error of send-on-delta on simulated motion
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   deadband_sim [accel_deadband] [gyro_deadband] [max_interval] [noise_scale]
+ *
+ * Generates 60 s of 1 kHz raw samples (+-2 g, +-15.625 dps scale) for a few
+ * motion profiles (sensor noise multiplied by noise_scale, default 1), runs
+ * them through the sender and the receiver with both predictors and prints
+ * the fraction of samples sent and the RMS / maximum error of the rebuilt
+ * stream in LSB.
+ *
+ * A second pass loses 1 % of the sent samples and starts the receiver 10 s
+ * late, and prints how much of the stream the receiver still rebuilds. The
+ * tool fails if any rebuilt sample in either pass is outside the deadband.
+ *
+ * Build: gcc -O2 -std=gnu99 -o deadband_sim main.c ../../src/deadband.c -I../../inc -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../inc/deadband.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ODR_HZ   1000
+#define SECONDS  60
+#define SAMPLES  (ODR_HZ * SECONDS)
+#define LOSS_PCT 1
+#define JOIN_AT  (10 * ODR_HZ)
+
+typedef enum { STILL, ROTATION, VIBRATION, HANDLING, PROFILES } profile_t;
+
+static const char *const profile_names[PROFILES] = { "still", "slow rotation", "vibration 50 Hz", "handling" };
+
+/**
+ * @brief Deterministic Gaussian noise (Box-Muller on a xorshift generator)
+ * @param state Generator state
+ * @return Standard normal value
+ */
+static double gauss(uint32_t *state) {
+    double u[2];
+    for(int i = 0; i < 2; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 17;
+        *state ^= *state << 5;
+        u[i] = ((double)*state + 1.0) / 4294967297.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+/**
+ * @brief Clamp to int16
+ * @param v Value
+ * @return Rounded, saturated value
+ */
+static int16_t raw(double v) {
+    v = floor(v + 0.5);
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+/**
+ * @brief Result of one sender/receiver run
+ */
+typedef struct {
+    uint32_t sent;      /**< Samples sent */
+    uint32_t rebuilt;   /**< Samples the receiver produced */
+    double rms;         /**< RMS error of the produced samples in LSB */
+    int32_t max;        /**< Maximum error in LSB */
+    int32_t over;       /**< Channel values outside the deadband */
+} run_result_t;
+
+/**
+ * @brief Generate one profile
+ * @param p Profile
+ * @param noise Noise scale
+ * @param out Output samples (SAMPLES entries)
+ */
+static void generate(profile_t p, double noise, icm42688_sample_t *out) {
+    uint32_t rng = 0x1234567u + (uint32_t)p;
+    double angle = 0.0, step_g[3] = { 0, 0, 0 };
+
+    for(int n = 0; n < SAMPLES; n++) {
+        double t = (double)n / ODR_HZ;
+        double a[3] = { 0.0, 0.0, 16384.0 };   /* 1 g on Z */
+        double w[3] = { 0.0, 0.0, 0.0 };
+
+        switch(p) {
+        case ROTATION:
+            /* Rolling back and forth, +-8 dps at 0.2 Hz */
+            w[0] = 8.0 * 2097.2 * sin(2.0 * M_PI * 0.2 * t);
+            angle += w[0] / 2097.2 / ODR_HZ * M_PI / 180.0;
+            a[1] = 16384.0 * sin(angle);
+            a[2] = 16384.0 * cos(angle);
+            break;
+        case VIBRATION:
+            a[2] += 800.0 * sin(2.0 * M_PI * 50.0 * t);
+            w[1] = 300.0 * sin(2.0 * M_PI * 50.0 * t + 0.5);
+            break;
+        case HANDLING:
+            /* Picked up and set down: a new tilt every 2 s */
+            if(n % (2 * ODR_HZ) == 0) {
+                for(int i = 0; i < 3; i++) step_g[i] = 3000.0 * gauss(&rng);
+            }
+            for(int i = 0; i < 3; i++) a[i] += step_g[i];
+            break;
+        default:
+            break;
+        }
+
+        out[n].data.accel_x = raw(a[0] + noise * 20.0 * gauss(&rng));
+        out[n].data.accel_y = raw(a[1] + noise * 20.0 * gauss(&rng));
+        out[n].data.accel_z = raw(a[2] + noise * 20.0 * gauss(&rng));
+        out[n].data.gyro_x = raw(w[0] + noise * 60.0 * gauss(&rng));
+        out[n].data.gyro_y = raw(w[1] + noise * 60.0 * gauss(&rng));
+        out[n].data.gyro_z = raw(w[2] + noise * 60.0 * gauss(&rng));
+        out[n].data.temp = raw(3300.0 + 0.5 * gauss(&rng));
+        out[n].timestamp_us = (uint32_t)n * (1000000u / ODR_HZ);
+    }
+}
+
+/**
+ * @brief Send a profile through the sender and rebuild it at the receiver
+ * @param in Input samples (SAMPLES entries)
+ * @param cfg Reduction configuration
+ * @param lossy Lose LOSS_PCT % of the sent samples and start the receiver at JOIN_AT
+ * @param r Output result
+ * @return Sender statistics
+ */
+static icm42688_deadband_stats_t run(const icm42688_sample_t *in, const icm42688_deadband_config_t *cfg,
+                                     int lossy, run_result_t *r) {
+    static icm42688_sample_t chunk[65536];
+    icm42688_deadband_t tx;
+    icm42688_deadband_model_t rx;
+    icm42688_reduced_sample_t msg;
+    uint32_t rng = 0xD40Bu;
+    double sum2 = 0.0;
+
+    icm42688_deadband_init(&tx, cfg);
+    icm42688_deadband_model_init(&rx, cfg->predict);
+    r->rebuilt = 0;
+    r->max = r->over = 0;
+
+    for(int n = 0; n < SAMPLES; n++) {
+        if(icm42688_deadband_process(&tx, &in[n], &msg) != 1) continue;
+        if(lossy) {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            if(n < JOIN_AT || rng % 100 < LOSS_PCT) continue;
+        }
+        int k = icm42688_deadband_expand(&rx, &msg, chunk, 65536);
+
+        /* Score against the input sample with the same timestamp */
+        for(int i = 0; i < k; i++) {
+            const icm42688_data_t *a = &in[chunk[i].timestamp_us / (1000000u / ODR_HZ)].data;
+            const icm42688_data_t *b = &chunk[i].data;
+            int16_t ch_a[6] = { a->accel_x, a->accel_y, a->accel_z, a->gyro_x, a->gyro_y, a->gyro_z };
+            int16_t ch_b[6] = { b->accel_x, b->accel_y, b->accel_z, b->gyro_x, b->gyro_y, b->gyro_z };
+            for(int c = 0; c < 6; c++) {
+                int32_t e = abs(ch_a[c] - ch_b[c]);
+                sum2 += (double)e * e;
+                if(e > r->max) r->max = e;
+                if(e > (c < 3 ? cfg->accel_deadband : cfg->gyro_deadband)) r->over++;
+            }
+        }
+        r->rebuilt += (uint32_t)k;
+    }
+    r->sent = tx.stats.out;
+    r->rms = sqrt(sum2 / (6.0 * (r->rebuilt ? r->rebuilt : 1)));
+    return tx.stats;
+}
+
+int main(int argc, char **argv) {
+    static icm42688_sample_t in[SAMPLES];
+    icm42688_deadband_config_t cfg;
+    double noise = 1.0;
+    int failed = 0;
+
+    icm42688_deadband_config_default(&cfg);
+    if(argc > 1) cfg.accel_deadband = (uint16_t)strtoul(argv[1], NULL, 10);
+    if(argc > 2) cfg.gyro_deadband = (uint16_t)strtoul(argv[2], NULL, 10);
+    if(argc > 3) cfg.max_interval = (uint16_t)strtoul(argv[3], NULL, 10);
+    if(argc > 4) noise = strtod(argv[4], NULL);
+
+    printf("deadband accel %u gyro %u LSB, heartbeat %u samples, noise x%.2f\n\n",
+           cfg.accel_deadband, cfg.gyro_deadband, cfg.max_interval, noise);
+    printf("%-16s %-7s %9s %8s %10s %10s\n", "profile", "predict", "sent", "ratio", "rms [LSB]", "max [LSB]");
+
+    for(int p = 0; p < PROFILES; p++) {
+        generate((profile_t)p, noise, in);
+
+        for(int mode = ICM42688_PREDICT_HOLD; mode <= ICM42688_PREDICT_LINEAR; mode++) {
+            run_result_t r;
+
+            cfg.predict = (icm42688_predict_t)mode;
+            icm42688_deadband_stats_t st = run(in, &cfg, 0, &r);
+            if(r.over) failed = 1;
+
+            /* The tail after the last sent sample is still pending at the sender */
+            printf("%-16s %-7s %9u %7.1f%% %10.1f %10d%s\n", profile_names[p],
+                   mode == ICM42688_PREDICT_HOLD ? "hold" : "linear", r.sent,
+                   100.0 * st.out / st.in, r.rms, r.max, r.over ? "  DEADBAND EXCEEDED" : "");
+        }
+    }
+
+    printf("\n%d %% of sent samples lost, receiver joins after %d s\n\n", LOSS_PCT, JOIN_AT / ODR_HZ);
+    printf("%-16s %-7s %9s %10s %10s\n", "profile", "predict", "rebuilt", "rms [LSB]", "max [LSB]");
+
+    for(int p = 0; p < PROFILES; p++) {
+        generate((profile_t)p, noise, in);
+
+        for(int mode = ICM42688_PREDICT_HOLD; mode <= ICM42688_PREDICT_LINEAR; mode++) {
+            run_result_t r;
+
+            cfg.predict = (icm42688_predict_t)mode;
+            run(in, &cfg, 1, &r);
+            if(r.over) failed = 1;
+
+            printf("%-16s %-7s %8.1f%% %10.1f %10d%s\n", profile_names[p],
+                   mode == ICM42688_PREDICT_HOLD ? "hold" : "linear", 100.0 * r.rebuilt / (SAMPLES - JOIN_AT),
+                   r.rms, r.max, r.over ? "  DEADBAND EXCEEDED" : "");
+        }
+    }
+    return failed;
+}
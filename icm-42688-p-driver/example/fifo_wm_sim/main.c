@@ -0,0 +1,308 @@
+/**
+ * @file main.c
+ * @brief Host tool: adaptive FIFO watermark under bursty consumer load
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   fifo_wm_sim [latency_budget_us] [seconds] [max_stall_us]
+ *
+ * Simulates a 1 kHz sensor writing packet 3 into a 2 KiB stream-mode FIFO
+ * behind a fake register bus (FIFO_CONFIG2/3, INT_STATUS, FIFO_COUNT,
+ * FIFO_DATA; a full FIFO drops its oldest packet). The consumer alternates
+ * every 5 s between a calm phase (0.2-0.6 ms service delay) and a bursty
+ * phase where 30 % of the interrupts are serviced only after a stall of up
+ * to max_stall_us (default 30000).
+ *
+ * The same load is run with two fixed watermarks and with the controller.
+ * Lost samples are counted from gaps in the decoded 16-bit FIFO timestamps,
+ * sample age from the unwrapped timestamp at the moment the batch is parsed.
+ * The tool fails if the controller loses samples, interrupts as often as a
+ * fixed watermark of 1, or reprograms on more than 5 % of its interrupts. When
+ * the stalls are long enough that even a fixed watermark of 1 misses the
+ * budget, the controller must not miss it more often.
+ *
+ * Build: gcc -O2 -std=gnu99 -o fifo_wm_sim main.c ../../src/fifo_watermark.c ../../src/icm-42688.c -I../../inc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../inc/fifo_watermark.h"
+
+#define ODR_HZ     1000
+#define PERIOD_US  (1000000u / ODR_HZ)
+#define PHASE_US   5000000u
+#define MAX_BATCH  (ICM42688_FIFO_SIZE / ICM42688_FIFO_PACKET3_SIZE)
+
+/**
+ * @brief Outcome of one run
+ */
+typedef struct {
+    uint32_t interrupts; /**< Watermark interrupts */
+    uint32_t reprograms; /**< Watermark register writes */
+    uint32_t lost;       /**< Samples lost or with bad timestamps */
+    double over_budget;  /**< Fraction of samples older than the budget */
+} run_result_t;
+
+/**
+ * @brief Fake sensor FIFO behind the register bus
+ */
+typedef struct {
+    uint8_t data[ICM42688_FIFO_SIZE];
+    uint16_t head;      /**< Read position */
+    uint16_t count;     /**< Stored bytes */
+    uint16_t watermark; /**< FIFO_CONFIG2/3 */
+    uint8_t status;     /**< INT_STATUS, cleared on read */
+    uint8_t ths;        /**< Watermark interrupt raised and not yet drained below */
+    uint32_t dropped;   /**< Packets overwritten while full */
+} fake_fifo_t;
+
+static fake_fifo_t fifo;
+
+/**
+ * @brief Fake bus read
+ * @param reg Register address
+ * @param data Destination buffer
+ * @param len Number of bytes
+ * @return 0
+ */
+static int fake_read(uint8_t reg, uint8_t *data, uint16_t len) {
+    switch(reg) {
+    case ICM42688_REG_INT_STATUS:
+        data[0] = fifo.status;
+        fifo.status = 0;
+        break;
+    case ICM42688_REG_FIFO_COUNTH:
+        data[0] = (uint8_t)(fifo.count >> 8);
+        if(len > 1) data[1] = (uint8_t)fifo.count;
+        break;
+    case ICM42688_REG_FIFO_DATA:
+        for(uint16_t i = 0; i < len; i++) {
+            if(fifo.count == 0) {
+                data[i] = 0xFF;
+                continue;
+            }
+            data[i] = fifo.data[fifo.head];
+            fifo.head = (uint16_t)((fifo.head + 1) % ICM42688_FIFO_SIZE);
+            fifo.count--;
+        }
+        if(fifo.count < fifo.watermark) fifo.ths = 0;
+        break;
+    default:
+        memset(data, 0, len);
+        break;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fake bus write (only the watermark registers matter)
+ * @param reg Register address
+ * @param data Source buffer
+ * @param len Number of bytes
+ * @return 0
+ */
+static int fake_write(uint8_t reg, uint8_t *data, uint16_t len) {
+    if(reg == ICM42688_REG_FIFO_CONFIG2 && len == 2) {
+        fifo.watermark = (uint16_t)(data[0] | ((data[1] & 0x0F) << 8));
+    }
+    return 0;
+}
+
+/**
+ * @brief Sensor writes one packet 3
+ * @param t_us Sample time
+ * @return 1 if the watermark interrupt fires
+ */
+static int sensor_push(uint64_t t_us) {
+    uint8_t pkt[ICM42688_FIFO_PACKET3_SIZE] = { 0x68 };
+    uint16_t ts = (uint16_t)t_us;
+
+    pkt[5] = 0x40;  /* accel_z = 1 g at +-2 g */
+    pkt[13] = 25;   /* temp */
+    pkt[14] = (uint8_t)(ts >> 8);
+    pkt[15] = (uint8_t)ts;
+
+    if(fifo.count + sizeof(pkt) > ICM42688_FIFO_SIZE) {
+        fifo.head = (uint16_t)((fifo.head + sizeof(pkt)) % ICM42688_FIFO_SIZE);
+        fifo.count = (uint16_t)(fifo.count - sizeof(pkt));
+        fifo.status |= ICM42688_INT_STATUS_FIFO_FULL;
+        fifo.dropped++;
+    }
+    for(unsigned i = 0; i < sizeof(pkt); i++) {
+        fifo.data[(fifo.head + fifo.count) % ICM42688_FIFO_SIZE] = pkt[i];
+        fifo.count++;
+    }
+
+    if(!fifo.ths && fifo.count >= fifo.watermark) {
+        fifo.ths = 1;
+        fifo.status |= ICM42688_INT_STATUS_FIFO_THS;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Deterministic uniform random value
+ * @param state Generator state
+ * @return Value in [0, 1)
+ */
+static double uniform(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (double)*state / 4294967296.0;
+}
+
+/**
+ * @brief Consumer service delay after an interrupt
+ * @param now Interrupt time
+ * @param max_stall Longest stall in the bursty phase
+ * @param rng Generator state
+ * @return Delay in microseconds
+ */
+static uint32_t service_delay(uint64_t now, uint32_t max_stall, uint32_t *rng) {
+    uint32_t delay = 200 + (uint32_t)(400.0 * uniform(rng));
+    int bursty = (now / PHASE_US) % 2 == 1;
+
+    if(bursty && uniform(rng) < 0.3) delay += (uint32_t)(max_stall * uniform(rng));
+    return delay;
+}
+
+/**
+ * @brief Run one load with a fixed (fixed_packets > 0) or adaptive watermark
+ * @param fixed_packets Fixed watermark in packets, 0 for the controller
+ * @param budget_us Latency budget
+ * @param seconds Simulated time
+ * @param max_stall Longest consumer stall
+ * @param r Output result
+ */
+static void run(uint16_t fixed_packets, uint32_t budget_us, uint32_t seconds, uint32_t max_stall, run_result_t *r) {
+    static uint8_t buf[ICM42688_FIFO_SIZE];
+    static icm42688_sample_t samples[MAX_BATCH];
+    icm42688_t dev = { .bus = { .read = fake_read, .write = fake_write } };
+    icm42688_fifo_wm_t wm;
+    icm42688_fifo_wm_config_t cfg = {
+        .odr_hz = ODR_HZ,
+        .latency_budget_us = budget_us,
+        .packet_size = ICM42688_FIFO_PACKET3_SIZE,
+        .hysteresis = 4,
+    };
+    uint32_t rng = 0x9E3779B9u;
+    uint64_t end = (uint64_t)seconds * 1000000u;
+    uint64_t next_sample = PERIOD_US, irq_time = 0, service_time = 0;
+    uint64_t n_samples = 0, over_budget = 0, sensor_time = 0;
+    uint32_t lost = 0, bad_ts = 0, max_age = 0;
+    uint16_t last_ts = 0, wm_min = 0xFFFF, wm_max = 0;
+    int pending = 0, have_last = 0;
+
+    memset(&fifo, 0, sizeof(fifo));
+    icm42688_fifo_wm_init(&wm, &dev, &cfg);
+    if(fixed_packets) {
+        icm42688_set_fifo_watermark(&dev, (uint16_t)(fixed_packets * cfg.packet_size));
+        wm.watermark = fixed_packets;
+    }
+
+    while(next_sample < end) {
+        if(pending && service_time <= next_sample) {
+            uint64_t now = service_time;
+            uint16_t bytes = 0;
+
+            pending = 0;
+            if(icm42688_fifo_wm_drain(&wm, buf, sizeof(buf), &bytes, NULL) != 0) break;
+            int n = icm42688_parse_fifo_samples(buf, bytes, samples, MAX_BATCH, NULL);
+
+            for(int i = 0; i < n; i++) {
+                uint16_t ts = (uint16_t)samples[i].timestamp_us;
+
+                /* The FIFO was flushed at t = 0, with the sensor counter at 0 too */
+                if(have_last) {
+                    uint16_t step = (uint16_t)(ts - last_ts);
+                    if(step % PERIOD_US) bad_ts++;
+                    else lost += step / PERIOD_US - 1;
+                    sensor_time += step;
+                } else {
+                    sensor_time = ts;
+                }
+                last_ts = ts;
+                have_last = 1;
+
+                uint32_t age = (uint32_t)(now - sensor_time);
+                if(age > max_age) max_age = age;
+                if(age > budget_us) over_budget++;
+                n_samples++;
+            }
+
+            if(!fixed_packets) icm42688_fifo_wm_update(&wm, (uint32_t)(now - irq_time));
+            if(wm.watermark < wm_min) wm_min = wm.watermark;
+            if(wm.watermark > wm_max) wm_max = wm.watermark;
+            continue;
+        }
+
+        if(sensor_push(next_sample)) {
+            icm42688_fifo_wm_on_interrupt(&wm, (uint32_t)next_sample);
+            if(!pending) {
+                pending = 1;
+                irq_time = next_sample;
+                service_time = next_sample + service_delay(next_sample, max_stall, &rng);
+            }
+        }
+        next_sample += PERIOD_US;
+    }
+
+    char label[16];
+    if(fixed_packets) snprintf(label, sizeof(label), "fixed %u", fixed_packets);
+    else snprintf(label, sizeof(label), "adaptive");
+
+    printf("%-10s %8.1f %10u %8u %9u %6u %8.1f %7.2f%% %5u-%-4u%s\n", label,
+           (double)wm.stats.interrupts / seconds, wm.stats.bytes_per_read, wm.stats.reprograms,
+           wm.stats.overflows, lost, max_age / 1000.0,
+           n_samples ? 100.0 * (double)over_budget / (double)n_samples : 0.0, wm_min, wm_max,
+           bad_ts ? "  BAD TIMESTAMPS" : "");
+
+    r->interrupts = wm.stats.interrupts;
+    r->reprograms = wm.stats.reprograms;
+    r->lost = lost + bad_ts;
+    r->over_budget = n_samples ? (double)over_budget / (double)n_samples : 0.0;
+}
+
+int main(int argc, char **argv) {
+    uint32_t budget = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000;
+    uint32_t seconds = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 60;
+    uint32_t max_stall = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 30000;
+
+    if(budget == 0 || seconds == 0) {
+        fprintf(stderr, "usage: %s [latency_budget_us] [seconds] [max_stall_us]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%u Hz packet 3, budget %.1f ms, %u s, stalls up to %.1f ms in bursty phases\n\n",
+           ODR_HZ, budget / 1000.0, seconds, max_stall / 1000.0);
+    printf("%-10s %8s %10s %8s %9s %6s %8s %8s %10s\n", "watermark", "irq/s", "bytes/read",
+           "reprog", "overflows", "lost", "max ms", ">budget", "wm range");
+
+    run_result_t one, hundred, adaptive;
+    run(1, budget, seconds, max_stall, &one);
+    run(100, budget, seconds, max_stall, &hundred);
+    run(0, budget, seconds, max_stall, &adaptive);
+
+    int failed = 0;
+    if(adaptive.lost) {
+        printf("FAIL: adaptive watermark lost samples\n");
+        failed = 1;
+    }
+    if(adaptive.interrupts >= one.interrupts) {
+        printf("FAIL: adaptive watermark interrupts as often as fixed 1\n");
+        failed = 1;
+    }
+    if(adaptive.reprograms * 20u > adaptive.interrupts) {
+        printf("FAIL: adaptive watermark reprograms on more than 5%% of interrupts\n");
+        failed = 1;
+    }
+    if(one.over_budget > 0.0 && adaptive.over_budget > one.over_budget) {
+        printf("FAIL: adaptive watermark misses the budget more often than fixed 1\n");
+        failed = 1;
+    }
+    return failed;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file main.c
+ * @brief Host test: anti-alias and notch filter register values against the datasheet
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   hw_filter_check
+ *
+ * Checks every anti-alias filter row (DELT 1..63): each is selected for its
+ * own bandwidth, bandwidth rises with DELT, DELTSQR is DELT^2 as rounded in
+ * the datasheet table, DELTSQR << BITSHIFT stays normalized to 2^14..2^16,
+ * and the field widths fit. Compares NF_COSWZ/NF_COSWZ_SEL for every integer
+ * notch frequency from 1 to 3 kHz with the datasheet formula evaluated in
+ * double precision. Finally programs a configuration through a fake register
+ * file and checks the bank 1 and bank 2 bit fields and the return to bank 0.
+ * Prints one line per check and exits nonzero if any fails.
+ *
+ * Build: gcc -O2 -std=gnu99 -o hw_filter_check main.c ../../src/hw_filter.c ../../src/icm-42688.c -I../../inc -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../inc/hw_filter.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static uint8_t regs[5][256];
+static uint8_t bank;
+static int failures;
+
+/**
+ * @brief Report one check
+ * @param ok Check result
+ * @param what Description
+ */
+static void check(int ok, const char *what) {
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if(!ok) failures++;
+}
+
+/**
+ * @brief Fake bus read from the selected bank
+ * @param reg Register
+ * @param data Output buffer
+ * @param len Length
+ * @return 0
+ */
+static int fake_read(uint8_t reg, uint8_t *data, uint16_t len) {
+    for(uint16_t i = 0; i < len; i++) data[i] = regs[bank][(uint8_t)(reg + i)];
+    return 0;
+}
+
+/**
+ * @brief Fake bus write to the selected bank; REG_BANK_SEL switches banks
+ * @param reg Register
+ * @param data Data
+ * @param len Length
+ * @return 0
+ */
+static int fake_write(uint8_t reg, uint8_t *data, uint16_t len) {
+    for(uint16_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+        if(r == ICM42688_REG_BANK_SEL) {
+            bank = data[i] & 0x07;
+        } else {
+            regs[bank][r] = data[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief All 63 anti-alias filter rows
+ */
+static void check_aaf(void) {
+    icm42688_aaf_t row[ICM42688_AAF_DELT_MAX + 1];
+    int found = 0, ordered = 1, sqr = 1, norm = 1, widths = 1;
+
+    memset(row, 0, sizeof(row));
+    for(uint16_t bw = 1; bw <= 4000; bw++) {
+        icm42688_aaf_t a;
+        if(icm42688_aaf_compute(bw, &a) != 0 || a.delt == 0 || a.delt > ICM42688_AAF_DELT_MAX) {
+            check(0, "compute accepts every bandwidth up to 4 kHz");
+            return;
+        }
+        if(row[a.delt].delt == 0) found++;
+        row[a.delt] = a;
+    }
+    check(found == ICM42688_AAF_DELT_MAX, "every DELT 1..63 is selected for some bandwidth");
+
+    for(int d = 1; d <= ICM42688_AAF_DELT_MAX; d++) {
+        icm42688_aaf_t a;
+        icm42688_aaf_compute(row[d].bw_hz, &a);
+        if(a.delt != d) ordered = 0;
+        if(d > 1 && row[d].bw_hz <= row[d - 1].bw_hz) ordered = 0;
+
+        /* Datasheet DELTSQR is DELT^2 kept to limited precision */
+        if(fabs((double)row[d].deltsqr - d * d) > 0.01 * d * d) sqr = 0;
+
+        uint32_t scaled = (uint32_t)row[d].deltsqr << row[d].bitshift;
+        if(scaled < (1u << 14) || scaled >= (1u << 16)) norm = 0;
+        if(row[d].deltsqr > 0x0FFF || row[d].bitshift > 0x0F) widths = 0;
+    }
+    check(ordered, "each row is chosen for its own bandwidth, bandwidth rises with DELT");
+    check(sqr, "DELTSQR within 1 % of DELT^2");
+    check(norm, "DELTSQR << BITSHIFT normalized to 2^14..2^16");
+    check(widths, "DELTSQR fits 12 bits, BITSHIFT 4 bits");
+    check(row[1].bw_hz == 42 && row[1].deltsqr == 1 && row[1].bitshift == 15 &&
+          row[13].bw_hz == 585 && row[13].deltsqr == 170 && row[13].bitshift == 8 &&
+          row[24].bw_hz == 1163 && row[24].deltsqr == 576 && row[24].bitshift == 6 &&
+          row[63].bw_hz == 3979 && row[63].deltsqr == 3968 && row[63].bitshift == 3,
+          "datasheet rows 1, 13, 24 and 63");
+}
+
+/**
+ * @brief Notch COSWZ encoding for every integer frequency
+ */
+static void check_notch(void) {
+    int mismatches = 0, fine = 0;
+    uint16_t worst = 0;
+
+    for(uint16_t f = ICM42688_NOTCH_MIN_HZ; f <= ICM42688_NOTCH_MAX_HZ; f++) {
+        const uint16_t freq[3] = { f, f, f };
+        icm42688_notch_t n;
+        if(icm42688_notch_compute(freq, 100, &n) != 0) {
+            mismatches++;
+            continue;
+        }
+
+        /* Datasheet: COSWZ = cos(2*pi*f/32 kHz); |COSWZ| > 0.875 uses 8 * (1 - |COSWZ|) */
+        double c = cos(2.0 * M_PI * f / 32000.0);
+        uint8_t sel = c > 0.875;
+        uint16_t ref = (uint16_t)lround(sel ? 8.0 * (1.0 - c) * 256.0 : c * 256.0);
+        if(n.coswz_sel[0] != sel || n.coswz[0] != ref) {
+            if(!mismatches) worst = f;
+            mismatches++;
+        }
+        fine += sel;
+    }
+    if(mismatches) printf("      first mismatch at %u Hz\n", worst);
+    check(mismatches == 0, "COSWZ and COSWZ_SEL match the datasheet formula at 1..3 kHz");
+    check(fine > 0 && fine < ICM42688_NOTCH_MAX_HZ - ICM42688_NOTCH_MIN_HZ, "both encodings occur in range");
+
+    const uint16_t low[3] = { 999, 2000, 2000 }, high[3] = { 2000, 2000, 3001 };
+    icm42688_notch_t n;
+    check(icm42688_notch_compute(low, 100, &n) != 0 && icm42688_notch_compute(high, 100, &n) != 0,
+          "frequencies outside 1..3 kHz rejected");
+}
+
+/**
+ * @brief Register layout written by icm42688_configure_filters
+ */
+static void check_registers(void) {
+    icm42688_t dev;
+    icm42688_filter_config_t cfg;
+    const uint16_t freq[3] = { 1000, 2000, 3000 };
+
+    memset(&dev, 0, sizeof(dev));
+    dev.bus.read = fake_read;
+    dev.bus.write = fake_write;
+    memset(regs, 0, sizeof(regs));
+    regs[1][0x13] = 0x80;  /* Reserved bit of GYRO_CONFIG_STATIC10 must survive */
+    bank = 0;
+
+    icm42688_filter_config_default(&cfg);
+    cfg.notch_enable = 1;
+    icm42688_notch_compute(freq, 100, &cfg.notch);
+    icm42688_aaf_compute(1000, &cfg.accel_aaf);
+    check(icm42688_configure_filters(&dev, &cfg) == 0 && bank == 0, "configure succeeds and ends in bank 0");
+
+    const uint8_t *g = &regs[1][ICM42688_REG_GYRO_CONFIG_STATIC2];
+    const icm42688_aaf_t *ga = &cfg.gyro_aaf;
+    check((g[0] & 0x03) == 0 && g[1] == ga->delt && g[2] == (ga->deltsqr & 0xFF) &&
+          g[3] == ((ga->bitshift << 4) | (ga->deltsqr >> 8)), "gyro AAF DELT/DELTSQR/BITSHIFT fields");
+
+    int notch_ok = 1;
+    for(int axis = 0; axis < 3; axis++) {
+        uint16_t coswz = (uint16_t)(g[4 + axis] | (((g[7] >> axis) & 1) << 8));
+        if(coswz != cfg.notch.coswz[axis] || ((g[7] >> (3 + axis)) & 1) != cfg.notch.coswz_sel[axis]) notch_ok = 0;
+    }
+    check(notch_ok, "NF_COSWZ low bytes, bit 8 and COSWZ_SEL per axis");
+    check(((g[8] >> 4) & 0x07) == cfg.notch.bw_sel && (g[8] & 0x80), "NF_BW_SEL set, reserved bit kept");
+
+    const uint8_t *a = &regs[2][ICM42688_REG_ACCEL_CONFIG_STATIC2];
+    const icm42688_aaf_t *aa = &cfg.accel_aaf;
+    check(a[0] == (aa->delt << 1) && a[1] == (aa->deltsqr & 0xFF) && a[2] == ((aa->bitshift << 4) | (aa->deltsqr >> 8)),
+          "accel AAF DELT/DELTSQR/BITSHIFT fields");
+}
+
+int main(void) {
+    check_aaf();
+    check_notch();
+    check_registers();
+
+    printf("\n%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
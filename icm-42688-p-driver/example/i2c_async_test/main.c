@@ -0,0 +1,462 @@
+/**
+ * @file main.c
+ * @brief Host test: non-blocking I2C queue against a fake controller and sensor FIFO
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   i2c_async_test
+ *
+ * Builds the queue core with a fake interrupt mask and drives it with a fake
+ * I2C controller: the start hook only records the transfer, and the test
+ * plays the completion interrupt, executing the transfer against a fake
+ * ICM-42688 (FIFO_COUNTH/L and a byte FIFO behind FIFO_DATA). Checks
+ * round-robin order, that a burst FIFO read pops exactly the whole packets
+ * reported by the count with no other client in between, start failures,
+ * cancelling queued and active transactions, that every completion callback
+ * runs with interrupts enabled, and, under a saturated load of all clients,
+ * that no transaction waits for more than (clients - 1) other transfers once
+ * it is at the head of its client queue. Prints
+ * one line per check and exits nonzero if any fails.
+ *
+ * Build: gcc -O2 -std=gnu99 -o i2c_async_test main.c -I../../inc
+ */
+
+#include <stdint.h>
+
+static volatile uint32_t irq_masked;
+
+/**
+ * @brief Fake interrupt mask: disable
+ * @return Previous state
+ */
+static uint32_t test_irq_save(void) {
+    uint32_t prev = irq_masked;
+    irq_masked = 1;
+    return prev;
+}
+
+/**
+ * @brief Fake interrupt mask: restore
+ * @param prev State returned by test_irq_save
+ */
+static void test_irq_restore(uint32_t prev) {
+    irq_masked = prev;
+}
+
+#define I2C_ASYNC_IRQ_SAVE()         test_irq_save()
+#define I2C_ASYNC_IRQ_RESTORE(state) test_irq_restore(state)
+#include "../../src/i2c_async.c"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PKT      ICM42688_FIFO_PACKET3_SIZE
+#define LOG_MAX  64
+
+/**
+ * @brief One transfer seen by the fake controller
+ */
+typedef struct {
+    uint8_t client;
+    uint8_t reg;
+    uint16_t len;
+} xfer_t;
+
+static i2c_async_bus_t bus;
+static const i2c_async_txn_t *inflight;
+static xfer_t xlog[LOG_MAX];
+static int xlog_n;
+static int fail_next_start;
+static uint8_t fifo[ICM42688_FIFO_SIZE];
+static uint16_t fifo_count, fifo_head;
+static uint8_t next_byte;
+static int failures, masked_callbacks, aborts;
+static void (*on_start)(const i2c_async_txn_t *txn);
+static uint32_t done_total, done_by[I2C_ASYNC_MAX_CLIENTS];
+
+/**
+ * @brief Report one check
+ * @param ok Check result
+ * @param what Description
+ */
+static void check(int ok, const char *what) {
+    printf("%s  %s\n", ok ? "pass" : "FAIL", what);
+    if(!ok) failures++;
+}
+
+/**
+ * @brief Fake controller start hook: record the transfer
+ * @param ctx Unused
+ * @param txn Transaction
+ * @return 0, or -2 once when a start failure is armed
+ */
+static int fake_start(void *ctx, const i2c_async_txn_t *txn) {
+    (void)ctx;
+    if(fail_next_start) {
+        fail_next_start = 0;
+        return -2;
+    }
+    if(xlog_n < LOG_MAX) xlog[xlog_n++] = (xfer_t){ txn->client, txn->reg, txn->len };
+    inflight = txn;
+    if(on_start) on_start(txn);
+    return 0;
+}
+
+/**
+ * @brief Fill the fake sensor FIFO with whole and partial packets
+ * @param bytes Number of bytes
+ */
+static void fifo_fill(uint16_t bytes) {
+    fifo_head = 0;
+    fifo_count = bytes;
+    for(uint16_t i = 0; i < bytes; i++) fifo[i] = next_byte++;
+}
+
+/**
+ * @brief Play the completion interrupt of the transfer in flight
+ * @param status Status to report
+ * @return 1 if a transfer completed, 0 if the bus was idle
+ */
+static int fake_irq(int status) {
+    const i2c_async_txn_t *t = inflight;
+    if(!t) return 0;
+    inflight = NULL;
+    done_total++;
+    done_by[t->client]++;
+
+    if(status == 0 && !t->write) {
+        if(t->reg == ICM42688_REG_FIFO_COUNTH) {
+            t->data[0] = (uint8_t)(fifo_count >> 8);
+            if(t->len > 1) t->data[1] = (uint8_t)fifo_count;
+        } else if(t->reg == ICM42688_REG_FIFO_DATA) {
+            for(uint16_t i = 0; i < t->len; i++) {
+                t->data[i] = fifo_count ? fifo[fifo_head++] : 0xFF;
+                if(fifo_count) fifo_count--;
+            }
+        } else {
+            memset(t->data, t->reg, t->len);
+        }
+    }
+    i2c_async_complete(&bus, status);
+    return 1;
+}
+
+/**
+ * @brief Run completion interrupts until the bus is idle
+ */
+static void run_bus(void) {
+    while(fake_irq(0)) {
+    }
+}
+
+/**
+ * @brief Completion callback: record status and the interrupt mask
+ * @param txn Finished transaction
+ * @param status Status
+ */
+static void on_done(i2c_async_txn_t *txn, int status) {
+    int *result = (int *)txn->user;
+    if(irq_masked) masked_callbacks++;
+    if(result) *result = status == 0 ? 1 : status;
+}
+
+/**
+ * @brief Prepare a plain register read
+ * @param txn Transaction
+ * @param client Client index
+ * @param reg Register
+ * @param buf Buffer
+ * @param len Length
+ * @param result Completion result (1 on success, negative status on error)
+ */
+static void plain(i2c_async_txn_t *txn, uint8_t client, uint8_t reg, uint8_t *buf, uint16_t len, int *result) {
+    memset(txn, 0, sizeof(*txn));
+    txn->device_addr = 0x68 << 1;
+    txn->reg = reg;
+    txn->client = client;
+    txn->data = buf;
+    txn->len = len;
+    txn->done = on_done;
+    txn->user = result;
+    *result = 0;
+}
+
+/**
+ * @brief Round-robin order across clients
+ */
+static void test_round_robin(void) {
+    static i2c_async_txn_t txn[8];
+    static uint8_t buf[8][2];
+    static const uint8_t client[8] = { 0, 0, 0, 0, 0, 1, 1, 2 };
+    static const uint8_t expect[8] = { 0, 1, 2, 0, 1, 0, 0, 0 };
+    int result[8];
+    int ok = 1;
+
+    i2c_async_init(&bus, fake_start, NULL);
+    xlog_n = 0;
+    for(int i = 0; i < 8; i++) {
+        plain(&txn[i], client[i], (uint8_t)(0x10 + i), buf[i], 2, &result[i]);
+        i2c_async_submit(&bus, &txn[i]);
+    }
+    run_bus();
+
+    for(int i = 0; i < 8; i++) {
+        if(xlog[i].client != expect[i] || result[i] != 1) ok = 0;
+    }
+    check(ok && xlog_n == 8, "round-robin across clients, FIFO within a client");
+    check(bus.stats.completed == 8 && i2c_async_idle(&bus), "all transactions completed, bus idle");
+}
+
+/**
+ * @brief Burst FIFO reads pop whole packets only
+ */
+static void test_fifo_burst(void) {
+    static i2c_async_txn_t burst, other, blocker;
+    static uint8_t buf[2 + 20 * PKT];
+    static uint8_t small[2 + 3 * PKT + 5];
+    static uint8_t obuf[4], bbuf[1];
+    int r_burst, r_other, r_block;
+
+    i2c_async_init(&bus, fake_start, NULL);
+
+    /* 5 whole packets and 3 bytes of the next */
+    fifo_fill(5 * PKT + 3);
+    uint8_t first = fifo[0];
+    xlog_n = 0;
+    i2c_async_fifo_burst(&burst, 0x68 << 1, 0, PKT, buf, sizeof(buf), on_done, &r_burst);
+    i2c_async_submit(&bus, &burst);
+    run_bus();
+    check(r_burst == 1 && burst.len == 2 + 5 * PKT, "burst reads exactly the whole packets");
+    check(xlog_n == 2 && xlog[0].reg == ICM42688_REG_FIFO_COUNTH && xlog[0].len == 2 &&
+          xlog[1].reg == ICM42688_REG_FIFO_DATA && xlog[1].len == 5 * PKT, "count transfer, then data transfer");
+    check(fifo_count == 3, "partial packet stays in the sensor FIFO");
+    check(burst.data == buf && buf[0] == 0 && buf[1] == 5 * PKT + 3 && buf[2] == first,
+          "count in buf[0..1], packets from buf[2]");
+
+    /* More data than buffer: whole packets that fit */
+    fifo_fill(200);
+    i2c_async_fifo_burst(&burst, 0x68 << 1, 0, PKT, small, sizeof(small), on_done, &r_burst);
+    i2c_async_submit(&bus, &burst);
+    run_bus();
+    check(r_burst == 1 && burst.len == 2 + 3 * PKT && fifo_count == 200 - 3 * PKT,
+          "burst limited to whole packets that fit the buffer");
+
+    /* Empty FIFO: count only */
+    fifo_fill(PKT - 1);
+    xlog_n = 0;
+    i2c_async_submit(&bus, &burst);
+    run_bus();
+    check(r_burst == 1 && burst.len == 2 && xlog_n == 1 && fifo_count == PKT - 1,
+          "no whole packet: count transfer only, nothing popped");
+
+    /* Another client's transaction queued behind the burst must not cut in */
+    fifo_fill(4 * PKT);
+    xlog_n = 0;
+    plain(&blocker, 2, 0x75, bbuf, 1, &r_block);
+    i2c_async_submit(&bus, &blocker);
+    i2c_async_fifo_burst(&burst, 0x68 << 1, 0, PKT, buf, sizeof(buf), on_done, &r_burst);
+    i2c_async_submit(&bus, &burst);
+    plain(&other, 1, 0x1F, obuf, 4, &r_other);
+    i2c_async_submit(&bus, &other);
+    run_bus();
+    check(xlog_n == 4 && xlog[1].reg == ICM42688_REG_FIFO_COUNTH && xlog[2].reg == ICM42688_REG_FIFO_DATA &&
+          xlog[3].client == 1, "no other client between count and data");
+    check(r_block == 1 && r_burst == 1 && r_other == 1, "all three completed");
+
+    /* Bus error during the data stage */
+    fifo_fill(2 * PKT);
+    i2c_async_submit(&bus, &burst);
+    fake_irq(0);
+    fake_irq(-2);
+    check(r_burst == -2 && burst.len == 0 && burst.data == buf, "data stage error reported, buffer rewound");
+}
+
+/**
+ * @brief Start failures and callbacks
+ */
+static void test_failures(void) {
+    static i2c_async_txn_t a, b;
+    static uint8_t abuf[2], bbuf[2];
+    int ra, rb;
+
+    i2c_async_init(&bus, fake_start, NULL);
+    fail_next_start = 1;
+    plain(&a, 0, 0x20, abuf, 2, &ra);
+    i2c_async_submit(&bus, &a);
+    check(ra == -2 && bus.stats.errors == 1 && i2c_async_idle(&bus), "start failure reported from submit");
+
+    /* Active transfer, then a queued one whose start fails when dispatched */
+    plain(&a, 0, 0x20, abuf, 2, &ra);
+    plain(&b, 1, 0x21, bbuf, 2, &rb);
+    i2c_async_submit(&bus, &a);
+    i2c_async_submit(&bus, &b);
+    fail_next_start = 1;
+    fake_irq(0);
+    check(ra == 1 && rb == -2 && i2c_async_idle(&bus), "start failure of the next transfer reported after completion");
+
+    check(masked_callbacks == 0, "every callback ran with interrupts enabled");
+    check(irq_masked == 0, "interrupt mask restored");
+}
+
+/**
+ * @brief Fake abort hook: drop the transfer in flight
+ * @param ctx Unused
+ * @param txn Transaction being cancelled
+ */
+static void fake_abort(void *ctx, const i2c_async_txn_t *txn) {
+    (void)ctx;
+    if(inflight == txn) inflight = NULL;
+    aborts++;
+}
+
+/**
+ * @brief Cancelling queued and active transactions (blocking-call timeout path)
+ */
+static void test_cancel(void) {
+    static i2c_async_txn_t a, b, c, burst;
+    static uint8_t abuf[2], bbuf[2], cbuf[2];
+    static uint8_t buf[2 + 4 * PKT];
+    int ra, rb, rc, r_burst;
+
+    /* a on the bus, b and c queued for the same client */
+    i2c_async_init(&bus, fake_start, NULL);
+    aborts = 0;
+    plain(&a, 0, 0x20, abuf, 2, &ra);
+    plain(&b, 1, 0x21, bbuf, 2, &rb);
+    plain(&c, 1, 0x22, cbuf, 2, &rc);
+    i2c_async_submit(&bus, &a);
+    i2c_async_submit(&bus, &b);
+    i2c_async_submit(&bus, &c);
+    check(i2c_async_cancel(&bus, &b, fake_abort) == 0 && aborts == 0 && bus.pending == 1 && bus.head[1] == &c,
+          "queued transaction unlinked without aborting the bus");
+
+    xlog_n = 0;
+    check(i2c_async_cancel(&bus, &a, fake_abort) == 0 && aborts == 1 && bus.active == &c && xlog_n == 1 &&
+          xlog[0].reg == 0x22, "active transaction aborted, next one started");
+    run_bus();
+    check(ra == 0 && rb == 0 && rc == 1 && i2c_async_idle(&bus) && bus.tail[1] == NULL,
+          "cancelled callbacks not called, queue consistent");
+    check(i2c_async_cancel(&bus, &c, fake_abort) == -3 && aborts == 1, "finished transaction cannot be cancelled");
+
+    /* Burst cancelled during its data stage */
+    fifo_fill(2 * PKT);
+    i2c_async_fifo_burst(&burst, 0x68 << 1, 0, PKT, buf, sizeof(buf), on_done, &r_burst);
+    i2c_async_submit(&bus, &burst);
+    r_burst = 0;
+    fake_irq(0);
+    check(i2c_async_cancel(&bus, &burst, fake_abort) == 0 && r_burst == 0 && burst.len == 0 && burst.data == buf &&
+          i2c_async_idle(&bus), "burst cancelled in the data stage, buffer rewound");
+}
+
+#define LOAD_TXNS   4000u
+#define NO_MARK     0xFFFFFFFFu
+
+/**
+ * @brief Transaction of the saturated load test
+ */
+typedef struct {
+    i2c_async_txn_t txn;
+    uint8_t buf[2];
+    uint32_t mark;     /**< Other clients' completions when it reached the head of its queue */
+} load_txn_t;
+
+static load_txn_t load[I2C_ASYNC_MAX_CLIENTS][I2C_ASYNC_MAX_CLIENTS];
+static uint32_t load_submitted, load_max_wait;
+
+/**
+ * @brief Transfers of other clients completed so far
+ * @param client Client index
+ * @return Completion count
+ */
+static uint32_t others_done(uint8_t client) {
+    return done_total - done_by[client];
+}
+
+/**
+ * @brief Start hook of the load test: measure the wait, then mark the new queue head
+ * @param txn Transaction being started
+ */
+static void load_started(const i2c_async_txn_t *txn) {
+    load_txn_t *lt = (load_txn_t *)txn->user;
+    uint32_t wait = others_done(txn->client) - lt->mark;
+    if(wait > load_max_wait) load_max_wait = wait;
+
+    i2c_async_txn_t *head = bus.head[txn->client];
+    if(head) ((load_txn_t *)head->user)->mark = others_done(txn->client);
+}
+
+/**
+ * @brief Queue a load transaction
+ * @param lt Transaction
+ */
+static void load_submit(load_txn_t *lt) {
+    /* Waiting starts now if nothing of its own client is queued ahead of it */
+    lt->mark = bus.head[lt->txn.client] ? NO_MARK : others_done(lt->txn.client);
+    load_submitted++;
+    i2c_async_submit(&bus, &lt->txn);
+}
+
+/**
+ * @brief Completion callback of the load test: resubmit until the run is over
+ * @param txn Finished transaction
+ * @param status Status
+ */
+static void load_done(i2c_async_txn_t *txn, int status) {
+    (void)status;
+    if(load_submitted < LOAD_TXNS) load_submit((load_txn_t *)txn->user);
+}
+
+/**
+ * @brief Latency bound under a saturated multi-client load
+ *
+ * Client c keeps c + 1 transactions outstanding and resubmits each one from
+ * its callback, so every client always has work queued. For every
+ * transaction, counts the transfers of other clients that completed between
+ * it reaching the head of its client queue and being started.
+ */
+static void test_latency_bound(void) {
+    int dummy;
+
+    i2c_async_init(&bus, fake_start, NULL);
+    done_total = 0;
+    memset(done_by, 0, sizeof(done_by));
+    load_submitted = 0;
+    load_max_wait = 0;
+    on_start = load_started;
+
+    for(uint8_t c = 0; c < I2C_ASYNC_MAX_CLIENTS; c++) {
+        for(uint8_t i = 0; i <= c; i++) {
+            load_txn_t *lt = &load[c][i];
+            plain(&lt->txn, c, (uint8_t)(0x10 + c), lt->buf, 2, &dummy);
+            lt->txn.done = load_done;
+            lt->txn.user = lt;
+            load_submit(lt);
+        }
+    }
+    run_bus();
+    on_start = NULL;
+
+    int fair = 1;
+    for(uint8_t c = 0; c < I2C_ASYNC_MAX_CLIENTS; c++) {
+        /* Saturated round-robin: every client gets an equal share, up to the ramp-down */
+        if(done_by[c] + I2C_ASYNC_MAX_CLIENTS < done_total / I2C_ASYNC_MAX_CLIENTS) fair = 0;
+    }
+    check(done_total == LOAD_TXNS && bus.stats.completed == LOAD_TXNS && i2c_async_idle(&bus),
+          "saturated load: every transaction completed");
+    check(fair, "saturated load: clients share the bus equally");
+    check(load_max_wait <= I2C_ASYNC_MAX_CLIENTS - 1,
+          "queued transaction waits for at most clients - 1 other transfers");
+    check(load_max_wait == I2C_ASYNC_MAX_CLIENTS - 1, "bound reached under saturation (measurement is live)");
+}
+
+int main(void) {
+    test_round_robin();
+    test_fifo_burst();
+    test_failures();
+    test_cancel();
+    test_latency_bound();
+
+    printf("\n%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file main.c
+ * @brief Host test: latest-sample slot under one writer and several reader threads
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   latest_stress [readers] [seconds]
+ *
+ * One writer thread publishes as fast as it can. Every sample is derived from
+ * the publish count: timestamp_us is the count, the six axes are functions of
+ * it and temp holds a checksum over the other fields. `readers` threads
+ * (default 3) read the slot for `seconds` (default 2) and check that every
+ * copy is whole (checksum and axes match its timestamp), that the returned
+ * sequence equals the publish count and that it never goes backwards. Prints
+ * per-reader reads, how often a read returned the same sample as the one
+ * before, and the read latency (median, 99th percentile, maximum; the
+ * maximum includes time the reader was descheduled). Fails on any torn or
+ * out-of-order copy.
+ *
+ * Build: gcc -O2 -std=gnu99 -o latest_stress main.c ../../src/latest_sample.c -I../../inc -lpthread
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../inc/latest_sample.h"
+
+#define MAX_READERS  16
+#define LAT_SAMPLES  (1u << 20)  /* Latencies kept per reader for percentiles */
+
+/**
+ * @brief Per-reader results
+ */
+typedef struct {
+    pthread_t thread;      /**< Reader thread */
+    uint64_t reads;        /**< Successful reads */
+    uint64_t torn;         /**< Copies whose fields do not belong together */
+    uint64_t backwards;    /**< Sequence lower than the previous read */
+    uint64_t stale;        /**< Reads that returned the same sample as the previous one */
+    uint32_t *lat_ns;      /**< Latency samples */
+    uint32_t lat_count;    /**< Valid latency samples */
+} reader_t;
+
+static icm42688_latest_t slot;
+static volatile int stop;
+static uint64_t published;
+
+/**
+ * @brief Monotonic time
+ * @return Nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Checksum over the axes and timestamp of a sample
+ * @param d Sample data
+ * @param ts Timestamp
+ * @return 16-bit checksum stored in temp
+ */
+static int16_t checksum(const icm42688_data_t *d, uint32_t ts) {
+    uint32_t h = ts * 2654435761u;
+    h ^= (uint16_t)d->accel_x;
+    h = h * 31 + (uint16_t)d->accel_y;
+    h = h * 31 + (uint16_t)d->accel_z;
+    h = h * 31 + (uint16_t)d->gyro_x;
+    h = h * 31 + (uint16_t)d->gyro_y;
+    h = h * 31 + (uint16_t)d->gyro_z;
+    return (int16_t)(h ^ (h >> 16));
+}
+
+/**
+ * @brief Sample for publish count n
+ * @param n Publish count
+ * @param d Output sample data
+ */
+static void make_sample(uint32_t n, icm42688_data_t *d) {
+    d->accel_x = (int16_t)n;
+    d->accel_y = (int16_t)(n >> 16);
+    d->accel_z = (int16_t)~n;
+    d->gyro_x = (int16_t)(n * 3);
+    d->gyro_y = (int16_t)(n * 5);
+    d->gyro_z = (int16_t)(n * 7);
+    d->temp = checksum(d, n);
+}
+
+/**
+ * @brief Writer thread: publish continuously
+ * @param arg Unused
+ * @return NULL
+ */
+static void *writer(void *arg) {
+    (void)arg;
+    uint32_t n = 0;
+
+    while(!stop) {
+        icm42688_data_t d;
+        make_sample(++n, &d);
+        icm42688_latest_publish(&slot, &d, n);
+    }
+    __atomic_store_n(&published, n, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+/**
+ * @brief Reader thread: read, time and verify
+ * @param arg reader_t
+ * @return NULL
+ */
+static void *reader(void *arg) {
+    reader_t *r = (reader_t *)arg;
+    uint32_t last = 0;
+
+    while(!stop) {
+        icm42688_sample_t s;
+        icm42688_data_t expect;
+        uint32_t seq;
+
+        uint64_t t0 = now_ns();
+        if(icm42688_latest_read(&slot, &s, &seq) != 0) continue;
+        uint64_t t1 = now_ns();
+
+        r->reads++;
+        if(r->lat_count < LAT_SAMPLES) r->lat_ns[r->lat_count++] = (uint32_t)(t1 - t0);
+
+        make_sample(s.timestamp_us, &expect);
+        if(s.data.temp != checksum(&s.data, s.timestamp_us) || s.data.accel_x != expect.accel_x ||
+           s.data.accel_y != expect.accel_y || s.data.accel_z != expect.accel_z || s.data.gyro_x != expect.gyro_x ||
+           s.data.gyro_y != expect.gyro_y || s.data.gyro_z != expect.gyro_z || seq != s.timestamp_us) {
+            r->torn++;
+        }
+        if(seq < last) r->backwards++;
+        if(seq == last) r->stale++;
+        last = seq;
+    }
+    return NULL;
+}
+
+/**
+ * @brief qsort comparator for latencies
+ * @param a First value
+ * @param b Second value
+ * @return Ordering
+ */
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    static reader_t readers[MAX_READERS];
+    int count = argc > 1 ? atoi(argv[1]) : 3;
+    double seconds = argc > 2 ? strtod(argv[2], NULL) : 2.0;
+    pthread_t w;
+    int failed = 0;
+
+    if(count < 1 || count > MAX_READERS || seconds <= 0.0) {
+        fprintf(stderr, "usage: %s [readers 1..%d] [seconds]\n", argv[0], MAX_READERS);
+        return 1;
+    }
+
+    icm42688_latest_init(&slot);
+    for(int i = 0; i < count; i++) {
+        readers[i].lat_ns = malloc(LAT_SAMPLES * sizeof(uint32_t));
+        if(!readers[i].lat_ns) return 1;
+    }
+    if(pthread_create(&w, NULL, writer, NULL) != 0) return 1;
+    for(int i = 0; i < count; i++) {
+        if(pthread_create(&readers[i].thread, NULL, reader, &readers[i]) != 0) return 1;
+    }
+
+    struct timespec ts = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+    nanosleep(&ts, NULL);
+    stop = 1;
+    pthread_join(w, NULL);
+    for(int i = 0; i < count; i++) pthread_join(readers[i].thread, NULL);
+
+    printf("1 writer, %d reader(s), %.1f s, %llu publishes (%.1f M/s), sample %zu bytes\n\n", count, seconds,
+           (unsigned long long)published, published / seconds * 1e-6, sizeof(icm42688_sample_t));
+    printf("%-7s %12s %10s %10s %10s %10s %10s %10s\n", "reader", "reads", "torn", "backwards", "stale %",
+           "p50 ns", "p99 ns", "max ns");
+    for(int i = 0; i < count; i++) {
+        reader_t *r = &readers[i];
+        uint32_t p50 = 0, p99 = 0, max = 0;
+
+        if(r->lat_count) {
+            qsort(r->lat_ns, r->lat_count, sizeof(uint32_t), cmp_u32);
+            p50 = r->lat_ns[r->lat_count / 2];
+            p99 = r->lat_ns[(uint32_t)((uint64_t)r->lat_count * 99 / 100)];
+            max = r->lat_ns[r->lat_count - 1];
+        }
+        int bad = r->torn || r->backwards;
+        printf("%-7d %12llu %10llu %10llu %10.1f %10u %10u %10u%s\n", i, (unsigned long long)r->reads,
+               (unsigned long long)r->torn, (unsigned long long)r->backwards,
+               r->reads ? 100.0 * r->stale / r->reads : 0.0, p50, p99, max, bad ? "  FAIL" : "");
+        if(bad || r->reads == 0) failed = 1;
+        free(r->lat_ns);
+    }
+    return failed;
+}
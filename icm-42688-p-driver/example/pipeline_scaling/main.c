@@ -0,0 +1,197 @@
+/**
+ * @file main.c
+ * @brief Host tool: host pipeline throughput versus worker count
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   pipeline_scaling [streams] [batches_per_stream] [work] [max_workers]
+ *
+ * Registers `streams` streams (default 64) with a two-stage chain
+ * (calibration, then `work` passes of a 6-axis biquad, default 8) and
+ * pushes `batches_per_stream` full batches (default 200) through the
+ * pipeline for 1, 2, 4, ... up to max_workers workers (default: online
+ * CPUs). Prints throughput, speedup over one worker, parallel efficiency
+ * and steals. Every stage checks that batches of its stream arrive in
+ * submission order; the tool fails on any reordering or stage error.
+ *
+ * Build: gcc -O2 -std=gnu11 -pthread -o pipeline_scaling main.c ../../src/host_pipeline.c -I../../inc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../inc/host_pipeline.h"
+
+/**
+ * @brief Per-stream stage state
+ */
+typedef struct {
+    uint16_t next_seq;   /**< Expected sequence of the next sample */
+    uint32_t reordered;  /**< Samples that arrived out of order */
+    float state[6][2];   /**< Biquad delay line per axis */
+    float out;           /**< Sink so the filter is not optimized away */
+} stream_ctx_t;
+
+static stream_ctx_t ctx[ICM42688_PIPELINE_MAX_STREAMS];
+static icm42688_stream_t streams[ICM42688_PIPELINE_MAX_STREAMS];
+static icm42688_pipeline_t pipeline;
+static unsigned work_passes = 8;
+
+/**
+ * @brief Monotonic time
+ * @return Seconds
+ */
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Stage 1: order check and offset calibration
+ * @param arg Stream context
+ * @param stream_id Stream identifier
+ * @param samples Batch samples
+ * @param count Number of samples
+ * @return 0 on success, -1 once the stream was reordered
+ */
+static int stage_calibrate(void *arg, uint32_t stream_id, icm42688_data_t *samples, uint16_t count) {
+    stream_ctx_t *c = (stream_ctx_t *)arg;
+    (void)stream_id;
+
+    for(uint16_t i = 0; i < count; i++) {
+        /* Sequence number rides in temp */
+        if((uint16_t)samples[i].temp != c->next_seq) c->reordered++;
+        c->next_seq = (uint16_t)(samples[i].temp + 1);
+
+        samples[i].gyro_x = (int16_t)(samples[i].gyro_x - 12);
+        samples[i].gyro_y = (int16_t)(samples[i].gyro_y + 7);
+        samples[i].gyro_z = (int16_t)(samples[i].gyro_z - 3);
+    }
+    return c->reordered ? -1 : 0;
+}
+
+/**
+ * @brief Stage 2: low-pass each axis, work_passes times
+ * @param arg Stream context
+ * @param stream_id Stream identifier
+ * @param samples Batch samples
+ * @param count Number of samples
+ * @return 0
+ */
+static int stage_filter(void *arg, uint32_t stream_id, icm42688_data_t *samples, uint16_t count) {
+    stream_ctx_t *c = (stream_ctx_t *)arg;
+    const float b0 = 0.0675f, b1 = 0.135f, b2 = 0.0675f, a1 = -1.143f, a2 = 0.4128f;
+    (void)stream_id;
+
+    for(uint16_t i = 0; i < count; i++) {
+        int16_t in[6] = { samples[i].accel_x, samples[i].accel_y, samples[i].accel_z,
+                          samples[i].gyro_x, samples[i].gyro_y, samples[i].gyro_z };
+        for(int a = 0; a < 6; a++) {
+            float x = (float)in[a];
+            for(unsigned k = 0; k < work_passes; k++) {
+                /* Transposed direct form II */
+                float y = b0 * x + c->state[a][0];
+                c->state[a][0] = b1 * x - a1 * y + c->state[a][1];
+                c->state[a][1] = b2 * x - a2 * y;
+                x = y;
+            }
+            c->out += x;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Push every batch through a pipeline with the given worker count
+ * @param workers Worker threads
+ * @param n_streams Streams
+ * @param batches Batches per stream
+ * @param steals Output: total steals
+ * @param failures Output: reordered samples plus stage errors
+ * @return Elapsed seconds, negative on error
+ */
+static double run(uint16_t workers, uint16_t n_streams, uint32_t batches, uint64_t *steals, uint64_t *failures) {
+    static icm42688_data_t batch[ICM42688_PIPELINE_BATCH_SIZE];
+
+    memset(ctx, 0, sizeof(ctx));
+    if(icm42688_pipeline_init(&pipeline, workers) != 0) return -1.0;
+
+    for(uint16_t s = 0; s < n_streams; s++) {
+        icm42688_stage_t stages[2] = { { stage_calibrate, &ctx[s] }, { stage_filter, &ctx[s] } };
+        if(icm42688_pipeline_add_stream(&pipeline, &streams[s], s, stages, 2) != 0) return -1.0;
+    }
+
+    double start = now_s();
+    for(uint32_t b = 0; b < batches; b++) {
+        for(uint16_t s = 0; s < n_streams; s++) {
+            for(int i = 0; i < ICM42688_PIPELINE_BATCH_SIZE; i++) {
+                uint32_t seq = b * ICM42688_PIPELINE_BATCH_SIZE + (uint32_t)i;
+                batch[i].accel_x = (int16_t)(seq * 7);
+                batch[i].accel_y = (int16_t)(s * 13);
+                batch[i].accel_z = 16384;
+                batch[i].gyro_x = (int16_t)(seq & 0xFF);
+                batch[i].gyro_y = 0;
+                batch[i].gyro_z = 0;
+                batch[i].temp = (int16_t)(uint16_t)seq;
+            }
+            icm42688_pipeline_submit(&pipeline, &streams[s], batch, ICM42688_PIPELINE_BATCH_SIZE, 1);
+        }
+    }
+    icm42688_pipeline_drain(&pipeline);
+    double elapsed = now_s() - start;
+
+    *steals = 0;
+    *failures = 0;
+    for(uint16_t w = 0; w < workers; w++) *steals += pipeline.workers[w].steals;
+    for(uint16_t s = 0; s < n_streams; s++) {
+        *failures += ctx[s].reordered + streams[s].errors;
+        if(streams[s].batches != batches) (*failures)++;
+    }
+
+    icm42688_pipeline_shutdown(&pipeline);
+    return elapsed;
+}
+
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned n_streams = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 64;
+    uint32_t batches = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 200;
+    unsigned max_workers = argc > 4 ? (unsigned)strtoul(argv[4], NULL, 10) : (unsigned)(cpus > 0 ? cpus : 1);
+    int failed = 0;
+    double base = 0.0;
+
+    if(argc > 3) work_passes = (unsigned)strtoul(argv[3], NULL, 10);
+    if(n_streams == 0 || n_streams > ICM42688_PIPELINE_MAX_STREAMS || batches == 0 ||
+       max_workers == 0 || max_workers > ICM42688_PIPELINE_MAX_WORKERS) {
+        fprintf(stderr, "usage: %s [streams<=%d] [batches_per_stream] [work] [max_workers<=%d]\n",
+                argv[0], ICM42688_PIPELINE_MAX_STREAMS, ICM42688_PIPELINE_MAX_WORKERS);
+        return 1;
+    }
+
+    printf("%u streams x %u batches x %d samples, %u filter passes, %ld online CPUs\n\n",
+           n_streams, batches, ICM42688_PIPELINE_BATCH_SIZE, work_passes, cpus);
+    printf("%7s %12s %10s %8s %10s %8s\n", "workers", "Msamples/s", "time [s]", "speedup", "efficiency", "steals");
+
+    for(unsigned w = 1; ; w *= 2) {
+        if(w > max_workers) w = max_workers;
+
+        uint64_t steals, failures;
+        double t = run((uint16_t)w, (uint16_t)n_streams, batches, &steals, &failures);
+        if(t <= 0.0) {
+            fprintf(stderr, "pipeline setup failed with %u workers\n", w);
+            return 1;
+        }
+        if(w == 1) base = t;
+
+        double samples = (double)n_streams * batches * ICM42688_PIPELINE_BATCH_SIZE;
+        printf("%7u %12.2f %10.3f %7.2fx %9.0f%% %8llu%s\n", w, samples / t / 1e6, t, base / t,
+               100.0 * base / t / w, (unsigned long long)steals, failures ? "  ORDER/STAGE ERRORS" : "");
+        if(failures) failed = 1;
+        if(w == max_workers) break;
+    }
+    return failed;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file main.c
+ * @brief Host tool: bus bytes and transactions of the multi-rate read scheduler against read_all
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   sched_sim [ticks]
+ *
+ * Runs `ticks` (default 10000) scheduler ticks for a few channel rate sets
+ * and three transaction overheads (SPI ~2, I2C ~4 byte times, and 0 for a bus
+ * where transactions are free) against a fake register file whose data
+ * registers change every tick. Prints the data bytes read and the bus cost
+ * (bytes plus overhead per transaction) as a percentage of icm42688_read_all
+ * (14 bytes in one transaction every tick), and transactions per tick.
+ * Fails if a due channel is not reported fresh, or a field reported fresh
+ * does not hold the register value of the current tick.
+ *
+ * Build: gcc -O2 -std=gnu99 -o sched_sim main.c ../../src/read_sched.c -I../../inc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../inc/read_sched.h"
+
+#define DATA_BYTES 14
+
+/**
+ * @brief Channel rate set
+ */
+typedef struct {
+    const char *name;    /**< Description */
+    uint16_t div[3];     /**< temp, accel, gyro divisors */
+} rates_t;
+
+static const rates_t rates[] = {
+    { "gyro",                   { 0, 0, 1 } },
+    { "gyro, accel/2, temp/1000", { 1000, 2, 1 } },
+    { "accel, temp/100",        { 100, 1, 0 } },
+    { "gyro, temp/10",          { 10, 0, 1 } },
+    { "everything",             { 1, 1, 1 } },
+};
+
+static const struct {
+    const char *name;
+    uint8_t overhead;
+} buses[] = { { "free", 0 }, { "SPI", 2 }, { "I2C", 4 } };
+
+static uint8_t regs[DATA_BYTES];
+
+/**
+ * @brief Fake bus read from TEMP_DATA1..GYRO_DATA_Z0
+ * @param reg Register
+ * @param data Output buffer
+ * @param len Length
+ * @return 0, or -2 outside the data registers
+ */
+static int fake_read(uint8_t reg, uint8_t *data, uint16_t len) {
+    if(reg < ICM42688_REG_TEMP_DATA1 || reg + len > ICM42688_REG_TEMP_DATA1 + DATA_BYTES) return -2;
+    memcpy(data, &regs[reg - ICM42688_REG_TEMP_DATA1], len);
+    return 0;
+}
+
+/**
+ * @brief Fake bus write (unused by the scheduler)
+ * @param reg Register
+ * @param data Data
+ * @param len Length
+ * @return -2
+ */
+static int fake_write(uint8_t reg, uint8_t *data, uint16_t len) {
+    (void)reg;
+    (void)data;
+    (void)len;
+    return -2;
+}
+
+/**
+ * @brief Big-endian register pair
+ * @param i Offset of the MSB from TEMP_DATA1
+ * @return Signed value
+ */
+static int16_t reg16(int i) {
+    return (int16_t)((regs[i] << 8) | regs[i + 1]);
+}
+
+/**
+ * @brief Run one rate set on one bus
+ * @param r Rate set
+ * @param overhead Transaction overhead in byte times
+ * @param ticks Number of ticks
+ * @param stats Output statistics
+ * @return Number of consistency errors, negative value on error
+ */
+static int run(const rates_t *r, uint8_t overhead, uint32_t ticks, icm42688_sched_stats_t *stats) {
+    static icm42688_sched_t sch;
+    icm42688_t dev;
+    int errors = 0;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.bus.read = fake_read;
+    dev.bus.write = fake_write;
+    if(icm42688_sched_init(&sch, &dev, r->div[0], r->div[1], r->div[2], overhead) != 0) return -1;
+
+    for(uint32_t t = 0; t < ticks; t++) {
+        icm42688_data_t d;
+        uint8_t valid, due = 0;
+
+        /* New sensor values every tick */
+        for(int i = 0; i < DATA_BYTES; i++) regs[i] = (uint8_t)(t * 7 + i * 13);
+        for(int ch = 0; ch < ICM42688_SCHED_CHANNELS; ch++) {
+            if(r->div[ch] && t % r->div[ch] == 0) due |= (uint8_t)(1u << ch);
+        }
+
+        if(icm42688_sched_tick(&sch, &d, &valid) != 0) return -2;
+        if((valid & due) != due) errors++;
+        if((valid & ICM42688_SCHED_VALID_TEMP) && d.temp != reg16(0)) errors++;
+        if((valid & ICM42688_SCHED_VALID_ACCEL) &&
+           (d.accel_x != reg16(2) || d.accel_y != reg16(4) || d.accel_z != reg16(6))) errors++;
+        if((valid & ICM42688_SCHED_VALID_GYRO) &&
+           (d.gyro_x != reg16(8) || d.gyro_y != reg16(10) || d.gyro_z != reg16(12))) errors++;
+    }
+    *stats = sch.stats;
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    uint32_t ticks = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 10000;
+    int failed = 0;
+
+    if(ticks == 0) {
+        fprintf(stderr, "usage: %s [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%u ticks, read_all = %d bytes in 1 transaction per tick\n\n", ticks, DATA_BYTES);
+    printf("%-26s %-5s %10s %10s %10s %8s\n", "rates", "bus", "bytes %", "txn/tick", "cost %", "errors");
+    for(size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        for(size_t b = 0; b < sizeof(buses) / sizeof(buses[0]); b++) {
+            icm42688_sched_stats_t st;
+            int errors = run(&rates[i], buses[b].overhead, ticks, &st);
+            if(errors < 0) return 1;
+
+            double cost = (double)st.bytes + (double)st.transactions * buses[b].overhead;
+            double base = (double)st.ticks * (DATA_BYTES + buses[b].overhead);
+            printf("%-26s %-5s %10.1f %10.3f %10.1f %8d%s\n", rates[i].name, buses[b].name,
+                   100.0 * st.bytes / st.read_all_bytes, (double)st.transactions / st.ticks, 100.0 * cost / base,
+                   errors, errors ? "  FAIL" : "");
+            if(errors) failed = 1;
+        }
+    }
+    return failed;
+}
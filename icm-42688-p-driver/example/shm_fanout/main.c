@@ -0,0 +1,215 @@
+/**
+ * @file main.c
+ * @brief Host tool: measure shared-memory fan-out latency and throughput
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   shm_fanout [readers] [samples] [rate_hz] [batch]
+ *
+ * Forks `readers` subscriber processes (default 4), then publishes `samples`
+ * synthetic samples (default 1000000) in batches of `batch` (default 16) at
+ * `rate_hz` samples per second (default 0 = as fast as possible). Every
+ * reader checks the sample sequence and reports the publish-to-consume
+ * latency, its throughput and any lost samples. The publisher reports how
+ * many batches needed a futex wake system call.
+ *
+ * Finally the tool attaches one more subscriber, re-creates the ring under
+ * the same name and fails unless that subscriber gets an error from
+ * icm42688_shm_peek right away instead of sleeping.
+ *
+ * Build: gcc -O2 -std=gnu99 -o shm_fanout main.c ../../src/shm_ring.c -I../../inc -lrt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../../inc/shm_ring.h"
+
+#define RING_NAME     "/icm42688_fanout"
+#define RING_CAPACITY 4096
+#define MAX_BATCH     256
+
+/**
+ * @brief Monotonic time
+ * @return Microseconds
+ */
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/**
+ * @brief Sample sequence number carried in accel_x/accel_y
+ * @param d Sample data
+ * @return Sequence number
+ */
+static uint32_t sample_seq(const icm42688_data_t *d) {
+    return (uint32_t)(uint16_t)d->accel_x | ((uint32_t)(uint16_t)d->accel_y << 16);
+}
+
+/**
+ * @brief Check that replacing the ring releases a subscriber of the old one
+ * @param pub Publisher handle, re-created on return
+ * @return 0 if the subscriber saw the replacement, 1 otherwise
+ */
+static int check_replace(icm42688_shm_pub_t *pub) {
+    icm42688_shm_sub_t sub;
+    const icm42688_sample_t *batch;
+
+    if(icm42688_shm_subscribe(&sub, RING_NAME) != 0) return 1;
+    icm42688_shm_destroy(pub, 0);
+    if(icm42688_shm_create(pub, RING_NAME, RING_CAPACITY) != 0) return 1;
+
+    uint64_t start = now_us();
+    int r = icm42688_shm_peek(&sub, &batch, MAX_BATCH, 5000);
+    uint64_t waited = now_us() - start;
+    icm42688_shm_unsubscribe(&sub);
+
+    printf("replaced ring: peek returned %d after %llu us\n", r, (unsigned long long)waited);
+    return r == -3 && waited < 1000000u ? 0 : 1;
+}
+
+/**
+ * @brief Subscriber process body
+ * @param id Reader index
+ * @param total Samples the publisher will send
+ * @return Process exit code
+ */
+static int run_reader(int id, uint64_t total) {
+    icm42688_shm_sub_t sub;
+    uint64_t lat_sum = 0, lat_max = 0, seq_errors = 0, first_us = 0;
+
+    if(icm42688_shm_subscribe(&sub, RING_NAME) != 0) {
+        fprintf(stderr, "reader %d: subscribe failed\n", id);
+        return 1;
+    }
+
+    /* Tell the parent we are attached (cursor is at the current head) */
+    putchar('\0');
+    fflush(stdout);
+
+    while(sub.stats.consumed + sub.stats.lost < total) {
+        const icm42688_sample_t *batch;
+        int n = icm42688_shm_peek(&sub, &batch, MAX_BATCH, 1000);
+        if(n < 0) break;
+        if(n == 0) continue;
+
+        uint32_t now = (uint32_t)now_us();
+        if(first_us == 0) first_us = now_us();
+        uint64_t sum = 0, max = 0;
+        uint32_t errors = 0;
+        uint32_t seq = (uint32_t)(sub.cursor);
+
+        for(int i = 0; i < n; i++) {
+            uint32_t lat = now - batch[i].timestamp_us;
+            sum += lat;
+            if(lat > max) max = lat;
+            if(sample_seq(&batch[i].data) != seq + (uint32_t)i) errors++;
+        }
+
+        /* Results only count if the batch was not overwritten meanwhile */
+        if(icm42688_shm_release(&sub, (uint32_t)n) == 0) {
+            lat_sum += sum;
+            if(max > lat_max) lat_max = max;
+            seq_errors += errors;
+        }
+    }
+
+    uint64_t elapsed = now_us() - first_us;
+    fprintf(stderr, "reader %d: %llu samples, %llu lost, %u overruns, %llu seq errors, "
+            "latency mean %.1f us max %llu us, %.0f samples/s\n",
+            id, (unsigned long long)sub.stats.consumed, (unsigned long long)sub.stats.lost,
+            sub.stats.overruns, (unsigned long long)seq_errors,
+            sub.stats.consumed ? (double)lat_sum / (double)sub.stats.consumed : 0.0,
+            (unsigned long long)lat_max,
+            elapsed ? (double)sub.stats.consumed * 1e6 / (double)elapsed : 0.0);
+
+    icm42688_shm_unsubscribe(&sub);
+    return seq_errors ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    int readers = argc > 1 ? atoi(argv[1]) : 4;
+    uint64_t total = argc > 2 ? strtoull(argv[2], NULL, 10) : 1000000u;
+    uint32_t rate = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 0;
+    uint32_t batch = argc > 4 ? (uint32_t)strtoul(argv[4], NULL, 10) : 16;
+    static icm42688_sample_t buf[MAX_BATCH];
+    icm42688_shm_pub_t pub;
+    int sync[2];
+
+    if(readers < 1 || total == 0 || batch == 0 || batch > MAX_BATCH) {
+        fprintf(stderr, "usage: %s [readers] [samples] [rate_hz] [batch<=%d]\n", argv[0], MAX_BATCH);
+        return 1;
+    }
+    if(icm42688_shm_create(&pub, RING_NAME, RING_CAPACITY) != 0) {
+        fprintf(stderr, "shm_create failed\n");
+        return 1;
+    }
+    if(pipe(sync) != 0) return 1;
+
+    for(int r = 0; r < readers; r++) {
+        if(fork() == 0) {
+            close(sync[0]);
+            dup2(sync[1], STDOUT_FILENO);
+            _exit(run_reader(r, total));
+        }
+    }
+    close(sync[1]);
+
+    /* Wait until every reader is attached */
+    for(int r = 0; r < readers; r++) {
+        char c;
+        if(read(sync[0], &c, 1) != 1) {
+            fprintf(stderr, "reader failed to attach\n");
+            return 1;
+        }
+    }
+
+    uint64_t start = now_us();
+    for(uint64_t seq = 0; seq < total; ) {
+        uint32_t n = (uint32_t)((total - seq) < batch ? (total - seq) : batch);
+
+        if(rate) {
+            uint64_t due = start + seq * 1000000u / rate;
+            while(now_us() < due) {
+                /* Pace the synthetic sensor */
+            }
+        }
+
+        uint32_t ts = (uint32_t)now_us();
+        for(uint32_t i = 0; i < n; i++) {
+            uint32_t s = (uint32_t)(seq + i);
+            memset(&buf[i], 0, sizeof(buf[i]));
+            buf[i].data.accel_x = (int16_t)(s & 0xFFFF);
+            buf[i].data.accel_y = (int16_t)(s >> 16);
+            buf[i].timestamp_us = ts;
+        }
+        icm42688_shm_publish(&pub, buf, n);
+        seq += n;
+    }
+    uint64_t elapsed = now_us() - start;
+
+    int failed = 0;
+    for(int r = 0; r < readers; r++) {
+        int status;
+        wait(&status);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = 1;
+    }
+
+    printf("published %llu samples to %d readers in %.3f s (%.0f samples/s), %llu of %llu batches woke a reader\n",
+           (unsigned long long)total, readers, (double)elapsed / 1e6,
+           elapsed ? (double)total * 1e6 / (double)elapsed : 0.0,
+           (unsigned long long)pub.wakes, (unsigned long long)((total + batch - 1) / batch));
+
+    if(check_replace(&pub) != 0) {
+        printf("FAIL: subscriber of the replaced ring was not released\n");
+        failed = 1;
+    }
+    icm42688_shm_destroy(&pub, 1);
+    return failed;
+}
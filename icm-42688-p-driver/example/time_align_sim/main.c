@@ -0,0 +1,183 @@
+/**
+ * @file main.c
+ * @brief Host test: clock alignment and merge of drifting, wrapping sensor clocks
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   time_align_sim [seconds] [ts_bits] [jitter_us]
+ *
+ * Simulates three 1 kHz devices whose clocks run +40, -25 and +10 ppm off the
+ * host clock, with different start offsets. Sensor timestamps are counters of
+ * `ts_bits` bits (default 16, the FIFO packet timestamp, which wraps every
+ * 65.5 ms). Every 10 ms each device delivers a batch of samples; one
+ * (sensor, host) pair per batch is fed to its estimator with up to
+ * `jitter_us` (default 20) of interrupt latency on the host side, then the
+ * batches are merged.
+ *
+ * Prints the RMS and maximum error of the mapped host timestamps against the
+ * true acquisition times after the first window, how much drift the skew fit
+ * removes, and how many merged items step backwards in host time. Fails if a
+ * sample is lost or duplicated, the merged output steps backwards, or the
+ * maximum error exceeds the jitter bound.
+ *
+ * Build: gcc -O2 -std=gnu99 -o time_align_sim main.c ../../src/time_align.c -I../../inc -lm
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../inc/time_align.h"
+
+#define DEVICES    3
+#define ODR_HZ     1000
+#define PERIOD_US  (1000000 / ODR_HZ)
+#define BATCH      10
+
+static const double ppm[DEVICES] = { 40.0, -25.0, 10.0 };
+static const double start_us[DEVICES] = { 1234.5, 377.0, 5000.25 };
+
+/**
+ * @brief Per-device simulated stream
+ */
+typedef struct {
+    icm42688_data_t *samples; /**< All samples, temp carries the device index */
+    uint32_t *sensor_ts;      /**< Raw sensor timestamps */
+    double *true_us;          /**< True host acquisition time */
+    uint32_t fed;             /**< Batches handed to the merger */
+    uint32_t ready;           /**< Batches delivered by the device */
+} device_t;
+
+/**
+ * @brief Deterministic uniform random value
+ * @param state Generator state
+ * @return Value in [0, 1)
+ */
+static double uniform(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return (double)*state / 4294967296.0;
+}
+
+int main(int argc, char **argv) {
+    static icm42688_clock_est_t clocks[DEVICES];
+    static icm42688_merge_t merge;
+    device_t dev[DEVICES];
+    double seconds = argc > 1 ? strtod(argv[1], NULL) : 60.0;
+    unsigned bits = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : ICM42688_TS_BITS_FIFO;
+    double jitter = argc > 3 ? strtod(argv[3], NULL) : 20.0;
+    uint32_t batches = (uint32_t)(seconds * ODR_HZ) / BATCH;
+    uint32_t n_samples = batches * BATCH;
+    uint32_t rng = 0x7A11u;
+
+    if(batches < 2 * ICM42688_TIMESYNC_WINDOW || bits < 12 || bits > 32 || jitter < 0.0) {
+        fprintf(stderr, "usage: %s [seconds] [ts_bits 12..32] [jitter_us]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1UL << bits) - 1;
+    for(int d = 0; d < DEVICES; d++) {
+        dev[d].samples = calloc(n_samples, sizeof(icm42688_data_t));
+        dev[d].sensor_ts = malloc(n_samples * sizeof(uint32_t));
+        dev[d].true_us = malloc(n_samples * sizeof(double));
+        if(!dev[d].samples || !dev[d].sensor_ts || !dev[d].true_us) return 1;
+        dev[d].fed = dev[d].ready = 0;
+
+        for(uint32_t n = 0; n < n_samples; n++) {
+            double sensor = 1000.0 * d + (double)n * PERIOD_US;
+            dev[d].sensor_ts[n] = (uint32_t)(uint64_t)sensor & mask;
+            dev[d].true_us[n] = start_us[d] + sensor * (1.0 + ppm[d] * 1e-6);
+            dev[d].samples[n].temp = (int16_t)d;
+            dev[d].samples[n].accel_x = (int16_t)n;
+        }
+        icm42688_clock_init(&clocks[d], (uint8_t)bits);
+    }
+    icm42688_merge_init(&merge, DEVICES, clocks);
+
+    uint32_t emitted[DEVICES] = { 0 };
+    uint32_t measured = 0, backwards = 0, order_errors = 0;
+    double err_sq = 0.0, err_max = 0.0, back_max = 0.0;
+    int64_t last_host = INT64_MIN;
+
+    for(uint32_t b = 0; b < batches; b++) {
+        /* Every device delivers one batch and timestamps its interrupt */
+        for(int d = 0; d < DEVICES; d++) {
+            uint32_t last = b * BATCH + BATCH - 1;
+            double irq_host = dev[d].true_us[last] + jitter * uniform(&rng);
+            icm42688_clock_add(&clocks[d], dev[d].sensor_ts[last], (int64_t)llround(irq_host));
+            icm42688_merge_refit(&merge, (uint8_t)d);
+            dev[d].ready++;
+        }
+
+        for(;;) {
+            icm42688_merge_item_t item;
+            int r = icm42688_merge_next(&merge, &item);
+            if(r < 0) return 1;
+            if(r == 0) {
+                int s = icm42688_merge_starved_stream(&merge);
+                if(s < 0 || dev[s].fed >= dev[s].ready) break;
+                if(icm42688_merge_feed(&merge, (uint8_t)s, &dev[s].samples[dev[s].fed * BATCH],
+                                       &dev[s].sensor_ts[dev[s].fed * BATCH], BATCH) != 0) return 1;
+                dev[s].fed++;
+                continue;
+            }
+
+            int d = item.sample->temp;
+            uint32_t n = (uint32_t)(uint16_t)item.sample->accel_x;
+            if(n != (emitted[d] & 0xFFFF)) order_errors++;
+            n = emitted[d]++;
+
+            if(item.host_us < last_host) {
+                backwards++;
+                if(last_host - item.host_us > back_max) back_max = (double)(last_host - item.host_us);
+            }
+            last_host = item.host_us;
+
+            /* Score once the window has filled */
+            if(n >= ICM42688_TIMESYNC_WINDOW * BATCH) {
+                double e = (double)item.host_us - dev[d].true_us[n];
+                err_sq += e * e;
+                if(fabs(e) > err_max) err_max = fabs(e);
+                measured++;
+            }
+        }
+    }
+
+    int lost = 0;
+    for(int d = 0; d < DEVICES; d++) {
+        /* The last batch of each stream waits for its successor; drain by closing */
+        icm42688_merge_close(&merge, (uint8_t)d);
+    }
+    icm42688_merge_item_t item;
+    while(icm42688_merge_next(&merge, &item) == 1) emitted[item.sample->temp]++;
+    for(int d = 0; d < DEVICES; d++) {
+        if(emitted[d] != dev[d].fed * BATCH || dev[d].fed != batches) lost = 1;
+    }
+
+    double drift = 0.0;
+    for(int d = 0; d < DEVICES; d++) {
+        double span = fabs(ppm[d]) * 1e-6 * n_samples * PERIOD_US;
+        if(span > drift) drift = span;
+    }
+
+    printf("%d devices, %.0f s, %u-bit sensor counter (wraps every %.1f ms), jitter %.0f us\n",
+           DEVICES, seconds, bits, (mask + 1.0) / 1000.0, jitter);
+    printf("drift without skew fit: %.1f us over the run\n", drift);
+    printf("mapped timestamp error: rms %.2f us, max %.2f us over %u samples\n",
+           measured ? sqrt(err_sq / measured) : 0.0, err_max, measured);
+    printf("merged output steps backwards %u times (max %.0f us)\n", backwards, back_max);
+
+    int failed = lost || order_errors || backwards || err_max > jitter + 2.0;
+    if(lost) printf("FAIL: samples lost or duplicated\n");
+    if(order_errors) printf("FAIL: %u samples out of order within a stream\n", order_errors);
+    if(backwards) printf("FAIL: merged output not ordered by host time\n");
+    if(err_max > jitter + 2.0) printf("FAIL: error above the jitter bound\n");
+
+    for(int d = 0; d < DEVICES; d++) {
+        free(dev[d].samples);
+        free(dev[d].sensor_ts);
+        free(dev[d].true_us);
+    }
+    return failed;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file main.c
+ * @brief Host tool: convert an ICM-42688 trace dump to Chrome trace JSON
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Usage:
+ *   trace_export <dump.bin> [out.json]
+ *
+ * The dump is the byte stream written by icm42688_trace_dump() (for example
+ * captured from a UART). The output opens in chrome://tracing or
+ * ui.perfetto.dev, times in microseconds from the first event. Events are
+ * placed on the thread that recorded them when the dump carries thread ids
+ * (Linux), otherwise on one track per core. Non-blocking bus transfers are
+ * async spans ("b"/"e" matched by id), since they start in one context and
+ * end in an interrupt.
+ *
+ * Build: gcc -O2 -std=gnu99 -o trace_export main.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef ICM42688_TRACE_ENABLE
+#define ICM42688_TRACE_ENABLE
+#endif
+#include "../../inc/trace.h"
+
+#define BASE_RECORD_SIZE 16  /* Record without thread id */
+
+/**
+ * @brief Record as decoded from the dump, whatever its on-target size
+ */
+typedef struct {
+    uint64_t ts;     /**< Timestamp, unwrapped */
+    uint32_t arg;    /**< Argument or span id */
+    uint16_t event;  /**< Event identifier */
+    uint8_t phase;   /**< Phase */
+    uint32_t tid;    /**< Thread id, or core index if the dump has none */
+} record_t;
+
+/**
+ * @brief Name of a trace event
+ * @param event Event identifier
+ * @param buf Scratch buffer for user events
+ * @param size Scratch buffer size
+ * @return Event name
+ */
+static const char *event_name(uint16_t event, char *buf, size_t size) {
+    static const char *const names[] = {
+        "bus_read", "bus_write", "bus_async", "read_all", "decode",
+        "fifo_read", "fifo_parse", "isr"
+    };
+
+    if(event < ICM42688_TRACE_EV_USER) return names[event];
+    snprintf(buf, size, "user%u", (unsigned)(event - ICM42688_TRACE_EV_USER));
+    return buf;
+}
+
+int main(int argc, char **argv) {
+    icm42688_trace_header_t hdr;
+    FILE *in;
+    FILE *out = stdout;
+
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <dump.bin> [out.json]\n", argv[0]);
+        return 1;
+    }
+    if((in = fopen(argv[1], "rb")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    if(fread(&hdr, sizeof(hdr), 1, in) != 1 || hdr.magic != ICM42688_TRACE_MAGIC ||
+       hdr.version != ICM42688_TRACE_VERSION || hdr.ts_hz == 0 || hdr.record_size < BASE_RECORD_SIZE) {
+        fprintf(stderr, "not a trace dump\n");
+        return 1;
+    }
+
+    /* Load every core section, unwrapping 32-bit cycle counters */
+    record_t *recs[256] = {0};
+    uint8_t raw[256];
+    uint32_t counts[256] = {0};
+    uint64_t t0 = UINT64_MAX;
+
+    for(uint32_t c = 0; c < hdr.cores; c++) {
+        if(fread(&counts[c], sizeof(uint32_t), 1, in) != 1 || counts[c] > hdr.depth) {
+            fprintf(stderr, "truncated dump\n");
+            return 1;
+        }
+        recs[c] = malloc((size_t)counts[c] * sizeof(record_t) + 1);
+        if(!recs[c]) return 1;
+        for(uint32_t i = 0; i < counts[c]; i++) {
+            record_t *r = &recs[c][i];
+            if(hdr.record_size > sizeof(raw) || fread(raw, hdr.record_size, 1, in) != 1) {
+                fprintf(stderr, "truncated dump\n");
+                return 1;
+            }
+            memcpy(&r->ts, raw, 8);
+            memcpy(&r->arg, raw + 8, 4);
+            memcpy(&r->event, raw + 12, 2);
+            r->phase = raw[14];
+            r->tid = c;
+            if(hdr.record_size >= BASE_RECORD_SIZE + 4) memcpy(&r->tid, raw + BASE_RECORD_SIZE, 4);
+        }
+
+        if(hdr.ts_bits == 32) {
+            uint64_t base = 0;
+            for(uint32_t i = 1; i < counts[c]; i++) {
+                if((uint32_t)recs[c][i].ts < (uint32_t)recs[c][i - 1].ts) base += 1ULL << 32;
+                recs[c][i].ts = base + (uint32_t)recs[c][i].ts;
+            }
+        }
+        if(counts[c] && recs[c][0].ts < t0) t0 = recs[c][0].ts;
+    }
+    fclose(in);
+
+    if(argc > 2 && (out = fopen(argv[2], "w")) == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    int first = 1;
+    for(uint32_t c = 0; c < hdr.cores; c++) {
+        for(uint32_t i = 0; i < counts[c]; i++) {
+            const record_t *r = &recs[c][i];
+            char buf[16];
+            double us = (double)(r->ts - t0) * 1e6 / hdr.ts_hz;
+
+            fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%lu,",
+                    first ? "" : ",\n", event_name(r->event, buf, sizeof(buf)), r->phase, us, (unsigned long)r->tid);
+            if(r->phase == ICM42688_TRACE_PH_ASYNC_BEGIN || r->phase == ICM42688_TRACE_PH_ASYNC_END) {
+                fprintf(out, "\"cat\":\"bus\",\"id\":\"0x%lx\",\"args\":{\"core\":%u}}", (unsigned long)r->arg,
+                        (unsigned)c);
+            } else {
+                fprintf(out, "%s\"args\":{\"arg\":%lu}}", r->phase == ICM42688_TRACE_PH_INSTANT ? "\"s\":\"t\"," : "",
+                        (unsigned long)r->arg);
+            }
+            first = 0;
+        }
+        free(recs[c]);
+    }
+    fprintf(out, "\n]}\n");
+
+    if(out != stdout) fclose(out);
+    return 0;
+}
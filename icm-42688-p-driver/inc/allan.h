@@ -0,0 +1,131 @@
+/**
+ * @file allan.h
+ * @brief Allan variance noise characterization of ICM-42688 samples
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Computes the Allan deviation of all six axes at octave-spaced cluster sizes
+ * m = 1, 2, 4, ... samples and fits the standard noise terms: angle/velocity
+ * random walk (slope -1/2), bias instability (flat minimum) and rate random
+ * walk (slope +1/2).
+ *
+ * Streaming mode runs on raw samples as they arrive with bounded memory. Per
+ * axis it keeps the running integer sum and, per octave, a ring of
+ * 2 * ICM42688_ALLAN_OVERLAP + 1 past sums. Small clusters are evaluated at
+ * every sample (fully overlapping); for clusters longer than
+ * ICM42688_ALLAN_OVERLAP samples the sums are taken every m / OVERLAP samples,
+ * so consecutive clusters still overlap by (OVERLAP - 1) / OVERLAP. Cost is
+ * about log2(OVERLAP) + 2 ring updates per axis and sample.
+ *
+ * Offline mode (Linux) takes a whole recorded capture and computes the fully
+ * overlapping estimator with sliding cluster sums, splitting (axis, octave)
+ * jobs across threads. It needs no memory beyond the capture itself.
+ */
+
+#ifndef ALLAN_H
+#define ALLAN_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#ifndef ICM42688_ALLAN_OCTAVES
+#define ICM42688_ALLAN_OCTAVES 24  /**< Cluster sizes 2^0 .. 2^23 samples */
+#endif
+
+#ifndef ICM42688_ALLAN_OVERLAP
+#define ICM42688_ALLAN_OVERLAP 8   /**< Cluster sums per cluster length, power of 2 */
+#endif
+
+#define ICM42688_ALLAN_AXES 6      /**< accel x/y/z, gyro x/y/z */
+#define ICM42688_ALLAN_RING (2 * ICM42688_ALLAN_OVERLAP + 1)
+
+/**
+ * @brief Noise terms of one axis (units of the configured scale)
+ */
+typedef struct {
+    float random_walk;       /**< ARW/VRW: deviation at tau = 1 s, units/s * sqrt(s) */
+    float bias_instability;  /**< Flat-region minimum / 0.664, units/s */
+    float bias_tau;          /**< Cluster time of the minimum, s */
+    float rate_random_walk;  /**< RRW: deviation at tau = 3 s of the +1/2 slope, units/s / sqrt(s); 0 if not observed */
+} icm42688_noise_fit_t;
+
+/**
+ * @brief Allan deviation report
+ */
+typedef struct {
+    float tau[ICM42688_ALLAN_OCTAVES];                        /**< Cluster time, s */
+    float adev[ICM42688_ALLAN_AXES][ICM42688_ALLAN_OCTAVES];  /**< Allan deviation, scaled units */
+    uint32_t clusters[ICM42688_ALLAN_OCTAVES];                /**< Cluster differences averaged */
+    uint8_t octaves;                                          /**< Valid entries */
+    icm42688_noise_fit_t fit[ICM42688_ALLAN_AXES];            /**< Noise terms per axis */
+} icm42688_allan_report_t;
+
+/**
+ * @brief Streaming state of one octave of one axis
+ */
+typedef struct {
+    int64_t ring[ICM42688_ALLAN_RING];  /**< Past cumulative sums */
+    uint8_t pos;                        /**< Newest entry */
+    uint8_t filled;                     /**< Valid entries */
+    double acc;                         /**< Sum of squared second differences */
+    uint32_t count;                     /**< Terms in acc */
+} icm42688_allan_octave_t;
+
+/**
+ * @brief Streaming Allan variance state
+ */
+typedef struct {
+    icm42688_allan_octave_t oct[ICM42688_ALLAN_AXES][ICM42688_ALLAN_OCTAVES]; /**< Per axis and octave */
+    int64_t sum[ICM42688_ALLAN_AXES];  /**< Running sum of raw samples */
+    uint32_t samples;                  /**< Samples pushed */
+    float tau0;                        /**< Sample period, s */
+    float accel_scale;                 /**< Accel units per LSB */
+    float gyro_scale;                  /**< Gyro units per LSB */
+} icm42688_allan_t;
+
+#if ICM42688_CFG_ALLAN
+/**
+ * @brief Initialize streaming Allan variance
+ * @param av Pointer to state
+ * @param odr_hz Sample rate in Hz
+ * @param accel_scale Accel units per LSB (e.g. m/s^2 per LSB)
+ * @param gyro_scale Gyro units per LSB (e.g. deg/s per LSB)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_allan_init(icm42688_allan_t *av, float odr_hz, float accel_scale, float gyro_scale);
+
+/**
+ * @brief Add one raw sample
+ * @param av Pointer to state
+ * @param data Sample
+ * @return 0 on success, negative value on error
+ */
+int icm42688_allan_push(icm42688_allan_t *av, const icm42688_data_t *data);
+
+/**
+ * @brief Compute Allan deviation and noise fits from the samples pushed so far
+ * @param av Pointer to state
+ * @param report Pointer to report
+ * @return 0 on success, negative value on error (-3 if too few samples)
+ */
+int icm42688_allan_report(const icm42688_allan_t *av, icm42688_allan_report_t *report);
+
+#if defined(__linux__)
+/**
+ * @brief Fully overlapping Allan deviation of a recorded capture using several threads
+ * @param samples Recorded samples
+ * @param count Number of samples
+ * @param odr_hz Sample rate in Hz
+ * @param accel_scale Accel units per LSB
+ * @param gyro_scale Gyro units per LSB
+ * @param threads Worker threads (0 = number of online CPUs)
+ * @param report Pointer to report
+ * @return 0 on success, negative value on error (-3 if too few samples)
+ */
+int icm42688_allan_offline(const icm42688_data_t *samples, uint32_t count, float odr_hz,
+                           float accel_scale, float gyro_scale, unsigned threads,
+                           icm42688_allan_report_t *report);
+#endif
+#endif /* ICM42688_CFG_ALLAN */
+
+#endif // ALLAN_H
@@ -0,0 +1,164 @@
+/**
+ * @file autorange.h
+ * @brief Saturation detection and automatic full-scale range selection for ICM-42688
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Every sample is decoded into a ranged sample carrying the accel and gyro
+ * full-scale selection it was taken with, a per-axis saturation mask (value
+ * railed at -32768 or +32767) and the values normalized to the finest range's
+ * LSB (accel: 16384 LSB/g, gyro: 2097.2 LSB/dps). Normalization is a shift
+ * (3 - accel_fs and 7 - gyro_fs), so downstream code sees one continuous
+ * stream across range changes.
+ *
+ * The controller switches one step coarser as soon as any axis reaches the
+ * upper threshold (saturation included) and one step finer after every axis
+ * has stayed below the lower threshold for hold_samples samples. The gap
+ * between the thresholds (fine range full scale is half the current one)
+ * provides the hysteresis.
+ *
+ * A new range only applies to samples the sensor takes after the switch.
+ * icm42688_autorange_process() is for register-polled data: it decodes the
+ * next sample with the new range and flags the first settle_samples samples,
+ * since the one read right after the switch may still be in the old range.
+ * FIFO data lags further behind: icm42688_autorange_process_fifo() reads the
+ * FIFO count just before writing the new range and keeps decoding that many
+ * queued samples, plus the rest of the batch, with the old range before
+ * settling starts. Samples landing during the register write are the first
+ * ones after that backlog, so settling covers them. Settling samples do not drive the controller, except that
+ * saturation on two consecutive settling samples (which cannot both be old
+ * range leftovers) switches coarser again at once.
+ */
+
+#ifndef AUTORANGE_H
+#define AUTORANGE_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+/* Saturation mask bits */
+#define ICM42688_SAT_ACCEL_X  0x01  /**< Accel X railed */
+#define ICM42688_SAT_ACCEL_Y  0x02  /**< Accel Y railed */
+#define ICM42688_SAT_ACCEL_Z  0x04  /**< Accel Z railed */
+#define ICM42688_SAT_GYRO_X   0x08  /**< Gyro X railed */
+#define ICM42688_SAT_GYRO_Y   0x10  /**< Gyro Y railed */
+#define ICM42688_SAT_GYRO_Z   0x20  /**< Gyro Z railed */
+
+/* Sample flags */
+#define ICM42688_RANGE_ACCEL_SETTLING 0x01  /**< Accel range switched recently, scale uncertain */
+#define ICM42688_RANGE_GYRO_SETTLING  0x02  /**< Gyro range switched recently, scale uncertain */
+
+/**
+ * @brief Sample with range information
+ */
+typedef struct {
+    int32_t accel[3];   /**< Accel in +-2 g LSB (16384 LSB/g) */
+    int32_t gyro[3];    /**< Gyro in +-15.625 dps LSB (2097.2 LSB/dps) */
+    int16_t temp;       /**< Raw temperature */
+    uint8_t accel_fs;   /**< icm42688_accel_fs_t used for this sample */
+    uint8_t gyro_fs;    /**< icm42688_gyro_fs_t used for this sample */
+    uint8_t sat_mask;   /**< ICM42688_SAT_* bits */
+    uint8_t flags;      /**< ICM42688_RANGE_* bits */
+} icm42688_ranged_sample_t;
+
+/**
+ * @brief Controller tuning
+ */
+typedef struct {
+    uint8_t accel_coarsest;   /**< Coarsest allowed accel range (icm42688_accel_fs_t) */
+    uint8_t accel_finest;     /**< Finest allowed accel range */
+    uint8_t gyro_coarsest;    /**< Coarsest allowed gyro range (icm42688_gyro_fs_t) */
+    uint8_t gyro_finest;      /**< Finest allowed gyro range */
+    int16_t up_thresh;        /**< |raw| at or above this switches coarser */
+    int16_t down_thresh;      /**< |raw| below this on all axes counts as quiet */
+    uint16_t hold_samples;    /**< Quiet samples required before switching finer */
+    uint8_t settle_samples;   /**< Samples flagged after a switch */
+} icm42688_autorange_config_t;
+
+/**
+ * @brief Range state of one sensor
+ */
+typedef struct {
+    uint8_t fs;        /**< Programmed FS_SEL */
+    uint8_t data_fs;   /**< FS_SEL of the samples being decoded */
+    uint8_t coarsest;  /**< Lowest allowed FS_SEL */
+    uint8_t finest;    /**< Highest allowed FS_SEL */
+    uint8_t settle;    /**< Samples left in settling */
+    uint8_t railed;    /**< Consecutive samples with a railed axis */
+    uint16_t backlog;  /**< Queued samples still in data_fs before fs applies */
+    uint16_t quiet;    /**< Consecutive quiet samples */
+    uint32_t switches; /**< Range changes */
+} icm42688_range_ctl_t;
+
+/**
+ * @brief Auto-range controller
+ */
+typedef struct {
+    icm42688_t *dev;                  /**< Sensor */
+    icm42688_autorange_config_t cfg;  /**< Tuning */
+    icm42688_range_ctl_t accel;       /**< Accel range state */
+    icm42688_range_ctl_t gyro;        /**< Gyro range state */
+} icm42688_autorange_t;
+
+#if ICM42688_CFG_AUTORANGE
+/**
+ * @brief Fill configuration with defaults (full range span, 92 % up, 37 % down, 200 sample hold)
+ * @param cfg Pointer to configuration
+ */
+void icm42688_autorange_config_default(icm42688_autorange_config_t *cfg);
+
+/**
+ * @brief Initialize controller and program the starting ranges
+ * @param ar Pointer to controller
+ * @param dev Sensor
+ * @param cfg Tuning (NULL for defaults)
+ * @param accel_fs Starting accel range
+ * @param gyro_fs Starting gyro range
+ * @return 0 on success, negative value on error
+ */
+int icm42688_autorange_init(icm42688_autorange_t *ar, icm42688_t *dev, const icm42688_autorange_config_t *cfg,
+                            icm42688_accel_fs_t accel_fs, icm42688_gyro_fs_t gyro_fs);
+
+/**
+ * @brief Decode a raw sample: saturation mask and normalization (no range control)
+ * @param raw Raw sample
+ * @param accel_fs Accel range the sample was taken with
+ * @param gyro_fs Gyro range the sample was taken with
+ * @param out Pointer to ranged sample
+ */
+void icm42688_range_decode(const icm42688_data_t *raw, uint8_t accel_fs, uint8_t gyro_fs,
+                           icm42688_ranged_sample_t *out);
+
+/**
+ * @brief Decode a register-polled sample and update the range controller
+ * @param ar Pointer to controller
+ * @param raw Raw sample (data registers)
+ * @param out Pointer to ranged sample
+ * @return 1 if a range was changed, 0 otherwise, negative value on error
+ */
+int icm42688_autorange_process(icm42688_autorange_t *ar, const icm42688_data_t *raw,
+                               icm42688_ranged_sample_t *out);
+
+#if ICM42688_CFG_FIFO
+/**
+ * @brief Decode a batch of FIFO samples and update the range controller
+ *
+ * When a range changes at sample i, the FIFO count is read right before the
+ * register write; the remaining count - 1 - i samples of the batch and the
+ * samples queued at that point are decoded with the old range, and the
+ * settle_samples after them are flagged. Pass every later
+ * FIFO batch through this function in order.
+ *
+ * @param ar Pointer to controller
+ * @param raw Samples parsed from the FIFO, oldest first
+ * @param count Number of samples
+ * @param packet_size FIFO packet size in bytes (e.g. ICM42688_FIFO_PACKET3_SIZE)
+ * @param out Ranged samples (count entries)
+ * @return 1 if a range was changed, 0 otherwise, negative value on error
+ */
+int icm42688_autorange_process_fifo(icm42688_autorange_t *ar, const icm42688_data_t *raw, uint16_t count,
+                                    uint8_t packet_size, icm42688_ranged_sample_t *out);
+#endif
+#endif /* ICM42688_CFG_AUTORANGE */
+
+#endif // AUTORANGE_H
@@ -0,0 +1,125 @@
+/**
+ * @file bus_model.h
+ * @brief Bus timing model and capacity planner for ICM-42688 deployments
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Models the wire time of the transactions issued by i2c_read_wrapper() and
+ * spi_read_wrapper(): I2C memory reads (START, address+W, register, repeated
+ * START, address+R, data with ACK/NACK, STOP, bus free time) and SPI reads
+ * (CS setup, 1-byte register phase, data phase, CS hold). Fixed software cost
+ * per HAL call is modelled separately so the planner can answer both "does
+ * the wire carry it" and "does the blocking driver keep up".
+ *
+ * The planner sums the bus time of every device for a given read strategy
+ * and reports utilization, headroom and worst-case sample latency assuming
+ * non-preemptive transactions in arbitrary order.
+ */
+
+#ifndef BUS_MODEL_H
+#define BUS_MODEL_H
+
+#include <stdint.h>
+#include "icm42688_config.h"
+
+#define ICM42688_BUS_MAX_DEVICES 16 /**< Devices per planned bus */
+
+/**
+ * @brief Bus type
+ */
+typedef enum {
+    ICM42688_BUS_I2C = 0,
+    ICM42688_BUS_SPI
+} icm42688_bus_type_t;
+
+/**
+ * @brief Bus timing parameters
+ */
+typedef struct {
+    icm42688_bus_type_t type;  /**< Bus type */
+    uint32_t clock_hz;         /**< SCL / SCK frequency */
+    uint32_t frame_ns;         /**< I2C: bus free time before START (tBUF); SPI: CS setup + hold */
+    uint32_t byte_gap_ns;      /**< Idle time between bytes (clock stretching, FIFO refill) */
+    uint32_t call_ns;          /**< Software cost per HAL call (SPI read issues two calls) */
+} icm42688_bus_timing_t;
+
+/**
+ * @brief Read strategy
+ */
+typedef enum {
+    ICM42688_READ_PER_SAMPLE = 0,  /**< One register read per sample (icm42688_read_all) */
+    ICM42688_READ_FIFO_BURST       /**< INT_STATUS + FIFO_COUNT + one FIFO_DATA burst per watermark */
+} icm42688_read_strategy_t;
+
+/**
+ * @brief Device description for planning
+ */
+typedef struct {
+    uint32_t odr_hz;                   /**< Output data rate */
+    icm42688_read_strategy_t strategy; /**< Read strategy */
+    uint16_t sample_bytes;             /**< Bytes per sample (14 for read_all, 16 for FIFO packet 3) */
+    uint16_t watermark;                /**< FIFO burst: samples per read, below ICM42688_FIFO_SIZE / sample_bytes */
+} icm42688_bus_device_t;
+
+/**
+ * @brief Per-device planning result
+ */
+typedef struct {
+    uint32_t transaction_ns;  /**< Duration of one read cycle (all transactions) */
+    uint32_t reads_per_sec;   /**< Read cycles per second */
+    uint32_t bus_ns_per_sec;  /**< Bus occupancy per second */
+    uint32_t worst_latency_ns; /**< Sample ready to sample in RAM, worst case */
+    uint8_t keeps_up;         /**< Read cycle plus interference fits in the read interval */
+} icm42688_bus_device_plan_t;
+
+/**
+ * @brief Bus planning result
+ */
+typedef struct {
+    float utilization;        /**< Fraction of time the bus is busy */
+    float headroom;           /**< 1 - utilization */
+    uint32_t bytes_per_sec;   /**< Payload bytes per second */
+    uint8_t feasible;         /**< Utilization below 1 and every device keeps up */
+    icm42688_bus_device_plan_t device[ICM42688_BUS_MAX_DEVICES]; /**< Per-device results */
+} icm42688_bus_plan_t;
+
+#if ICM42688_CFG_BUS_MODEL
+/**
+ * @brief Fill typical timing for STM32 HAL blocking transfers
+ * @param t Pointer to timing
+ * @param type Bus type
+ * @param clock_hz Bus clock
+ * @return 0 on success, negative value on error
+ */
+int icm42688_bus_timing_default(icm42688_bus_timing_t *t, icm42688_bus_type_t type, uint32_t clock_hz);
+
+/**
+ * @brief Duration of one register read transaction
+ * @param t Pointer to timing
+ * @param len Data bytes
+ * @return Duration in nanoseconds
+ */
+uint32_t icm42688_bus_read_ns(const icm42688_bus_timing_t *t, uint16_t len);
+
+/**
+ * @brief Duration of one register write transaction
+ * @param t Pointer to timing
+ * @param len Data bytes
+ * @return Duration in nanoseconds
+ */
+uint32_t icm42688_bus_write_ns(const icm42688_bus_timing_t *t, uint16_t len);
+
+/**
+ * @brief Plan bus capacity for a set of devices
+ * @param t Pointer to timing
+ * @param devs Device descriptions
+ * @param count Number of devices (1..ICM42688_BUS_MAX_DEVICES)
+ * @param plan Pointer to result
+ * @return 0 on success, -1 on invalid parameters (including a FIFO watermark
+ *         that leaves no free packet in the FIFO)
+ */
+int icm42688_bus_plan(const icm42688_bus_timing_t *t, const icm42688_bus_device_t *devs, uint8_t count,
+                      icm42688_bus_plan_t *plan);
+#endif /* ICM42688_CFG_BUS_MODEL */
+
+#endif // BUS_MODEL_H
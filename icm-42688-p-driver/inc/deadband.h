@@ -0,0 +1,153 @@
+/**
+ * @file deadband.h
+ * @brief Send-on-delta sample reduction for bandwidth-limited links
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * The sender and the receiver run the same predictor, fed only with the
+ * samples that were actually sent. The sender forwards a sample when any
+ * channel differs from the prediction by more than its deadband, or when
+ * max_interval samples have passed (heartbeat). Everything in between is
+ * dropped; the receiver regenerates it from the predictor, so every rebuilt
+ * sample is within the deadband of the original.
+ *
+ * Predictors: ICM42688_PREDICT_HOLD repeats the last sent value (classic
+ * deadband), ICM42688_PREDICT_LINEAR extrapolates the slope between the last
+ * two sent samples. Linear suppresses far more samples during smooth motion
+ * as long as the per-sample noise is well below the deadband (filtered data);
+ * on raw wideband data the noise corrupts the slope and hold sends less.
+ *
+ * Each sent sample carries the number of samples skipped before it, its own
+ * timestamp and an 8-bit sequence number; skipped timestamps are
+ * interpolated. The link may lose samples or the receiver may join late: the
+ * sequence number tells the receiver that its predictor no longer matches
+ * the sender's, and it then passes received samples through without
+ * rebuilding the gaps until it is back in step. Hold is back in step with the
+ * next sample, linear one sample later, since the slope needs two
+ * consecutive sent samples (or the first sample of the stream). Losing a
+ * multiple of 256 samples in a row goes unnoticed. Processing is a fixed
+ * amount of work per sample (one division per sent sample, none otherwise).
+ */
+
+#ifndef DEADBAND_H
+#define DEADBAND_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_DEADBAND_CHANNELS 7  /**< accel x/y/z, gyro x/y/z, temp */
+
+#define ICM42688_EMIT_FIRST     0x01  /**< First sample after init */
+#define ICM42688_EMIT_DELTA     0x02  /**< Prediction error exceeded the deadband */
+#define ICM42688_EMIT_HEARTBEAT 0x04  /**< max_interval expired */
+
+/**
+ * @brief Predictor shared by sender and receiver
+ */
+typedef enum {
+    ICM42688_PREDICT_HOLD = 0,   /**< Zero order: last sent value */
+    ICM42688_PREDICT_LINEAR = 1  /**< First order: slope of the last two sent values */
+} icm42688_predict_t;
+
+/**
+ * @brief Reduction configuration
+ */
+typedef struct {
+    uint16_t accel_deadband;  /**< Allowed accel error in raw LSB */
+    uint16_t gyro_deadband;   /**< Allowed gyro error in raw LSB */
+    uint16_t temp_deadband;   /**< Allowed temperature error in raw LSB */
+    uint16_t max_interval;    /**< Send at least every max_interval samples (1..65535) */
+    icm42688_predict_t predict; /**< Predictor */
+} icm42688_deadband_config_t;
+
+/**
+ * @brief Sent sample with reconstruction tags
+ */
+typedef struct {
+    icm42688_sample_t sample; /**< Original sample */
+    uint16_t skipped;         /**< Samples dropped since the previous sent sample */
+    uint8_t reason;           /**< ICM42688_EMIT_* flags */
+    uint8_t seq;              /**< Sent-sample counter, wraps at 256 */
+} icm42688_reduced_sample_t;
+
+/**
+ * @brief Predictor state (identical on both ends of the link)
+ */
+typedef struct {
+    int32_t last[ICM42688_DEADBAND_CHANNELS];  /**< Last sent values */
+    int32_t slope[ICM42688_DEADBAND_CHANNELS]; /**< Per-sample slope, Q16 */
+    uint32_t last_ts;                          /**< Timestamp of last sent sample */
+    uint8_t predict;                           /**< icm42688_predict_t */
+    uint8_t valid;                             /**< A sample has been sent */
+    uint8_t seq;                               /**< Sequence number of the next sent sample */
+    uint8_t synced;                            /**< Receiver only: slope matches the sender's */
+} icm42688_deadband_model_t;
+
+/**
+ * @brief Reduction statistics
+ */
+typedef struct {
+    uint32_t in;          /**< Samples processed */
+    uint32_t out;         /**< Samples sent */
+    uint32_t heartbeats;  /**< Samples sent only because of the heartbeat */
+} icm42688_deadband_stats_t;
+
+/**
+ * @brief Sender state
+ */
+typedef struct {
+    icm42688_deadband_config_t cfg;          /**< Configuration */
+    int32_t band[ICM42688_DEADBAND_CHANNELS]; /**< Deadband per channel */
+    icm42688_deadband_model_t model;         /**< Predictor */
+    uint32_t since;                          /**< Samples since the last sent one */
+    icm42688_deadband_stats_t stats;         /**< Statistics */
+} icm42688_deadband_t;
+
+#if ICM42688_CFG_DEADBAND
+/**
+ * @brief Fill configuration with defaults (about 0.01 g / 0.1 dps at the finest ranges, hold, 1 s at 1 kHz)
+ * @param cfg Pointer to configuration
+ */
+void icm42688_deadband_config_default(icm42688_deadband_config_t *cfg);
+
+/**
+ * @brief Initialize sender
+ * @param db Pointer to sender
+ * @param cfg Configuration (NULL for defaults)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_deadband_init(icm42688_deadband_t *db, const icm42688_deadband_config_t *cfg);
+
+/**
+ * @brief Process one sample
+ * @param db Pointer to sender
+ * @param in Input sample
+ * @param out Pointer to sent sample (written only when the return value is 1)
+ * @return 1 if the sample must be sent, 0 if it was dropped, negative value on error
+ */
+int icm42688_deadband_process(icm42688_deadband_t *db, const icm42688_sample_t *in,
+                              icm42688_reduced_sample_t *out);
+
+/**
+ * @brief Initialize receiver predictor
+ * @param model Pointer to predictor
+ * @param predict Predictor used by the sender
+ */
+void icm42688_deadband_model_init(icm42688_deadband_model_t *model, icm42688_predict_t predict);
+
+/**
+ * @brief Rebuild the samples covered by one received sample
+ * @param model Pointer to receiver predictor
+ * @param in Received sample
+ * @param out Output array, in->skipped predicted samples followed by the received one
+ * @param max_out Capacity of output array
+ * @return Number of samples written, negative value on error. Normally
+ *         in->skipped + 1; only the received sample (1) when the skipped ones
+ *         cannot be rebuilt: for the first sample this receiver sees, after a
+ *         lost sample, and with the linear predictor for the sample after those.
+ */
+int icm42688_deadband_expand(icm42688_deadband_model_t *model, const icm42688_reduced_sample_t *in,
+                             icm42688_sample_t *out, uint32_t max_out);
+#endif /* ICM42688_CFG_DEADBAND */
+
+#endif // DEADBAND_H
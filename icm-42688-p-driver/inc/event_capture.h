@@ -0,0 +1,119 @@
+/**
+ * @file event_capture.h
+ * @brief Triggered pre/post-event capture of ICM-42688 samples
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Records the samples around shock and impact events at full ODR instead of
+ * logging continuously. Every sample is written into a circular pre-trigger
+ * window and checked against an accelerometer threshold and a jerk (sample to
+ * sample difference) threshold. When a trigger fires, the pre-trigger window
+ * is copied into a free capture slot and the following post-trigger samples
+ * are written straight into that slot. Several slots allow back-to-back events
+ * to be recorded while the application is still reading out earlier ones.
+ *
+ * All storage lives inside icm42688_capture_t; sizes are set at compile time.
+ * The per-sample trigger check is a few integer compares with no branches
+ * taken in the common case.
+ */
+
+#ifndef EVENT_CAPTURE_H
+#define EVENT_CAPTURE_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#ifndef ICM42688_CAPTURE_PRE
+#define ICM42688_CAPTURE_PRE   256  /**< Samples kept before the trigger */
+#endif
+
+#ifndef ICM42688_CAPTURE_POST
+#define ICM42688_CAPTURE_POST  256  /**< Samples recorded after the trigger (including it) */
+#endif
+
+#ifndef ICM42688_CAPTURE_SLOTS
+#define ICM42688_CAPTURE_SLOTS 4    /**< Capture slots */
+#endif
+
+#define ICM42688_CAPTURE_LEN (ICM42688_CAPTURE_PRE + ICM42688_CAPTURE_POST)
+
+/**
+ * @brief Capture slot state
+ */
+typedef enum {
+    ICM42688_CAPTURE_FREE = 0,  /**< Available for a new event */
+    ICM42688_CAPTURE_FILLING,   /**< Recording post-trigger samples */
+    ICM42688_CAPTURE_READY      /**< Complete, waiting to be read out */
+} icm42688_capture_state_t;
+
+/**
+ * @brief Capture slot
+ */
+typedef struct {
+    icm42688_sample_t samples[ICM42688_CAPTURE_LEN]; /**< Pre-trigger samples followed by post-trigger samples */
+    uint16_t count;                                  /**< Valid samples */
+    uint16_t trigger_index;                          /**< Index of the triggering sample in samples[] */
+    uint32_t sequence;                               /**< Event number */
+    volatile uint8_t state;                          /**< icm42688_capture_state_t */
+} icm42688_capture_slot_t;
+
+/**
+ * @brief Capture statistics
+ */
+typedef struct {
+    uint32_t samples;    /**< Samples pushed */
+    uint32_t triggers;   /**< Triggers that started a capture */
+    uint32_t dropped;    /**< Trigger events (rising edges) lost because every slot was busy */
+} icm42688_capture_stats_t;
+
+/**
+ * @brief Capture engine
+ */
+typedef struct {
+    icm42688_sample_t pre[ICM42688_CAPTURE_PRE];      /**< Circular pre-trigger window */
+    icm42688_capture_slot_t slot[ICM42688_CAPTURE_SLOTS]; /**< Capture slots */
+    uint16_t pre_pos;                                 /**< Next write index in pre[] */
+    uint16_t pre_count;                               /**< Valid samples in pre[] */
+    int8_t active;                                    /**< Slot being filled, -1 if none */
+    int16_t last[3];                                  /**< Previous accelerometer sample */
+    uint8_t hit_prev;                                 /**< Trigger condition held on the previous sample */
+    int32_t accel_thresh;                             /**< Per-axis |accel| threshold in LSB, 0 disables */
+    int32_t jerk_thresh;                              /**< Per-axis |delta accel| threshold in LSB, 0 disables */
+    icm42688_capture_stats_t stats;                   /**< Statistics */
+} icm42688_capture_t;
+
+#if ICM42688_CFG_EVENT_CAPTURE
+/**
+ * @brief Initialize capture engine
+ * @param cap Pointer to capture engine
+ * @param accel_thresh Per-axis absolute accelerometer threshold in LSB (0 disables)
+ * @param jerk_thresh Per-axis sample-to-sample accelerometer change threshold in LSB (0 disables)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_capture_init(icm42688_capture_t *cap, int32_t accel_thresh, int32_t jerk_thresh);
+
+/**
+ * @brief Push one sample through the trigger and capture buffers
+ * @param cap Pointer to capture engine
+ * @param s Sample
+ * @return 1 if a capture completed with this sample, 0 otherwise, negative value on error
+ */
+int icm42688_capture_push(icm42688_capture_t *cap, const icm42688_sample_t *s);
+
+/**
+ * @brief Get the oldest completed capture
+ * @param cap Pointer to capture engine
+ * @return Pointer to a READY slot, or NULL if none is ready
+ */
+const icm42688_capture_slot_t *icm42688_capture_get(const icm42688_capture_t *cap);
+
+/**
+ * @brief Return a slot obtained from icm42688_capture_get to the engine
+ * @param cap Pointer to capture engine
+ * @param slot Slot to release
+ * @return 0 on success, negative value on error
+ */
+int icm42688_capture_release(icm42688_capture_t *cap, const icm42688_capture_slot_t *slot);
+#endif /* ICM42688_CFG_EVENT_CAPTURE */
+
+#endif // EVENT_CAPTURE_H
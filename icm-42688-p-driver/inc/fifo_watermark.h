@@ -0,0 +1,114 @@
+/**
+ * @file fifo_watermark.h
+ * @brief Adaptive FIFO watermark controller for ICM-42688
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Tunes FIFO_CONFIG2/FIFO_CONFIG3 at runtime so that the oldest sample in a
+ * FIFO read never exceeds the latency budget, while keeping the watermark as
+ * high as possible to reduce interrupt rate and bus transactions. The
+ * observed consumer drain time also bounds the watermark from above so the
+ * FIFO does not overflow while the consumer is busy.
+ */
+
+#ifndef FIFO_WATERMARK_H
+#define FIFO_WATERMARK_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#ifndef ICM42688_FIFO_WM_HOLD_US
+#define ICM42688_FIFO_WM_HOLD_US 1000000u  /**< Drain time peak is held this long before it decays */
+#endif
+
+/**
+ * @brief Controller configuration
+ */
+typedef struct {
+    uint32_t odr_hz;            /**< Output data rate in Hz */
+    uint32_t latency_budget_us; /**< Maximum age of the oldest sample when it is consumed */
+    uint16_t packet_size;       /**< FIFO packet size in bytes (e.g. ICM42688_FIFO_PACKET3_SIZE) */
+    uint16_t min_packets;       /**< Lower bound for watermark in packets (0 = 1) */
+    uint16_t hysteresis;        /**< Minimum change in packets before reprogramming (0 = 1) */
+} icm42688_fifo_wm_config_t;
+
+/**
+ * @brief Controller statistics
+ */
+typedef struct {
+    uint32_t overflows;          /**< FIFO full events seen in INT_STATUS */
+    uint32_t interrupts;         /**< Watermark interrupts reported by caller */
+    uint32_t reads;              /**< FIFO burst reads performed */
+    uint32_t bytes_read;         /**< Total FIFO bytes read */
+    uint32_t reprograms;         /**< Watermark register writes */
+    uint32_t interrupts_per_sec; /**< Interrupt rate over last completed 1 s window */
+    uint16_t bytes_per_read;     /**< Average FIFO bytes per burst read */
+} icm42688_fifo_wm_stats_t;
+
+/**
+ * @brief Controller state
+ */
+typedef struct {
+    icm42688_t *dev;                  /**< Sensor the watermark is programmed on */
+    icm42688_fifo_wm_config_t cfg;    /**< Configuration */
+    uint16_t watermark;               /**< Currently programmed watermark in packets */
+    uint16_t capacity;                /**< FIFO capacity in packets */
+    uint32_t period_us;               /**< Sample period in microseconds */
+    uint32_t drain_us;                /**< Smoothed consumer drain time (fast attack, held, slow decay) */
+    uint32_t quiet_us;                /**< Time since drain_us last rose, up to ICM42688_FIFO_WM_HOLD_US */
+    uint32_t window_start_us;         /**< Start of current interrupt rate window */
+    uint32_t window_irqs;             /**< Interrupts in current window */
+    uint8_t window_valid;             /**< Window start has been initialized */
+    uint8_t overflow_pending;         /**< Overflow seen since last update */
+    icm42688_fifo_wm_stats_t stats;   /**< Statistics */
+} icm42688_fifo_wm_t;
+
+#if ICM42688_CFG_FIFO_WATERMARK
+/**
+ * @brief Initialize controller and program the initial watermark
+ * @param ctl Pointer to controller
+ * @param dev Pointer to sensor context (FIFO already enabled)
+ * @param cfg Pointer to configuration
+ * @return 0 on success, negative value on error
+ */
+int icm42688_fifo_wm_init(icm42688_fifo_wm_t *ctl, icm42688_t *dev,
+                          const icm42688_fifo_wm_config_t *cfg);
+
+/**
+ * @brief Record a watermark interrupt (call from INT1 handler)
+ * @param ctl Pointer to controller
+ * @param now_us Current time in microseconds (free running, may wrap)
+ */
+void icm42688_fifo_wm_on_interrupt(icm42688_fifo_wm_t *ctl, uint32_t now_us);
+
+/**
+ * @brief Check overflow status and burst read all complete packets from FIFO
+ * @param ctl Pointer to controller
+ * @param buf Destination buffer
+ * @param size Size of destination buffer in bytes
+ * @param bytes Pointer to number of bytes read
+ * @param int_status Pointer to INT_STATUS as read (NULL if not needed); the
+ *        register clears on read, so other flags in it are lost otherwise
+ * @return 0 on success, negative value on error
+ */
+int icm42688_fifo_wm_drain(icm42688_fifo_wm_t *ctl, uint8_t *buf, uint16_t size, uint16_t *bytes,
+                           uint8_t *int_status);
+
+/**
+ * @brief Feed the observed consumer drain time and retune the watermark
+ * @param ctl Pointer to controller
+ * @param drain_us Time from watermark interrupt until the batch was consumed
+ * @return 1 if watermark was reprogrammed, 0 if unchanged, negative value on error
+ */
+int icm42688_fifo_wm_update(icm42688_fifo_wm_t *ctl, uint32_t drain_us);
+
+/**
+ * @brief Compute the watermark the controller would choose for a drain time
+ * @param ctl Pointer to controller
+ * @param drain_us Consumer drain time in microseconds
+ * @return Watermark in packets
+ */
+uint16_t icm42688_fifo_wm_target(const icm42688_fifo_wm_t *ctl, uint32_t drain_us);
+#endif /* ICM42688_CFG_FIFO_WATERMARK */
+
+#endif // FIFO_WATERMARK_H
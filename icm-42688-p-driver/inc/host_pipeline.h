@@ -0,0 +1,158 @@
+/**
+ * @file host_pipeline.h
+ * @brief Multi-threaded host pipeline for processing many ICM-42688 streams (Linux)
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Each stream owns an ordered list of stages (decode, calibration, filtering,
+ * fusion, ...) and a bounded queue of sample batches. Streams with pending
+ * batches are scheduled on per-worker deques; idle workers steal streams from
+ * busy ones. A stream is owned by at most one worker at a time, so batches of
+ * one stream are always processed in submission order while different streams
+ * run in parallel. A full stream queue blocks (or rejects) the producer.
+ */
+
+#ifndef HOST_PIPELINE_H
+#define HOST_PIPELINE_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "icm-42688.h"
+
+#define ICM42688_PIPELINE_MAX_WORKERS  64   /**< Maximum worker threads */
+#define ICM42688_PIPELINE_MAX_STREAMS  256  /**< Maximum registered streams */
+#define ICM42688_PIPELINE_MAX_STAGES   8    /**< Maximum stages per stream */
+#define ICM42688_PIPELINE_QUEUE_DEPTH  8    /**< Batches buffered per stream (power of 2) */
+#define ICM42688_PIPELINE_BATCH_SIZE   64   /**< Samples per batch */
+#define ICM42688_PIPELINE_BATCH_QUANTUM 4   /**< Batches processed before a stream is requeued */
+
+/**
+ * @brief Stage function, processes a batch in place
+ * @param ctx Stage private context
+ * @param stream_id Stream identifier
+ * @param samples Samples of the batch
+ * @param count Number of samples
+ * @return 0 on success, negative value on error (counted, batch continues to next stage)
+ */
+typedef int (*icm42688_stage_fn_t)(void *ctx, uint32_t stream_id, icm42688_data_t *samples, uint16_t count);
+
+/**
+ * @brief Pipeline stage
+ */
+typedef struct {
+    icm42688_stage_fn_t fn; /**< Stage function */
+    void *ctx;              /**< Stage private context */
+} icm42688_stage_t;
+
+/**
+ * @brief Batch of samples
+ */
+typedef struct {
+    icm42688_data_t samples[ICM42688_PIPELINE_BATCH_SIZE]; /**< Sample storage */
+    uint16_t count;                                        /**< Valid samples */
+} icm42688_batch_t;
+
+/**
+ * @brief Stream context (caller allocated, registered with icm42688_pipeline_add_stream)
+ */
+typedef struct {
+    uint32_t id;                                             /**< Stream identifier */
+    icm42688_stage_t stages[ICM42688_PIPELINE_MAX_STAGES];   /**< Stage list */
+    uint8_t num_stages;                                      /**< Number of stages */
+    icm42688_batch_t queue[ICM42688_PIPELINE_QUEUE_DEPTH];   /**< Bounded batch queue */
+    uint32_t head;                                           /**< Next batch to process */
+    uint32_t tail;                                           /**< Next batch to fill */
+    uint8_t scheduled;                                       /**< Queued on a deque or being processed */
+    uint16_t home;                                           /**< Preferred worker */
+    pthread_mutex_t lock;                                    /**< Protects queue indices and scheduled flag */
+    pthread_cond_t not_full;                                 /**< Signalled when a batch slot frees up */
+    uint64_t batches;                                        /**< Batches processed */
+    uint64_t samples;                                        /**< Samples processed */
+    uint64_t errors;                                         /**< Stage errors */
+} icm42688_stream_t;
+
+/**
+ * @brief Per-worker deque of runnable streams
+ */
+typedef struct {
+    icm42688_stream_t *items[ICM42688_PIPELINE_MAX_STREAMS]; /**< Ring storage */
+    uint32_t top;                                            /**< Steal end */
+    uint32_t bottom;                                         /**< Owner end */
+    pthread_mutex_t lock;                                    /**< Deque lock */
+} icm42688_deque_t;
+
+struct icm42688_pipeline;
+
+/**
+ * @brief Worker thread context
+ */
+typedef struct {
+    struct icm42688_pipeline *pipeline; /**< Owning pipeline */
+    uint16_t index;                     /**< Worker index */
+    pthread_t thread;                   /**< Thread handle */
+    uint64_t steals;                    /**< Streams stolen from other workers */
+} icm42688_worker_t;
+
+/**
+ * @brief Pipeline runtime
+ */
+typedef struct icm42688_pipeline {
+    icm42688_worker_t workers[ICM42688_PIPELINE_MAX_WORKERS]; /**< Workers */
+    icm42688_deque_t deques[ICM42688_PIPELINE_MAX_WORKERS];   /**< Per-worker deques */
+    uint16_t num_workers;                                     /**< Running workers */
+    uint16_t num_streams;                                     /**< Registered streams */
+    uint32_t runnable;                                        /**< Streams sitting on deques */
+    uint32_t inflight;                                        /**< Queued or running batches */
+    uint8_t stop;                                             /**< Shutdown request */
+    pthread_mutex_t lock;                                     /**< Protects sleep/wake state */
+    pthread_cond_t work;                                      /**< Signalled when a stream becomes runnable */
+    pthread_cond_t idle;                                      /**< Signalled when inflight drops to zero */
+} icm42688_pipeline_t;
+
+/**
+ * @brief Initialize pipeline and start worker threads
+ * @param p Pointer to pipeline
+ * @param num_workers Number of worker threads (1..ICM42688_PIPELINE_MAX_WORKERS)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_pipeline_init(icm42688_pipeline_t *p, uint16_t num_workers);
+
+/**
+ * @brief Initialize a stream and register it with the pipeline
+ * @param p Pointer to pipeline
+ * @param s Pointer to stream
+ * @param id Stream identifier passed to stages
+ * @param stages Stage list
+ * @param num_stages Number of stages
+ * @return 0 on success, negative value on error
+ */
+int icm42688_pipeline_add_stream(icm42688_pipeline_t *p, icm42688_stream_t *s, uint32_t id,
+                                 const icm42688_stage_t *stages, uint8_t num_stages);
+
+/**
+ * @brief Submit samples to a stream
+ * @param p Pointer to pipeline
+ * @param s Pointer to stream
+ * @param samples Samples to copy into the stream queue
+ * @param count Number of samples (split into batches as needed)
+ * @param block Nonzero to wait for queue space, zero to fail when full
+ * @return Number of samples accepted, negative value on error
+ */
+int icm42688_pipeline_submit(icm42688_pipeline_t *p, icm42688_stream_t *s,
+                             const icm42688_data_t *samples, uint32_t count, int block);
+
+/**
+ * @brief Wait until every submitted batch has passed through all stages
+ * @param p Pointer to pipeline
+ * @return 0 on success, negative value on error
+ */
+int icm42688_pipeline_drain(icm42688_pipeline_t *p);
+
+/**
+ * @brief Drain, stop and join worker threads
+ * @param p Pointer to pipeline
+ * @return 0 on success, negative value on error
+ */
+int icm42688_pipeline_shutdown(icm42688_pipeline_t *p);
+
+#endif // HOST_PIPELINE_H
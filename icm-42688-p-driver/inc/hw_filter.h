@@ -0,0 +1,128 @@
+/**
+ * @file hw_filter.h
+ * @brief On-sensor filter configuration for ICM-42688 (UI filter, anti-alias filter, gyro notch)
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Moves filtering from the MCU into the sensor's signal path:
+ *
+ *  - UI filter: order (1st-3rd) and bandwidth as a fraction of ODR, per sensor
+ *    (GYRO_CONFIG1, ACCEL_CONFIG1, GYRO_ACCEL_CONFIG0, bank 0).
+ *  - Anti-alias filter: 2nd-order low pass ahead of decimation, set by
+ *    DELT/DELTSQR/BITSHIFT (gyro in bank 1, accel in bank 2). The values come
+ *    from the datasheet table (DELT 1..63, 42 Hz..3979 Hz).
+ *  - Gyro notch: per-axis center frequency 1-3 kHz (COSWZ, COSWZ_SEL) and a
+ *    shared bandwidth (NF_BW_SEL) in bank 1. cos(2*pi*f/32 kHz) is evaluated
+ *    as a Q30 integer series, accurate enough that COSWZ matches the
+ *    datasheet formula (rounded cosine) exactly; nothing calls libm.
+ *
+ * icm42688_configure_filters() programs everything in one pass: bank 0
+ * registers, then one burst read-modify-write of bank 1 and bank 2, then back
+ * to bank 0.
+ */
+
+#ifndef HW_FILTER_H
+#define HW_FILTER_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_AAF_DELT_MAX   63    /**< Largest AAF DELT */
+#define ICM42688_NOTCH_MIN_HZ   1000  /**< Lowest notch center frequency */
+#define ICM42688_NOTCH_MAX_HZ   3000  /**< Highest notch center frequency */
+
+/**
+ * @brief UI filter order
+ */
+typedef enum {
+    ICM42688_UI_FILT_ORD_1 = 0,  /**< 1st order */
+    ICM42688_UI_FILT_ORD_2 = 1,  /**< 2nd order */
+    ICM42688_UI_FILT_ORD_3 = 2   /**< 3rd order */
+} icm42688_ui_filt_ord_t;
+
+/**
+ * @brief UI filter bandwidth (low-noise mode)
+ */
+typedef enum {
+    ICM42688_UI_FILT_BW_ODR_2 = 0,    /**< ODR / 2 */
+    ICM42688_UI_FILT_BW_ODR_4 = 1,    /**< max(400 Hz, ODR) / 4 (default) */
+    ICM42688_UI_FILT_BW_ODR_5 = 2,    /**< max(400 Hz, ODR) / 5 */
+    ICM42688_UI_FILT_BW_ODR_8 = 3,    /**< max(400 Hz, ODR) / 8 */
+    ICM42688_UI_FILT_BW_ODR_10 = 4,   /**< max(400 Hz, ODR) / 10 */
+    ICM42688_UI_FILT_BW_ODR_16 = 5,   /**< max(400 Hz, ODR) / 16 */
+    ICM42688_UI_FILT_BW_ODR_20 = 6,   /**< max(400 Hz, ODR) / 20 */
+    ICM42688_UI_FILT_BW_ODR_40 = 7,   /**< max(400 Hz, ODR) / 40 */
+    ICM42688_UI_FILT_BW_LL_DEC2 = 14, /**< Low latency, dec2 at max(400 Hz, ODR) */
+    ICM42688_UI_FILT_BW_LL_8ODR = 15  /**< Low latency, dec2 at max(200 Hz, 8 * ODR) */
+} icm42688_ui_filt_bw_t;
+
+/**
+ * @brief Anti-alias filter register values
+ */
+typedef struct {
+    uint8_t delt;       /**< AAF_DELT (1..63) */
+    uint16_t deltsqr;   /**< AAF_DELTSQR (12 bits) */
+    uint8_t bitshift;   /**< AAF_BITSHIFT (4 bits) */
+    uint16_t bw_hz;     /**< Resulting 3 dB bandwidth */
+} icm42688_aaf_t;
+
+/**
+ * @brief Gyro notch filter register values
+ */
+typedef struct {
+    uint16_t coswz[3];   /**< NF_COSWZ per axis (9-bit two's complement) */
+    uint8_t coswz_sel[3];/**< NF_COSWZ_SEL per axis */
+    uint8_t bw_sel;      /**< NF_BW_SEL (0..7) */
+    uint16_t bw_hz;      /**< Resulting notch bandwidth */
+} icm42688_notch_t;
+
+/**
+ * @brief Complete on-sensor filter configuration
+ */
+typedef struct {
+    uint8_t gyro_ui_order;     /**< icm42688_ui_filt_ord_t */
+    uint8_t gyro_ui_bw;        /**< icm42688_ui_filt_bw_t */
+    uint8_t accel_ui_order;    /**< icm42688_ui_filt_ord_t */
+    uint8_t accel_ui_bw;       /**< icm42688_ui_filt_bw_t */
+    uint8_t gyro_aaf_enable;   /**< Enable gyro anti-alias filter */
+    icm42688_aaf_t gyro_aaf;   /**< Gyro AAF values (from icm42688_aaf_compute) */
+    uint8_t accel_aaf_enable;  /**< Enable accel anti-alias filter */
+    icm42688_aaf_t accel_aaf;  /**< Accel AAF values (from icm42688_aaf_compute) */
+    uint8_t notch_enable;      /**< Enable gyro notch filter */
+    icm42688_notch_t notch;    /**< Notch values (from icm42688_notch_compute) */
+} icm42688_filter_config_t;
+
+#if ICM42688_CFG_HW_FILTER
+/**
+ * @brief Look up anti-alias filter values for the bandwidth closest to the request
+ * @param bw_hz Desired 3 dB bandwidth in Hz (42..3979)
+ * @param aaf Pointer to result
+ * @return 0 on success, negative value on error
+ */
+int icm42688_aaf_compute(uint16_t bw_hz, icm42688_aaf_t *aaf);
+
+/**
+ * @brief Compute gyro notch values
+ * @param freq_hz Center frequency per axis (x, y, z) in Hz, 1000..3000
+ * @param bw_hz Desired notch bandwidth in Hz (closest of 10..1449 is used)
+ * @param notch Pointer to result
+ * @return 0 on success, negative value on error
+ */
+int icm42688_notch_compute(const uint16_t freq_hz[3], uint16_t bw_hz, icm42688_notch_t *notch);
+
+/**
+ * @brief Fill a configuration with the sensor reset defaults
+ * @param cfg Pointer to configuration
+ */
+void icm42688_filter_config_default(icm42688_filter_config_t *cfg);
+
+/**
+ * @brief Program UI, anti-alias and notch filters in one pass
+ * @param dev Pointer to sensor context
+ * @param cfg Pointer to configuration
+ * @return 0 on success, negative value on error (bank is left at 0 whenever the bus allows)
+ */
+int icm42688_configure_filters(icm42688_t *dev, const icm42688_filter_config_t *cfg);
+#endif /* ICM42688_CFG_HW_FILTER */
+
+#endif // HW_FILTER_H
@@ -0,0 +1,178 @@
+/**
+ * @file i2c_async.h
+ * @brief Non-blocking I2C transaction queue with fair shared-bus arbitration
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Transactions are described by caller-owned i2c_async_txn_t structures and
+ * queued per client (for example: IMU, barometer, EEPROM). The bus runs one
+ * transaction at a time through a start hook, typically an interrupt or DMA
+ * based HAL_I2C_Mem_Read/Write call, and the completion interrupt calls
+ * i2c_async_complete(), which reports the result to the transaction's callback
+ * and starts the next one.
+ *
+ * Arbitration is round-robin across clients, FIFO within a client: once a
+ * client has queued a transaction, at most (clients - 1) transactions of other
+ * clients run before it. A burst FIFO read is a single transaction of two
+ * transfers (FIFO count, then exactly the whole packets it reports); the bus
+ * stays with it in between, so no other client cuts in.
+ *
+ * Callbacks run with interrupts enabled, after the next transfer has been
+ * started, so they may submit new transactions.
+ *
+ * The queue core has no HAL dependency; the STM32 bindings live in
+ * i2c_driver.c. No memory is allocated; transactions must stay valid until
+ * their callback has run, and plain transactions must be zero-initialized
+ * (or have stage = 0) so they are not mistaken for a burst FIFO read.
+ */
+
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include <stdint.h>
+#include "icm42688_config.h"
+
+#ifndef I2C_ASYNC_MAX_CLIENTS
+#define I2C_ASYNC_MAX_CLIENTS 4  /**< Clients sharing one bus */
+#endif
+
+typedef struct i2c_async_txn i2c_async_txn_t;
+
+/**
+ * @brief Completion callback, called from the completion interrupt (or from
+ *        i2c_async_submit if the transfer could not be started), outside the
+ *        queue's critical section
+ * @param txn Finished transaction
+ * @param status 0 on success, negative value on bus error
+ */
+typedef void (*i2c_async_done_t)(i2c_async_txn_t *txn, int status);
+
+/**
+ * @brief Start hook: begin a transfer and return immediately
+ * @param ctx Hook context (e.g. HAL handle)
+ * @param txn Transaction to start
+ * @return 0 if the transfer was started, negative value on error
+ */
+typedef int (*i2c_async_start_t)(void *ctx, const i2c_async_txn_t *txn);
+
+/**
+ * @brief Abort hook: stop the transfer on the bus at once (called with interrupts masked)
+ * @param ctx Hook context (e.g. HAL handle)
+ * @param txn Transaction being cancelled
+ */
+typedef void (*i2c_async_abort_t)(void *ctx, const i2c_async_txn_t *txn);
+
+/**
+ * @brief Transaction
+ */
+struct i2c_async_txn {
+    uint8_t device_addr;       /**< 8-bit (shifted) device address */
+    uint8_t reg;               /**< Register address */
+    uint8_t write;             /**< 1 for register write, 0 for read */
+    uint8_t client;            /**< Client index (0..I2C_ASYNC_MAX_CLIENTS-1) */
+    uint8_t *data;             /**< Data buffer */
+    uint16_t len;              /**< Data length */
+    i2c_async_done_t done;     /**< Completion callback (may be NULL) */
+    void *user;                /**< User context */
+    i2c_async_txn_t *next;     /**< Queue link (internal) */
+    uint16_t capacity;         /**< Burst FIFO read: buffer size (internal) */
+    uint8_t packet_size;       /**< Burst FIFO read: FIFO packet size (internal) */
+    uint8_t stage;             /**< Burst FIFO read: transfer stage, 0 for plain transactions (internal) */
+};
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t submitted;        /**< Transactions submitted */
+    uint32_t completed;        /**< Transactions completed successfully */
+    uint32_t errors;           /**< Transactions that failed to start or complete */
+    uint8_t max_pending;       /**< Highest number of queued transactions seen */
+} i2c_async_stats_t;
+
+/**
+ * @brief Shared bus
+ */
+typedef struct {
+    i2c_async_start_t start;                       /**< Start hook */
+    void *ctx;                                     /**< Start hook context */
+    i2c_async_txn_t *head[I2C_ASYNC_MAX_CLIENTS];  /**< Per-client queue heads */
+    i2c_async_txn_t *tail[I2C_ASYNC_MAX_CLIENTS];  /**< Per-client queue tails */
+    i2c_async_txn_t *volatile active;              /**< Transaction on the bus */
+    uint8_t turn;                                  /**< Next client to consider */
+    uint8_t pending;                               /**< Queued transactions, excluding active */
+    i2c_async_stats_t stats;                       /**< Statistics */
+} i2c_async_bus_t;
+
+#if ICM42688_CFG_I2C_ASYNC
+/**
+ * @brief Initialize bus
+ * @param bus Pointer to bus
+ * @param start Start hook
+ * @param ctx Start hook context
+ * @return 0 on success, negative value on error
+ */
+int i2c_async_init(i2c_async_bus_t *bus, i2c_async_start_t start, void *ctx);
+
+/**
+ * @brief Queue a transaction; starts it at once if the bus is idle
+ * @param bus Pointer to bus
+ * @param txn Transaction (device_addr, reg, write, client, data, len, done filled in)
+ * @return 0 on success, negative value on error
+ */
+int i2c_async_submit(i2c_async_bus_t *bus, i2c_async_txn_t *txn);
+
+/**
+ * @brief Report completion of the active transfer (call from the completion interrupt)
+ * @param bus Pointer to bus
+ * @param status 0 on success, negative value on bus error
+ */
+void i2c_async_complete(i2c_async_bus_t *bus, int status);
+
+/**
+ * @brief Withdraw a transaction that has not completed, e.g. after a timeout
+ *
+ * A queued transaction is unlinked. If it is on the bus, abort() stops the
+ * transfer and the next queued transaction is started. The completion
+ * callback of the cancelled transaction is not called, and a late completion
+ * interrupt of the aborted transfer must not reach i2c_async_complete().
+ *
+ * @param bus Pointer to bus
+ * @param txn Transaction to cancel
+ * @param abort Abort hook for an active transfer (may be NULL)
+ * @return 0 on success, negative value on error (-3 if the transaction is neither queued nor active)
+ */
+int i2c_async_cancel(i2c_async_bus_t *bus, i2c_async_txn_t *txn, i2c_async_abort_t abort);
+
+/**
+ * @brief Check whether the bus has no active or queued transactions
+ * @param bus Pointer to bus
+ * @return 1 if idle, 0 otherwise
+ */
+int i2c_async_idle(const i2c_async_bus_t *bus);
+
+/**
+ * @brief Prepare a burst FIFO read of an ICM-42688 as one transaction
+ *
+ * Reads FIFO_COUNTH/FIFO_COUNTL (byte count, big-endian, sensor default) and
+ * then, from the completion interrupt, exactly the whole packets that fit in
+ * the buffer, so no partial packet is popped from the sensor FIFO. When the
+ * callback runs, buf[0..1] hold the reported count, the packets start at
+ * buf[2] and txn->len is 2 + the number of packet bytes read (2 if the FIFO
+ * held no whole packet, 0 on error).
+ *
+ * @param txn Transaction to fill in
+ * @param device_addr 8-bit (shifted) device address
+ * @param client Client index
+ * @param packet_size FIFO packet size (e.g. ICM42688_FIFO_PACKET3_SIZE)
+ * @param buf Buffer of 2 + at least one packet
+ * @param len Buffer length
+ * @param done Completion callback
+ * @param user User context
+ * @return 0 on success, negative value on error
+ */
+int i2c_async_fifo_burst(i2c_async_txn_t *txn, uint8_t device_addr, uint8_t client, uint8_t packet_size,
+                         uint8_t *buf, uint16_t len, i2c_async_done_t done, void *user);
+#endif /* ICM42688_CFG_I2C_ASYNC */
+
+#endif // I2C_ASYNC_H
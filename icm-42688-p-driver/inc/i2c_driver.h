@@ -9,6 +9,15 @@
 #define I2C_DRIVER_H
 
 #include <stdint.h>
+#include "i2c_async.h"
+
+#ifndef I2C_DRIVER_TIMEOUT_MS
+#define I2C_DRIVER_TIMEOUT_MS 1000 /**< Timeout of a blocking transfer */
+#endif
+
+#ifndef I2C_DRIVER_BLOCKING_CLIENT
+#define I2C_DRIVER_BLOCKING_CLIENT (I2C_ASYNC_MAX_CLIENTS - 1) /**< Queue client of blocking transfers on an async port */
+#endif
 
 /**
  * @brief I2C read callback function type
@@ -29,6 +38,7 @@ typedef struct {
     i2c_write_callback_t write_callback; /**< Write callback function */
 } i2c_driver_t;
 
+#if ICM42688_CFG_I2C
 /**
  * @brief Default wrapper functions for STM32 HAL
  */
@@ -60,4 +70,45 @@ int i2c_driver_init_i2c1(uint8_t device_addr);
  */
 int i2c_driver_init_i2c2(uint8_t device_addr);
 
+#if ICM42688_CFG_I2C_ASYNC
+/**
+ * @brief Initialize non-blocking transport on I2C1
+ *
+ * From then on the blocking callbacks of this port (i2c_read_wrapper,
+ * i2c_write_wrapper and so icm42688_read_all) queue their transfers as client
+ * I2C_DRIVER_BLOCKING_CLIENT and spin until they complete, so they never
+ * collide with a transfer in flight. After I2C_DRIVER_TIMEOUT_MS without a
+ * completion they are cancelled (the peripheral is reset if the transfer was
+ * on the bus) and return -2. Do not call them from interrupt context or from
+ * a completion callback once the transport is active.
+ *
+ * @param bus Pointer to bus (must stay valid while in use)
+ * @param use_dma 1 for DMA transfers, 0 for interrupt transfers
+ * @return 0 on success, negative value on error
+ */
+int i2c_driver_async_init_i2c1(i2c_async_bus_t *bus, uint8_t use_dma);
+
+/**
+ * @brief Initialize non-blocking transport on I2C2
+ * @param bus Pointer to bus (must stay valid while in use)
+ * @param use_dma 1 for DMA transfers, 0 for interrupt transfers
+ * @return 0 on success, negative value on error
+ */
+int i2c_driver_async_init_i2c2(i2c_async_bus_t *bus, uint8_t use_dma);
+
+/**
+ * @brief Forward a HAL I2C completion to the non-blocking transport
+ *
+ * Called by the HAL_I2C_MemRxCpltCallback, HAL_I2C_MemTxCpltCallback and
+ * HAL_I2C_ErrorCallback defined in i2c_driver.c. Applications that define
+ * these callbacks themselves build with I2C_DRIVER_NO_HAL_CALLBACKS and call
+ * this function from their own callbacks instead.
+ *
+ * @param hi2c HAL I2C handle (I2C_HandleTypeDef *)
+ * @param status 0 on success, negative value on error
+ */
+void i2c_driver_async_irq(void *hi2c, int status);
+#endif /* ICM42688_CFG_I2C_ASYNC */
+#endif /* ICM42688_CFG_I2C */
+
 #endif // I2C_DRIVER_H
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "icm42688_config.h"
 
 /* Device Configuration */
 #define ICM_42688_I2C_ADDRESS    0x68    /**< Default I2C address */
@@ -40,6 +41,59 @@
 /* Configuration Registers */
 #define ICM42688_REG_ACCEL_CONFIG0 0x50  /**< Accelerometer configuration */
 #define ICM42688_REG_GYRO_CONFIG0  0x4F  /**< Gyroscope configuration */
+#define ICM42688_REG_GYRO_CONFIG1  0x51  /**< Gyro UI filter order, temperature filter */
+#define ICM42688_REG_GYRO_ACCEL_CONFIG0 0x52 /**< Accel/gyro UI filter bandwidth */
+#define ICM42688_REG_ACCEL_CONFIG1 0x53  /**< Accel UI filter order */
+#define ICM42688_REG_BANK_SEL      0x76  /**< Register bank selection (all banks) */
+
+/* Bank 1: Gyro Anti-Alias and Notch Filter Registers */
+#define ICM42688_REG_GYRO_CONFIG_STATIC2  0x0B  /**< AAF/notch disable bits */
+#define ICM42688_REG_GYRO_CONFIG_STATIC3  0x0C  /**< GYRO_AAF_DELT */
+#define ICM42688_REG_GYRO_CONFIG_STATIC4  0x0D  /**< GYRO_AAF_DELTSQR[7:0] */
+#define ICM42688_REG_GYRO_CONFIG_STATIC5  0x0E  /**< GYRO_AAF_BITSHIFT, DELTSQR[11:8] */
+#define ICM42688_REG_GYRO_CONFIG_STATIC6  0x0F  /**< GYRO_X_NF_COSWZ[7:0] */
+#define ICM42688_REG_GYRO_CONFIG_STATIC7  0x10  /**< GYRO_Y_NF_COSWZ[7:0] */
+#define ICM42688_REG_GYRO_CONFIG_STATIC8  0x11  /**< GYRO_Z_NF_COSWZ[7:0] */
+#define ICM42688_REG_GYRO_CONFIG_STATIC9  0x12  /**< NF_COSWZ_SEL and COSWZ[8] per axis */
+#define ICM42688_REG_GYRO_CONFIG_STATIC10 0x13  /**< GYRO_NF_BW_SEL */
+
+/* Bank 2: Accel Anti-Alias Filter Registers */
+#define ICM42688_REG_ACCEL_CONFIG_STATIC2 0x03  /**< ACCEL_AAF_DELT, AAF disable */
+#define ICM42688_REG_ACCEL_CONFIG_STATIC3 0x04  /**< ACCEL_AAF_DELTSQR[7:0] */
+#define ICM42688_REG_ACCEL_CONFIG_STATIC4 0x05  /**< ACCEL_AAF_BITSHIFT, DELTSQR[11:8] */
+
+/* FIFO Registers */
+#define ICM42688_REG_FIFO_CONFIG   0x16  /**< FIFO mode selection */
+#define ICM42688_REG_INT_STATUS    0x2D  /**< Interrupt status (clear on read) */
+#define ICM42688_REG_FIFO_COUNTH   0x2E  /**< FIFO byte count MSB */
+#define ICM42688_REG_FIFO_COUNTL   0x2F  /**< FIFO byte count LSB */
+#define ICM42688_REG_FIFO_DATA     0x30  /**< FIFO data port */
+#define ICM42688_REG_SIGNAL_PATH_RESET 0x4B /**< Signal path reset / FIFO flush */
+#define ICM42688_REG_FIFO_CONFIG1  0x5F  /**< FIFO packet content selection */
+#define ICM42688_REG_FIFO_CONFIG2  0x60  /**< FIFO watermark [7:0] */
+#define ICM42688_REG_FIFO_CONFIG3  0x61  /**< FIFO watermark [11:8] */
+#define ICM42688_REG_INT_SOURCE0   0x65  /**< INT1 source routing */
+
+/* FIFO Bit Definitions */
+#define ICM42688_FIFO_MODE_BYPASS  0x00  /**< FIFO disabled */
+#define ICM42688_FIFO_MODE_STREAM  0x40  /**< Stream-to-FIFO mode */
+#define ICM42688_FIFO_FLUSH        0x02  /**< SIGNAL_PATH_RESET: flush FIFO */
+#define ICM42688_INT_STATUS_FIFO_THS  0x04 /**< FIFO watermark reached */
+#define ICM42688_INT_STATUS_FIFO_FULL 0x02 /**< FIFO full (overflow) */
+#define ICM42688_FIFO_SIZE         2048  /**< FIFO capacity in bytes */
+#define ICM42688_FIFO_WM_MAX       0x0FFF /**< Largest programmable watermark */
+
+/* FIFO Packet Header Bits */
+#define ICM42688_FIFO_HEADER_MSG   0x80  /**< FIFO is empty */
+#define ICM42688_FIFO_HEADER_ACCEL 0x40  /**< Packet contains accelerometer data */
+#define ICM42688_FIFO_HEADER_GYRO  0x20  /**< Packet contains gyroscope data */
+#define ICM42688_FIFO_HEADER_20    0x10  /**< Packet contains 20-bit extension */
+
+/* FIFO Packet Sizes */
+#define ICM42688_FIFO_PACKET1_SIZE 8     /**< Header + accel + 8-bit temp */
+#define ICM42688_FIFO_PACKET2_SIZE 8     /**< Header + gyro + 8-bit temp */
+#define ICM42688_FIFO_PACKET3_SIZE 16    /**< Header + accel + gyro + temp + timestamp */
+#define ICM42688_FIFO_PACKET4_SIZE 20    /**< Packet 3 with 16-bit temp and 20-bit data */
 
 /**
  * @brief Sensor data structure
@@ -54,6 +108,50 @@ typedef struct {
     int16_t temp;       /**< Temperature data */
 } icm42688_data_t;
 
+/**
+ * @brief Timestamped sensor sample
+ */
+typedef struct {
+    icm42688_data_t data;   /**< Sensor data */
+    uint32_t timestamp_us;  /**< Acquisition time in microseconds (free running, may wrap) */
+} icm42688_sample_t;
+
+/**
+ * @brief Axis index
+ */
+typedef enum {
+    ICM42688_AXIS_ACCEL_X = 0,
+    ICM42688_AXIS_ACCEL_Y,
+    ICM42688_AXIS_ACCEL_Z,
+    ICM42688_AXIS_GYRO_X,
+    ICM42688_AXIS_GYRO_Y,
+    ICM42688_AXIS_GYRO_Z
+} icm42688_axis_t;
+
+/**
+ * @brief Accelerometer full-scale range (ACCEL_CONFIG0 ACCEL_FS_SEL)
+ */
+typedef enum {
+    ICM42688_ACCEL_FS_16G = 0,  /**< +-16 g, 2048 LSB/g */
+    ICM42688_ACCEL_FS_8G,       /**< +-8 g, 4096 LSB/g */
+    ICM42688_ACCEL_FS_4G,       /**< +-4 g, 8192 LSB/g */
+    ICM42688_ACCEL_FS_2G        /**< +-2 g, 16384 LSB/g */
+} icm42688_accel_fs_t;
+
+/**
+ * @brief Gyroscope full-scale range (GYRO_CONFIG0 GYRO_FS_SEL)
+ */
+typedef enum {
+    ICM42688_GYRO_FS_2000DPS = 0,  /**< +-2000 dps, 16.4 LSB/dps */
+    ICM42688_GYRO_FS_1000DPS,      /**< +-1000 dps */
+    ICM42688_GYRO_FS_500DPS,       /**< +-500 dps */
+    ICM42688_GYRO_FS_250DPS,       /**< +-250 dps */
+    ICM42688_GYRO_FS_125DPS,       /**< +-125 dps */
+    ICM42688_GYRO_FS_62_5DPS,      /**< +-62.5 dps */
+    ICM42688_GYRO_FS_31_25DPS,     /**< +-31.25 dps */
+    ICM42688_GYRO_FS_15_625DPS     /**< +-15.625 dps, 2097.2 LSB/dps */
+} icm42688_gyro_fs_t;
+
 /**
  * @brief Communication bus abstraction structure
  */
@@ -84,6 +182,7 @@ int icm42688_init(icm42688_t *dev);
  */
 int icm42688_read_all(icm42688_t *dev, icm42688_data_t *data);
 
+#if ICM42688_CFG_SPLIT_READS
 /**
  * @brief Read temperature data
  * @param dev Pointer to sensor context
@@ -111,5 +210,117 @@ int icm42688_read_accel(icm42688_t *dev, int16_t *accel_x, int16_t *accel_y, int
  * @return 0 on success, negative value on error
  */
 int icm42688_read_gyro(icm42688_t *dev, int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z);
+#endif /* ICM42688_CFG_SPLIT_READS */
+
+#if ICM42688_CFG_FIFO
+/**
+ * @brief Configure FIFO for packet 3 (accel + gyro + temp + timestamp) in stream mode
+ * @param dev Pointer to sensor context
+ * @param watermark FIFO watermark in bytes, routed to INT1
+ * @return 0 on success, negative value on error
+ */
+int icm42688_fifo_init(icm42688_t *dev, uint16_t watermark);
+
+/**
+ * @brief Program FIFO watermark (FIFO_CONFIG2/FIFO_CONFIG3)
+ * @param dev Pointer to sensor context
+ * @param watermark Watermark in bytes (1..4095)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_set_fifo_watermark(icm42688_t *dev, uint16_t watermark);
+
+/**
+ * @brief Read number of bytes currently stored in FIFO
+ * @param dev Pointer to sensor context
+ * @param count Pointer to byte count
+ * @return 0 on success, negative value on error
+ */
+int icm42688_read_fifo_count(icm42688_t *dev, uint16_t *count);
+
+/**
+ * @brief Burst read raw FIFO bytes in a single bus transaction
+ * @param dev Pointer to sensor context
+ * @param buf Destination buffer
+ * @param len Number of bytes to read
+ * @return 0 on success, negative value on error
+ */
+int icm42688_read_fifo(icm42688_t *dev, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief Flush FIFO contents
+ * @param dev Pointer to sensor context
+ * @return 0 on success, negative value on error
+ */
+int icm42688_flush_fifo(icm42688_t *dev);
+#endif /* ICM42688_CFG_FIFO */
+
+/**
+ * @brief Read (and clear) INT_STATUS register
+ * @param dev Pointer to sensor context
+ * @param status Pointer to status value
+ * @return 0 on success, negative value on error
+ */
+int icm42688_read_int_status(icm42688_t *dev, uint8_t *status);
+
+#if ICM42688_CFG_RANGE
+/**
+ * @brief Select register bank for subsequent accesses
+ * @param dev Pointer to sensor context
+ * @param bank Bank number (0-4)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_set_bank(icm42688_t *dev, uint8_t bank);
+
+/**
+ * @brief Set accelerometer full-scale range (ODR bits are preserved)
+ * @param dev Pointer to sensor context
+ * @param fs Full-scale selection
+ * @return 0 on success, negative value on error
+ */
+int icm42688_set_accel_fsr(icm42688_t *dev, icm42688_accel_fs_t fs);
+
+/**
+ * @brief Set gyroscope full-scale range (ODR bits are preserved)
+ * @param dev Pointer to sensor context
+ * @param fs Full-scale selection
+ * @return 0 on success, negative value on error
+ */
+int icm42688_set_gyro_fsr(icm42688_t *dev, icm42688_gyro_fs_t fs);
+#endif /* ICM42688_CFG_RANGE */
+
+#if ICM42688_CFG_FIFO
+/**
+ * @brief Decode raw FIFO bytes into samples
+ * @param buf Raw FIFO bytes
+ * @param len Number of bytes in buffer
+ * @param out Output sample array
+ * @param max_samples Capacity of output array
+ * @param consumed Optional pointer to number of bytes decoded
+ * @return Number of samples decoded, negative value on error
+ * @note Packets 1 and 2 leave the missing sensor fields at zero. 8-bit FIFO
+ *       temperature is rescaled to TEMP_DATA resolution. Packet types compiled
+ *       out (ICM42688_CFG_FIFO_PACKET1_2, ICM42688_CFG_FIFO_PACKET4) end the
+ *       parse like an invalid header.
+ */
+int icm42688_parse_fifo(const uint8_t *buf, uint16_t len, icm42688_data_t *out,
+                        uint16_t max_samples, uint16_t *consumed);
+
+/**
+ * @brief Decode raw FIFO bytes into samples carrying the sensor FIFO timestamp
+ * @param buf Raw FIFO bytes
+ * @param len Number of bytes in buffer
+ * @param out Output sample array
+ * @param max_samples Capacity of output array
+ * @param consumed Optional pointer to number of bytes decoded
+ * @return Number of samples decoded, negative value on error
+ * @note timestamp_us holds the raw 16-bit packet 3/4 timestamp (1 us per LSB
+ *       with the default TMST_RES, wraps every 65.536 ms), so consecutive
+ *       samples are compared with a 16-bit difference. Packets 1 and 2 carry
+ *       no timestamp and report 0. For clock alignment, initialize the
+ *       estimator with ICM42688_TS_BITS_FIFO (time_align.h).
+ */
+int icm42688_parse_fifo_samples(const uint8_t *buf, uint16_t len, icm42688_sample_t *out,
+                                uint16_t max_samples, uint16_t *consumed);
+#endif /* ICM42688_CFG_FIFO */
 
 #endif // ICM_42688_H
\ No newline at end of file
@@ -0,0 +1,230 @@
+/**
+ * @file icm42688_config.h
+ * @brief Compile-time feature and buffer-size selection for the ICM-42688 driver
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Pick a footprint profile with -DICM42688_PROFILE=ICM42688_PROFILE_MINIMAL
+ * (or _TYPICAL, _FULL; FULL is the default and matches earlier releases).
+ * The profile sets defaults for every ICM42688_CFG_* switch and for the
+ * buffer sizes of the optional modules; any of them can still be overridden
+ * on the command line or in a project header named by ICM42688_USER_CONFIG
+ * (-DICM42688_USER_CONFIG='"board_imu_config.h"'), which is included first.
+ *
+ * A disabled module compiles to an empty translation unit, so build systems
+ * can keep compiling every file under src/. Its header still declares the
+ * types but not the functions, so a call into a disabled module fails at
+ * compile time instead of at link time. Everything stays statically
+ * allocated; sizes only change array dimensions.
+ *
+ *   switch                       MINIMAL  TYPICAL  FULL
+ *   ICM42688_CFG_I2C                1        1       1   blocking I2C transport
+ *   ICM42688_CFG_SPI                0        1       1   SPI transport
+ *   ICM42688_CFG_I2C_ASYNC          0        0       1   non-blocking I2C queue
+ *   ICM42688_CFG_SPLIT_READS        0        1       1   read_temp/accel/gyro
+ *   ICM42688_CFG_FIFO               0        1       1   FIFO setup, read, parse (packet 3)
+ *   ICM42688_CFG_FIFO_PACKET1_2     0        0       1   parse 8-byte accel-only/gyro-only packets
+ *   ICM42688_CFG_FIFO_PACKET4       0        1       1   parse 20-byte high-resolution packets
+ *   ICM42688_CFG_RANGE              1        1       1   bank select, full-scale setters
+ *   ICM42688_CFG_FIFO_WATERMARK     0        1       1   adaptive watermark
+ *   ICM42688_CFG_HW_FILTER          0        1       1   on-sensor AAF/notch setup
+ *   ICM42688_CFG_AUTORANGE          0        1       1   automatic full-scale selection
+ *   ICM42688_CFG_READ_SCHED         0        1       1   multi-rate read scheduler
+ *   ICM42688_CFG_LATEST_SAMPLE      0        1       1   seqlock latest-sample slot
+ *   ICM42688_CFG_DEADBAND           0        1       1   send-on-delta reduction
+ *   ICM42688_CFG_EVENT_CAPTURE      0        0       1   pre/post-event capture
+ *   ICM42688_CFG_RESAMPLER          0        0       1   polyphase resampler
+ *   ICM42688_CFG_PREINTEGRATION     0        0       1   IMU preintegration
+ *   ICM42688_CFG_SPECTRUM           0        0       1   vibration spectrum
+ *   ICM42688_CFG_ALLAN              0        0       1   Allan variance
+ *   ICM42688_CFG_SAMPLE_CODEC       0        0       1   block sample compression
+ *   ICM42688_CFG_TIME_ALIGN         0        0       1   clock sync and stream merge
+ *   ICM42688_CFG_BUS_MODEL          0        0       1   bus timing model/planner
+ *   ICM42688_CFG_TRACE              0        0       0   pipeline tracing (instrumentation)
+ *
+ * host_pipeline.c and shm_ring.c are Linux-only and compile to nothing on the MCU.
+ */
+
+#ifndef ICM42688_CONFIG_H
+#define ICM42688_CONFIG_H
+
+#define ICM42688_PROFILE_MINIMAL 1  /**< Polled read_all over I2C, nothing else */
+#define ICM42688_PROFILE_TYPICAL 2  /**< Both transports, FIFO, sensor configuration helpers */
+#define ICM42688_PROFILE_FULL    3  /**< Everything (default) */
+
+#ifdef ICM42688_USER_CONFIG
+#include ICM42688_USER_CONFIG
+#endif
+
+#ifndef ICM42688_PROFILE
+#define ICM42688_PROFILE ICM42688_PROFILE_FULL
+#endif
+
+#if ICM42688_PROFILE != ICM42688_PROFILE_MINIMAL && ICM42688_PROFILE != ICM42688_PROFILE_TYPICAL && \
+    ICM42688_PROFILE != ICM42688_PROFILE_FULL
+#error "ICM42688_PROFILE must be ICM42688_PROFILE_MINIMAL, _TYPICAL or _FULL"
+#endif
+
+#define ICM42688_PROFILE_AT_LEAST(p) (ICM42688_PROFILE >= ICM42688_PROFILE_##p)
+
+/* Transports */
+#ifndef ICM42688_CFG_I2C
+#define ICM42688_CFG_I2C 1
+#endif
+#ifndef ICM42688_CFG_SPI
+#define ICM42688_CFG_SPI ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_I2C_ASYNC
+#define ICM42688_CFG_I2C_ASYNC ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+
+/* Core driver: decode variants and FIFO packet types */
+#ifndef ICM42688_CFG_SPLIT_READS
+#define ICM42688_CFG_SPLIT_READS ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_FIFO
+#define ICM42688_CFG_FIFO ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_FIFO_PACKET1_2
+#define ICM42688_CFG_FIFO_PACKET1_2 ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_FIFO_PACKET4
+#define ICM42688_CFG_FIFO_PACKET4 ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_RANGE
+#define ICM42688_CFG_RANGE 1
+#endif
+
+/* Optional modules */
+#ifndef ICM42688_CFG_FIFO_WATERMARK
+#define ICM42688_CFG_FIFO_WATERMARK ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_HW_FILTER
+#define ICM42688_CFG_HW_FILTER ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_AUTORANGE
+#define ICM42688_CFG_AUTORANGE ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_READ_SCHED
+#define ICM42688_CFG_READ_SCHED ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_LATEST_SAMPLE
+#define ICM42688_CFG_LATEST_SAMPLE ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_DEADBAND
+#define ICM42688_CFG_DEADBAND ICM42688_PROFILE_AT_LEAST(TYPICAL)
+#endif
+#ifndef ICM42688_CFG_EVENT_CAPTURE
+#define ICM42688_CFG_EVENT_CAPTURE ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_RESAMPLER
+#define ICM42688_CFG_RESAMPLER ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_PREINTEGRATION
+#define ICM42688_CFG_PREINTEGRATION ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_SPECTRUM
+#define ICM42688_CFG_SPECTRUM ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_ALLAN
+#define ICM42688_CFG_ALLAN ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_SAMPLE_CODEC
+#define ICM42688_CFG_SAMPLE_CODEC ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_TIME_ALIGN
+#define ICM42688_CFG_TIME_ALIGN ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+#ifndef ICM42688_CFG_BUS_MODEL
+#define ICM42688_CFG_BUS_MODEL ICM42688_PROFILE_AT_LEAST(FULL)
+#endif
+
+/* Instrumentation: off in every profile, it costs RAM for the event rings */
+#ifndef ICM42688_CFG_TRACE
+#ifdef ICM42688_TRACE_ENABLE
+#define ICM42688_CFG_TRACE 1
+#else
+#define ICM42688_CFG_TRACE 0
+#endif
+#endif
+#if ICM42688_CFG_TRACE && !defined(ICM42688_TRACE_ENABLE)
+#define ICM42688_TRACE_ENABLE
+#endif
+
+/* Dependencies */
+#if ICM42688_CFG_FIFO_WATERMARK && !ICM42688_CFG_FIFO
+#error "ICM42688_CFG_FIFO_WATERMARK requires ICM42688_CFG_FIFO"
+#endif
+#if (ICM42688_CFG_HW_FILTER || ICM42688_CFG_AUTORANGE) && !ICM42688_CFG_RANGE
+#error "ICM42688_CFG_HW_FILTER and ICM42688_CFG_AUTORANGE require ICM42688_CFG_RANGE"
+#endif
+#if ICM42688_CFG_I2C_ASYNC && !ICM42688_CFG_I2C
+#error "ICM42688_CFG_I2C_ASYNC requires ICM42688_CFG_I2C"
+#endif
+
+/* Buffer sizes; FULL keeps the defaults in each module header */
+#if ICM42688_PROFILE == ICM42688_PROFILE_MINIMAL
+#ifndef ICM42688_TRACE_DEPTH
+#define ICM42688_TRACE_DEPTH 128
+#endif
+#ifndef I2C_ASYNC_MAX_CLIENTS
+#define I2C_ASYNC_MAX_CLIENTS 2
+#endif
+#ifndef ICM42688_CAPTURE_PRE
+#define ICM42688_CAPTURE_PRE 32
+#endif
+#ifndef ICM42688_CAPTURE_POST
+#define ICM42688_CAPTURE_POST 32
+#endif
+#ifndef ICM42688_CAPTURE_SLOTS
+#define ICM42688_CAPTURE_SLOTS 1
+#endif
+#ifndef ICM42688_SPECTRUM_N
+#define ICM42688_SPECTRUM_N 64
+#endif
+#ifndef ICM42688_ALLAN_OCTAVES
+#define ICM42688_ALLAN_OCTAVES 16
+#endif
+#ifndef ICM42688_CODEC_BLOCK_MAX
+#define ICM42688_CODEC_BLOCK_MAX 16
+#endif
+#ifndef ICM42688_TIMESYNC_WINDOW
+#define ICM42688_TIMESYNC_WINDOW 8
+#endif
+#ifndef ICM42688_MERGE_MAX_STREAMS
+#define ICM42688_MERGE_MAX_STREAMS 2
+#endif
+#elif ICM42688_PROFILE == ICM42688_PROFILE_TYPICAL
+#ifndef ICM42688_TRACE_DEPTH
+#define ICM42688_TRACE_DEPTH 256
+#endif
+#ifndef I2C_ASYNC_MAX_CLIENTS
+#define I2C_ASYNC_MAX_CLIENTS 2
+#endif
+#ifndef ICM42688_CAPTURE_PRE
+#define ICM42688_CAPTURE_PRE 128
+#endif
+#ifndef ICM42688_CAPTURE_POST
+#define ICM42688_CAPTURE_POST 128
+#endif
+#ifndef ICM42688_CAPTURE_SLOTS
+#define ICM42688_CAPTURE_SLOTS 2
+#endif
+#ifndef ICM42688_SPECTRUM_N
+#define ICM42688_SPECTRUM_N 256
+#endif
+#ifndef ICM42688_ALLAN_OCTAVES
+#define ICM42688_ALLAN_OCTAVES 20
+#endif
+#ifndef ICM42688_CODEC_BLOCK_MAX
+#define ICM42688_CODEC_BLOCK_MAX 32
+#endif
+#ifndef ICM42688_TIMESYNC_WINDOW
+#define ICM42688_TIMESYNC_WINDOW 16
+#endif
+#ifndef ICM42688_MERGE_MAX_STREAMS
+#define ICM42688_MERGE_MAX_STREAMS 4
+#endif
+#endif
+
+#endif // ICM42688_CONFIG_H
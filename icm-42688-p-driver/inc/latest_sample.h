@@ -0,0 +1,69 @@
+/**
+ * @file latest_sample.h
+ * @brief Seqlock "latest value" slot for the freshest ICM-42688 sample
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * One writer (the ISR or acquisition task of a device) publishes every new
+ * sample; any number of readers (control loop, telemetry, watchdog) take a
+ * consistent copy of the most recent one. The writer never waits: it bumps a
+ * sequence counter to odd, stores the sample, and bumps it to even again.
+ * A reader copies the sample between two reads of the counter and retries if
+ * the counter was odd or changed, so it can never see a torn sample.
+ *
+ * icm42688_latest_read() retries until it succeeds and must not be called
+ * from a context that preempts the writer (it would spin forever); use
+ * icm42688_latest_try_read() there. Only one writer per slot is allowed.
+ */
+
+#ifndef LATEST_SAMPLE_H
+#define LATEST_SAMPLE_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_LATEST_WORDS ((sizeof(icm42688_sample_t) + 3) / 4)
+
+/**
+ * @brief Latest-sample slot
+ */
+typedef struct {
+    uint32_t seq;                            /**< Even when stable, odd while being written */
+    uint32_t words[ICM42688_LATEST_WORDS];   /**< icm42688_sample_t, stored word by word */
+} icm42688_latest_t;
+
+#if ICM42688_CFG_LATEST_SAMPLE
+/**
+ * @brief Initialize slot (no sample published)
+ * @param slot Pointer to slot
+ */
+void icm42688_latest_init(icm42688_latest_t *slot);
+
+/**
+ * @brief Publish a new sample (single writer, wait-free)
+ * @param slot Pointer to slot
+ * @param data Sample data
+ * @param timestamp_us Acquisition time
+ */
+void icm42688_latest_publish(icm42688_latest_t *slot, const icm42688_data_t *data, uint32_t timestamp_us);
+
+/**
+ * @brief Read the latest sample, retrying while a publish is in progress
+ * @param slot Pointer to slot
+ * @param out Pointer to sample copy
+ * @param seq Pointer to publish count of the copy, 1 for the first sample (may be NULL)
+ * @return 0 on success, negative value on error (-3 if nothing was published yet)
+ */
+int icm42688_latest_read(const icm42688_latest_t *slot, icm42688_sample_t *out, uint32_t *seq);
+
+/**
+ * @brief Single read attempt, for readers that may preempt the writer
+ * @param slot Pointer to slot
+ * @param out Pointer to sample copy
+ * @param seq Pointer to publish count of the copy (may be NULL)
+ * @return 0 on success, negative value on error (-3 if nothing published or a publish was in progress)
+ */
+int icm42688_latest_try_read(const icm42688_latest_t *slot, icm42688_sample_t *out, uint32_t *seq);
+#endif /* ICM42688_CFG_LATEST_SAMPLE */
+
+#endif // LATEST_SAMPLE_H
@@ -0,0 +1,91 @@
+/**
+ * @file preintegration.h
+ * @brief IMU preintegration with coning/sculling compensation for ICM-42688
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Accumulates high-rate gyro and accel samples into delta-angle and
+ * delta-velocity increments emitted at a lower consumer rate (e.g. 100 Hz).
+ * Rates are integrated with the trapezoidal rule over reconstructed sample
+ * times; coning and sculling corrections keep the increments accurate when
+ * the body rotates during the output interval.
+ *
+ * Sample times are reconstructed from the (jittery) read timestamps with a
+ * first-order tracking loop on the sample period, so polling jitter does not
+ * leak into the integration step.
+ */
+
+#ifndef PREINTEGRATION_H
+#define PREINTEGRATION_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+/**
+ * @brief Preintegrated increment over one output interval (sensor body frame)
+ */
+typedef struct {
+    float delta_angle[3];     /**< Coning-compensated rotation vector in rad */
+    float delta_velocity[3];  /**< Sculling/rotation-compensated velocity change in m/s */
+    uint32_t dt_us;           /**< Integration interval */
+    uint32_t timestamp_us;    /**< Reconstructed time of the last sample in the interval */
+    uint16_t samples;         /**< Samples integrated */
+} icm42688_preint_out_t;
+
+/**
+ * @brief Preintegrator state
+ */
+typedef struct {
+    float gyro_scale;         /**< rad/s per LSB */
+    float accel_scale;        /**< m/s^2 per LSB */
+    uint32_t interval_us;     /**< Output interval */
+    uint32_t last_raw_us;     /**< Last raw timestamp */
+    uint64_t raw_q8;          /**< Unwrapped raw time, 1/256 us */
+    uint64_t recon_q8;        /**< Reconstructed time of last sample, 1/256 us */
+    uint64_t start_q8;        /**< Reconstructed time at start of current interval */
+    int32_t period_q8;        /**< Tracked sample period, 1/256 us */
+    int32_t nominal_q8;       /**< Nominal sample period, 1/256 us */
+    float last_w[3];          /**< Previous angular rate (rad/s) */
+    float last_a[3];          /**< Previous specific force (m/s^2) */
+    float alpha[3];           /**< Uncompensated delta angle */
+    float beta[3];            /**< Coning correction */
+    float last_dalpha[3];     /**< Previous delta angle step */
+    float vel[3];             /**< Uncompensated delta velocity */
+    float last_dv[3];         /**< Previous delta velocity step */
+    float scul[3];            /**< Sculling correction (x2) */
+    uint16_t count;           /**< Samples in current interval */
+    uint8_t started;          /**< First sample received */
+} icm42688_preint_t;
+
+#if ICM42688_CFG_PREINTEGRATION
+/**
+ * @brief Initialize preintegrator
+ * @param pi Pointer to preintegrator
+ * @param odr_hz Sensor output data rate (initial sample period)
+ * @param out_hz Consumer rate
+ * @param gyro_scale Gyroscope scale in rad/s per LSB
+ * @param accel_scale Accelerometer scale in m/s^2 per LSB
+ * @return 0 on success, negative value on error
+ */
+int icm42688_preint_init(icm42688_preint_t *pi, uint32_t odr_hz, uint32_t out_hz,
+                         float gyro_scale, float accel_scale);
+
+/**
+ * @brief Integrate one sample
+ * @param pi Pointer to preintegrator
+ * @param data Pointer to raw sample
+ * @param timestamp_us Read timestamp in microseconds (free running, may wrap)
+ * @param out Pointer to increment, written when an interval completes
+ * @return 1 if an increment was emitted, 0 otherwise, negative value on error
+ */
+int icm42688_preint_push(icm42688_preint_t *pi, const icm42688_data_t *data, uint32_t timestamp_us,
+                         icm42688_preint_out_t *out);
+
+/**
+ * @brief Discard the partially accumulated interval and the previous step
+ * @param pi Pointer to preintegrator
+ */
+void icm42688_preint_reset(icm42688_preint_t *pi);
+#endif /* ICM42688_CFG_PREINTEGRATION */
+
+#endif // PREINTEGRATION_H
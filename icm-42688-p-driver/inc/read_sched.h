@@ -0,0 +1,93 @@
+/**
+ * @file read_sched.h
+ * @brief Multi-rate register read scheduler for ICM-42688
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Temperature, accelerometer and gyroscope data registers are contiguous
+ * (TEMP_DATA1 0x1D .. GYRO_DATA_Z0 0x2A). Instead of reading all 14 bytes on
+ * every tick, each channel gets its own divisor (e.g. gyro every tick, accel
+ * every 2nd, temperature every 1000th) and each tick reads only the due
+ * channels. Due channels separated by a gap are read in one burst when the
+ * gap costs no more than a separate transaction (overhead_bytes), otherwise
+ * in two; adjacent channels are always one burst. Channels that come along for free inside a merged burst are reported
+ * as valid too. The span plan for each of the 8 possible due sets is built
+ * once at init.
+ */
+
+#ifndef READ_SCHED_H
+#define READ_SCHED_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_SCHED_VALID_TEMP   0x01  /**< temp updated this tick */
+#define ICM42688_SCHED_VALID_ACCEL  0x02  /**< accel_x/y/z updated this tick */
+#define ICM42688_SCHED_VALID_GYRO   0x04  /**< gyro_x/y/z updated this tick */
+
+#define ICM42688_SCHED_CHANNELS 3         /**< temp, accel, gyro */
+
+/**
+ * @brief One burst read
+ */
+typedef struct {
+    uint8_t offset;  /**< First byte relative to TEMP_DATA1 */
+    uint8_t len;     /**< Bytes */
+    uint8_t valid;   /**< Channels fully covered (ICM42688_SCHED_VALID_*) */
+} icm42688_sched_span_t;
+
+/**
+ * @brief Read plan for one set of due channels
+ */
+typedef struct {
+    icm42688_sched_span_t span[ICM42688_SCHED_CHANNELS]; /**< Bursts */
+    uint8_t count;                                        /**< Number of bursts */
+} icm42688_sched_plan_t;
+
+/**
+ * @brief Scheduler statistics
+ */
+typedef struct {
+    uint32_t ticks;          /**< Ticks run */
+    uint32_t transactions;   /**< Bus reads issued */
+    uint32_t bytes;          /**< Data bytes read */
+    uint32_t read_all_bytes; /**< Bytes icm42688_read_all would have read (14 per tick) */
+} icm42688_sched_stats_t;
+
+/**
+ * @brief Multi-rate read scheduler
+ */
+typedef struct {
+    icm42688_t *dev;                                   /**< Sensor */
+    uint16_t div[ICM42688_SCHED_CHANNELS];             /**< Divisor per channel (0 = never) */
+    uint16_t phase[ICM42688_SCHED_CHANNELS];           /**< Ticks until channel is next due */
+    icm42688_sched_plan_t plan[1 << ICM42688_SCHED_CHANNELS]; /**< Plan per due mask */
+    icm42688_data_t data;                              /**< Latest values (stale where not valid) */
+    icm42688_sched_stats_t stats;                      /**< Statistics */
+} icm42688_sched_t;
+
+#if ICM42688_CFG_READ_SCHED
+/**
+ * @brief Initialize scheduler and build read plans
+ * @param sch Pointer to scheduler
+ * @param dev Sensor
+ * @param temp_div Read temperature every temp_div ticks (0 = never)
+ * @param accel_div Read accel every accel_div ticks (0 = never)
+ * @param gyro_div Read gyro every gyro_div ticks (0 = never)
+ * @param overhead_bytes Cost of one extra transaction in byte times (I2C ~4, SPI ~2)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_sched_init(icm42688_sched_t *sch, icm42688_t *dev, uint16_t temp_div, uint16_t accel_div,
+                        uint16_t gyro_div, uint8_t overhead_bytes);
+
+/**
+ * @brief Run one tick: read the due channels
+ * @param sch Pointer to scheduler
+ * @param data Pointer to sample (all fields written; fields not valid this tick hold their last value)
+ * @param valid Pointer to ICM42688_SCHED_VALID_* mask of fresh fields
+ * @return 0 on success, negative value on error
+ */
+int icm42688_sched_tick(icm42688_sched_t *sch, icm42688_data_t *data, uint8_t *valid);
+#endif /* ICM42688_CFG_READ_SCHED */
+
+#endif // READ_SCHED_H
@@ -0,0 +1,91 @@
+/**
+ * @file sample_codec.h
+ * @brief Lossless block codec for ICM-42688 sample logs
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Each block holds up to ICM42688_CODEC_BLOCK_MAX samples and decodes on its
+ * own, so a damaged block on an SD card does not affect the rest of the log.
+ * Every channel (accel x/y/z, gyro x/y/z, temp) is predicted separately:
+ * either by the previous sample (delta) or by linear extrapolation from the
+ * two previous samples. The residuals are computed modulo 2^16, zigzag
+ * mapped and bit-packed with the smallest width that fits the whole block.
+ *
+ * Block layout:
+ *   byte 0          : ICM42688_CODEC_MAGIC
+ *   byte 1          : sample count (1..ICM42688_CODEC_BLOCK_MAX, at most 255)
+ *   per channel     : seed sample (int16, little endian),
+ *                     descriptor (bits 4:0 width 0..16, bits 6:5 predictor)
+ *   payload         : residuals of samples 1..count-1, channel after channel,
+ *                     packed LSB first, padded to a whole byte
+ */
+
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_CODEC_MAGIC      0xC7 /**< Block start marker */
+#define ICM42688_CODEC_CHANNELS   7    /**< Channels per sample */
+#ifndef ICM42688_CODEC_BLOCK_MAX
+#define ICM42688_CODEC_BLOCK_MAX  64   /**< Maximum samples per block */
+#endif
+
+/**
+ * @brief Worst-case encoded size of a block of n samples
+ */
+#define ICM42688_CODEC_MAX_BYTES(n) \
+    (2 + 3 * ICM42688_CODEC_CHANNELS + (ICM42688_CODEC_CHANNELS * ((n) - 1) * 16 + 7) / 8)
+
+/**
+ * @brief Channel predictor
+ */
+typedef enum {
+    ICM42688_CODEC_PRED_AUTO = 0,   /**< Pick the cheaper predictor per channel */
+    ICM42688_CODEC_PRED_DELTA = 1,  /**< x[n-1] */
+    ICM42688_CODEC_PRED_LINEAR = 2  /**< 2*x[n-1] - x[n-2] */
+} icm42688_codec_pred_t;
+
+#if ICM42688_CFG_SAMPLE_CODEC
+/**
+ * @brief Encode a block of samples
+ * @param in Input samples
+ * @param count Number of samples (1..ICM42688_CODEC_BLOCK_MAX)
+ * @param pred Predictor selection
+ * @param out Output buffer
+ * @param out_size Output buffer size (ICM42688_CODEC_MAX_BYTES(count) always suffices)
+ * @return Encoded size in bytes, negative value on error
+ */
+int icm42688_codec_encode(const icm42688_data_t *in, uint16_t count, icm42688_codec_pred_t pred,
+                          uint8_t *out, uint16_t out_size);
+
+/**
+ * @brief Decode one block into per-channel arrays
+ *
+ * Residuals of a channel are unpacked in bulk before the prediction is
+ * undone, and the output is one contiguous array per channel, ready for
+ * vectorized post-processing.
+ *
+ * @param in Encoded data (starting at a block)
+ * @param in_size Available bytes
+ * @param soa Output, soa[channel][n] in accel x/y/z, gyro x/y/z, temp order
+ * @param count Pointer to number of decoded samples
+ * @return Number of bytes consumed, negative value on error
+ */
+int icm42688_codec_decode_soa(const uint8_t *in, uint16_t in_size,
+                              int16_t soa[ICM42688_CODEC_CHANNELS][ICM42688_CODEC_BLOCK_MAX],
+                              uint16_t *count);
+
+/**
+ * @brief Decode one block into samples
+ * @param in Encoded data (starting at a block)
+ * @param in_size Available bytes
+ * @param out Output samples (at least ICM42688_CODEC_BLOCK_MAX entries)
+ * @param count Pointer to number of decoded samples
+ * @return Number of bytes consumed, negative value on error
+ */
+int icm42688_codec_decode(const uint8_t *in, uint16_t in_size, icm42688_data_t *out, uint16_t *count);
+#endif /* ICM42688_CFG_SAMPLE_CODEC */
+
+#endif // SAMPLE_CODEC_H
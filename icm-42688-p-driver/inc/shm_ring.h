@@ -0,0 +1,150 @@
+/**
+ * @file shm_ring.h
+ * @brief Shared-memory sample ring for fan-out to several Linux processes
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * One publisher process (the one that owns the bus) writes decoded samples
+ * into a POSIX shared-memory ring (/dev/shm/<name>). Any number of subscriber
+ * processes (recorder, controller, telemetry) map it read-only and consume
+ * batches in place, without copying and without the publisher knowing about
+ * them. Each subscriber keeps its own cursor in its own memory.
+ *
+ * The publisher never waits for readers: a reader that falls more than the
+ * ring capacity behind loses samples. Before overwriting slots the publisher
+ * advances a reserve counter, and after writing it advances the head counter.
+ * A reader checks the reserve counter again after using a batch, so it can
+ * tell whether the batch was overwritten while it was reading. Idle readers
+ * sleep on a futex; they count themselves in a small writable side object
+ * (/dev/shm/<name>-wait), and the publisher only makes the wake system call
+ * when that count is nonzero.
+ *
+ * Destroying or re-creating a ring marks the old one closed and wakes its
+ * sleepers, so subscribers still attached to it get an error from
+ * icm42688_shm_peek instead of sleeping forever.
+ */
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include "icm-42688.h"
+
+#define ICM42688_SHM_MAGIC   0x52534D49u  /**< "IMSR" little-endian */
+#define ICM42688_SHM_VERSION 2
+
+/**
+ * @brief Shared ring header, followed by the sample slots
+ */
+typedef struct {
+    uint32_t magic;        /**< ICM42688_SHM_MAGIC */
+    uint32_t version;      /**< ICM42688_SHM_VERSION */
+    uint32_t capacity;     /**< Slots, power of 2 */
+    uint32_t slot_size;    /**< sizeof(icm42688_sample_t) of the publisher */
+    uint32_t wake;         /**< Futex word, bumped once per published batch */
+    uint32_t closed;       /**< Set once the ring was destroyed or replaced */
+    uint64_t reserve __attribute__((aligned(64))); /**< Samples claimed by the publisher */
+    uint64_t head __attribute__((aligned(64)));    /**< Samples published (readable below this) */
+    icm42688_sample_t slots[] __attribute__((aligned(64))); /**< Sample storage */
+} icm42688_shm_ring_t;
+
+/**
+ * @brief Publisher handle
+ */
+typedef struct {
+    icm42688_shm_ring_t *ring; /**< Mapped ring (read-write) */
+    size_t map_size;           /**< Mapping size */
+    uint32_t *waiters;         /**< Sleeping subscribers, in the side object */
+    uint64_t wakes;            /**< Wake system calls made */
+    char name[64];             /**< Shared-memory object name */
+} icm42688_shm_pub_t;
+
+/**
+ * @brief Subscriber statistics
+ */
+typedef struct {
+    uint64_t consumed;   /**< Samples released in order */
+    uint64_t lost;       /**< Samples skipped because the publisher lapped the reader */
+    uint32_t overruns;   /**< Times a batch was overwritten */
+} icm42688_shm_stats_t;
+
+/**
+ * @brief Subscriber handle
+ */
+typedef struct {
+    const icm42688_shm_ring_t *ring; /**< Mapped ring (read-only) */
+    size_t map_size;                 /**< Mapping size */
+    uint32_t *waiters;               /**< Sleeping subscribers, in the side object */
+    uint64_t cursor;                 /**< Next sample to read */
+    icm42688_shm_stats_t stats;      /**< Statistics */
+} icm42688_shm_sub_t;
+
+/**
+ * @brief Create (or replace) a shared ring and map it for publishing
+ * @param pub Pointer to publisher handle
+ * @param name Shared-memory object name, e.g. "/imu0" (at most 58 characters)
+ * @param capacity Slots, power of 2
+ * @return 0 on success, negative value on error (-2 on OS failure)
+ * @note A ring already under this name is marked closed before it is
+ *       unlinked, so its subscribers see -3 from icm42688_shm_peek.
+ */
+int icm42688_shm_create(icm42688_shm_pub_t *pub, const char *name, uint32_t capacity);
+
+/**
+ * @brief Publish a batch of samples and wake sleeping subscribers
+ * @param pub Pointer to publisher handle
+ * @param samples Samples
+ * @param count Number of samples (at most the capacity)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_shm_publish(icm42688_shm_pub_t *pub, const icm42688_sample_t *samples, uint32_t count);
+
+/**
+ * @brief Mark the ring closed, wake its subscribers and unmap it
+ * @param pub Pointer to publisher handle
+ * @param unlink Nonzero to remove the shared-memory objects as well
+ */
+void icm42688_shm_destroy(icm42688_shm_pub_t *pub, int unlink);
+
+/**
+ * @brief Map an existing ring read-only; reading starts at the newest sample
+ * @param sub Pointer to subscriber handle
+ * @param name Shared-memory object name
+ * @return 0 on success, negative value on error (-2 on OS failure, -3 if the ring is not compatible)
+ */
+int icm42688_shm_subscribe(icm42688_shm_sub_t *sub, const char *name);
+
+/**
+ * @brief Get the next batch of published samples in place
+ * @param sub Pointer to subscriber handle
+ * @param batch Pointer to first sample of the batch (valid until icm42688_shm_release)
+ * @param max Largest batch wanted
+ * @param timeout_ms Time to sleep when nothing is available (0 = do not wait, -1 = forever)
+ * @return Number of samples in the batch (contiguous in memory), 0 on timeout, negative value on error
+ *         (-3 once the ring is closed and drained: unsubscribe and subscribe again)
+ * @note If the reader has already been lapped, the cursor jumps to the oldest
+ *       sample still in the ring and the skipped samples are counted as lost.
+ */
+int icm42688_shm_peek(icm42688_shm_sub_t *sub, const icm42688_sample_t **batch, uint32_t max, int timeout_ms);
+
+/**
+ * @brief Finish with a batch returned by icm42688_shm_peek
+ * @param sub Pointer to subscriber handle
+ * @param count Samples used from the start of the batch
+ * @return 0 if the batch was intact, -3 if the publisher overwrote part of it
+ *         while it was in use (drop the results; the cursor has moved past it)
+ */
+int icm42688_shm_release(icm42688_shm_sub_t *sub, uint32_t count);
+
+/**
+ * @brief Unmap the ring
+ * @param sub Pointer to subscriber handle
+ */
+void icm42688_shm_unsubscribe(icm42688_shm_sub_t *sub);
+
+#endif /* __linux__ */
+
+#endif // SHM_RING_H
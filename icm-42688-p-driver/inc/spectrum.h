@@ -0,0 +1,141 @@
+/**
+ * @file spectrum.h
+ * @brief Streaming Welch PSD vibration analysis for ICM-42688 samples
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Samples pushed from icm42688_read_all() (or FIFO) are windowed with a Hann
+ * window into 50% overlapping frames of ICM42688_SPECTRUM_N points per axis.
+ * Each frame is transformed and its periodogram is added to a Welch average.
+ * Two axes are packed into one complex FFT (real/imag), so a frame of all six
+ * axes costs three complex FFTs.
+ *
+ * Two kernels are available:
+ *  - float radix-2 with split re/im arrays and per-stage contiguous twiddles so
+ *    the butterfly loops auto-vectorize on host (SSE/AVX/NEON);
+ *  - Q15 radix-4 with block floating point for Cortex-M3 (no FPU): each
+ *    frame is normalized and a stage is scaled down only when it could
+ *    overflow, so small vibrations keep their precision.
+ * The fixed-point kernel is selected by default on Cortex-M0/M3 targets, or
+ * explicitly with ICM42688_SPECTRUM_FIXED=1.
+ *
+ * All buffers live in icm42688_spectrum_t; nothing is allocated at runtime.
+ */
+
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#ifndef ICM42688_SPECTRUM_N
+#define ICM42688_SPECTRUM_N 256 /**< FFT length, must be 64, 256 or 1024 */
+#endif
+
+#ifndef ICM42688_SPECTRUM_FIXED
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__)
+#define ICM42688_SPECTRUM_FIXED 1
+#else
+#define ICM42688_SPECTRUM_FIXED 0
+#endif
+#endif
+
+#define ICM42688_SPECTRUM_BINS (ICM42688_SPECTRUM_N / 2 + 1) /**< One-sided PSD bins */
+#define ICM42688_SPECTRUM_HOP  (ICM42688_SPECTRUM_N / 2)     /**< 50% overlap */
+#define ICM42688_SPECTRUM_AXES 6                             /**< accel x/y/z, gyro x/y/z */
+
+#if ICM42688_SPECTRUM_FIXED
+typedef uint64_t icm42688_psd_acc_t;  /**< Periodogram accumulator (|X/N|^2 in Q8, reset before 2^26 full-scale frames) */
+#else
+typedef double icm42688_psd_acc_t;    /**< Periodogram accumulator (|X|^2) */
+#endif
+
+/**
+ * @brief Spectrum analyzer state
+ */
+typedef struct {
+    int16_t ring[ICM42688_SPECTRUM_AXES][ICM42688_SPECTRUM_N]; /**< Last N samples per axis */
+    uint16_t pos;                                              /**< Next write index in ring */
+    uint16_t fill;                                             /**< Samples since last frame */
+    uint32_t seen;                                             /**< Samples pushed (saturating at N) */
+#if ICM42688_SPECTRUM_FIXED
+    int16_t window[ICM42688_SPECTRUM_N];                       /**< Hann window, Q15 */
+    int16_t twiddle[2 * ICM42688_SPECTRUM_N];                  /**< cos/sin pairs of 2*pi*k/N, Q15 */
+    int16_t work[2 * ICM42688_SPECTRUM_N];                     /**< Interleaved re/im work buffer */
+#else
+    float window[ICM42688_SPECTRUM_N];                         /**< Hann window */
+    float tw_re[ICM42688_SPECTRUM_N];                          /**< Per-stage twiddles, real */
+    float tw_im[ICM42688_SPECTRUM_N];                          /**< Per-stage twiddles, imaginary */
+    float re[ICM42688_SPECTRUM_N];                             /**< Work buffer, real */
+    float im[ICM42688_SPECTRUM_N];                             /**< Work buffer, imaginary */
+#endif
+    uint16_t reorder[ICM42688_SPECTRUM_N];                     /**< Bit/digit reversal table */
+    icm42688_psd_acc_t psd[ICM42688_SPECTRUM_AXES][ICM42688_SPECTRUM_BINS]; /**< Welch accumulators */
+    uint32_t frames;                                           /**< Frames averaged */
+    float fs_hz;                                               /**< Sample rate */
+    float window_power;                                        /**< Sum of squared window coefficients */
+} icm42688_spectrum_t;
+
+/**
+ * @brief Spectral peak
+ */
+typedef struct {
+    float freq_hz;  /**< Interpolated peak frequency */
+    float power;    /**< PSD value at peak bin (LSB^2/Hz) */
+} icm42688_peak_t;
+
+#if ICM42688_CFG_SPECTRUM
+/**
+ * @brief Initialize analyzer (builds window and twiddle tables)
+ * @param sp Pointer to analyzer state
+ * @param fs_hz Sample rate in Hz
+ * @return 0 on success, negative value on error
+ */
+int icm42688_spectrum_init(icm42688_spectrum_t *sp, float fs_hz);
+
+/**
+ * @brief Push one sample; runs a frame every ICM42688_SPECTRUM_HOP samples
+ * @param sp Pointer to analyzer state
+ * @param data Pointer to sample
+ * @return 1 if a frame was added to the average, 0 otherwise, negative value on error
+ */
+int icm42688_spectrum_push(icm42688_spectrum_t *sp, const icm42688_data_t *data);
+
+/**
+ * @brief Clear Welch average (sample history is kept)
+ * @param sp Pointer to analyzer state
+ */
+void icm42688_spectrum_reset(icm42688_spectrum_t *sp);
+
+/**
+ * @brief Get one-sided Welch PSD of an axis
+ * @param sp Pointer to analyzer state
+ * @param axis Axis index
+ * @param psd Output array of ICM42688_SPECTRUM_BINS values in LSB^2/Hz
+ * @return 0 on success, negative value on error (-3 if no frame averaged yet)
+ */
+int icm42688_spectrum_get_psd(const icm42688_spectrum_t *sp, icm42688_axis_t axis, float *psd);
+
+/**
+ * @brief Find largest PSD peak above DC
+ * @param sp Pointer to analyzer state
+ * @param axis Axis index
+ * @param peak Pointer to peak result
+ * @return 0 on success, negative value on error (-3 if no frame averaged yet)
+ */
+int icm42688_spectrum_peak(const icm42688_spectrum_t *sp, icm42688_axis_t axis, icm42688_peak_t *peak);
+
+/**
+ * @brief Integrate PSD over a frequency band
+ * @param sp Pointer to analyzer state
+ * @param axis Axis index
+ * @param f_lo_hz Lower band edge
+ * @param f_hi_hz Upper band edge
+ * @param energy Pointer to band energy (variance in LSB^2)
+ * @return 0 on success, negative value on error (-3 if no frame averaged yet)
+ */
+int icm42688_spectrum_band_energy(const icm42688_spectrum_t *sp, icm42688_axis_t axis,
+                                  float f_lo_hz, float f_hi_hz, float *energy);
+#endif /* ICM42688_CFG_SPECTRUM */
+
+#endif // SPECTRUM_H
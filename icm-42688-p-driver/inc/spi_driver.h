@@ -9,7 +9,9 @@
 #define SPI_DRIVER_H
 
 #include <stdint.h>
+#include "icm42688_config.h"
 
+#if ICM42688_CFG_SPI
 /**
  * @brief SPI read wrapper function
  * @param reg Register address
@@ -37,5 +39,6 @@ void spi_cs_enable(void);
  * @brief Disable chip select (CS)
  */
 void spi_cs_disable(void);
+#endif /* ICM42688_CFG_SPI */
 
 #endif // SPI_DRIVER_H
\ No newline at end of file
@@ -0,0 +1,187 @@
+/**
+ * @file time_align.h
+ * @brief Cross-sensor clock alignment and k-way timestamp merge of ICM-42688 streams
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Every sensor runs from its own free-running clock. The clock estimator fits
+ * host_time = offset + skew * sensor_time by least squares over a sliding
+ * window of (sensor timestamp, host timestamp) pairs taken at interrupt or
+ * read time, and maps sensor sample timestamps onto the host time base.
+ * Sensor timestamps are free-running counters of a configurable width (16 bit
+ * for FIFO packet timestamps, 20 bit for TMST_VAL); they are unwrapped by
+ * sign-extending the difference to the previous observation, so consecutive
+ * observations must be less than half a counter period apart.
+ *
+ * The merger combines per-device sample batches into one stream ordered by
+ * host time with a binary min-heap over the stream heads: O(log k) per sample,
+ * and samples are returned by pointer into the caller's batches, never copied.
+ * A stream that is open but has no pending data stalls the merge, because a
+ * later batch of that stream could still contain earlier samples.
+ *
+ * A refit moves the keys of one stream only. Call icm42688_merge_refit()
+ * after icm42688_clock_add() so that stream's head is re-keyed and sifted in
+ * O(log k); otherwise its key is refreshed the next time the stream is fed or
+ * popped. Samples already returned are not revisited: output timestamps are
+ * clamped to never go below the previous item, so a refit that pulls a head
+ * behind what was already emitted yields an equal timestamp, not a step back.
+ */
+
+#ifndef TIME_ALIGN_H
+#define TIME_ALIGN_H
+
+#include <stdint.h>
+#include "icm-42688.h"
+
+#ifndef ICM42688_TIMESYNC_WINDOW
+#define ICM42688_TIMESYNC_WINDOW 32  /**< Timestamp pairs in regression window */
+#endif
+
+#define ICM42688_TS_BITS_FIFO 16 /**< FIFO packet 3/4 timestamp width */
+#define ICM42688_TS_BITS_TMST 20 /**< TMST_VAL register width */
+
+#ifndef ICM42688_MERGE_MAX_STREAMS
+#define ICM42688_MERGE_MAX_STREAMS 16 /**< Maximum merged streams */
+#endif
+
+/**
+ * @brief Sensor clock estimator
+ */
+typedef struct {
+    int64_t sensor_us[ICM42688_TIMESYNC_WINDOW]; /**< Unwrapped sensor timestamps */
+    int64_t host_us[ICM42688_TIMESYNC_WINDOW];   /**< Matching host timestamps */
+    uint8_t count;                               /**< Valid pairs */
+    uint8_t pos;                                 /**< Next slot */
+    uint32_t ts_mask;                            /**< Sensor counter mask (2^bits - 1) */
+    uint32_t updates;                            /**< Number of refits, lets the merger skip unchanged keys */
+    uint32_t last_raw;                           /**< Last raw sensor timestamp */
+    int64_t last_unwrapped;                      /**< Unwrapped value of last_raw */
+    int64_t ref_sensor_us;                       /**< Fit origin, sensor side */
+    int64_t ref_host_us;                         /**< Fit origin, host side */
+    double offset_us;                            /**< Host time at ref_sensor_us, relative to ref_host_us */
+    double skew;                                 /**< Host microseconds per sensor microsecond */
+} icm42688_clock_est_t;
+
+/**
+ * @brief Merge input stream
+ */
+typedef struct {
+    const icm42688_data_t *samples;     /**< Current batch */
+    const uint32_t *sensor_ts;          /**< Sensor timestamps of current batch */
+    uint32_t count;                     /**< Samples in batch */
+    uint32_t pos;                       /**< Next sample */
+    const icm42688_clock_est_t *clock;  /**< Clock used to map timestamps */
+    uint32_t clock_updates;             /**< clock->updates when the head key was computed */
+    uint8_t open;                       /**< More batches may follow */
+} icm42688_merge_stream_t;
+
+/**
+ * @brief Heap node
+ */
+typedef struct {
+    int64_t host_us; /**< Host time of stream head */
+    uint8_t stream;  /**< Stream index */
+} icm42688_merge_node_t;
+
+/**
+ * @brief Merged output item (points into caller's batch)
+ */
+typedef struct {
+    int64_t host_us;                /**< Aligned host timestamp */
+    const icm42688_data_t *sample;  /**< Sample */
+    uint8_t stream;                 /**< Source stream */
+} icm42688_merge_item_t;
+
+/**
+ * @brief K-way merger
+ */
+typedef struct {
+    icm42688_merge_stream_t streams[ICM42688_MERGE_MAX_STREAMS]; /**< Inputs */
+    icm42688_merge_node_t heap[ICM42688_MERGE_MAX_STREAMS];      /**< Min-heap of stream heads */
+    uint8_t where[ICM42688_MERGE_MAX_STREAMS];                   /**< Heap index of each pending stream */
+    uint8_t k;                                                   /**< Number of streams */
+    uint8_t size;                                                /**< Heap size */
+    uint8_t starved;                                             /**< Open streams without pending data */
+    int64_t last_host_us;                                        /**< Timestamp of the last item returned */
+} icm42688_merge_t;
+
+#if ICM42688_CFG_TIME_ALIGN
+/**
+ * @brief Initialize clock estimator
+ * @param est Pointer to estimator
+ * @param ts_bits Sensor counter width in bits (8..32, e.g. ICM42688_TS_BITS_FIFO)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_clock_init(icm42688_clock_est_t *est, uint8_t ts_bits);
+
+/**
+ * @brief Add a timestamp pair and refit offset and skew
+ * @param est Pointer to estimator
+ * @param sensor_us Sensor timestamp (free running, wraps at the counter width)
+ * @param host_us Host timestamp of the same event
+ * @return 0 on success, negative value on error
+ */
+int icm42688_clock_add(icm42688_clock_est_t *est, uint32_t sensor_us, int64_t host_us);
+
+/**
+ * @brief Map a sensor timestamp near the latest observation to host time
+ * @param est Pointer to estimator
+ * @param sensor_us Sensor timestamp, within half a counter period of the latest observation
+ * @return Host timestamp in microseconds (0 if no pair has been added)
+ */
+int64_t icm42688_clock_map(const icm42688_clock_est_t *est, uint32_t sensor_us);
+
+/**
+ * @brief Initialize merger; all streams start open and empty
+ * @param m Pointer to merger
+ * @param k Number of streams (1..ICM42688_MERGE_MAX_STREAMS)
+ * @param clocks Array of k clock estimators (one per stream)
+ * @return 0 on success, negative value on error
+ */
+int icm42688_merge_init(icm42688_merge_t *m, uint8_t k, const icm42688_clock_est_t *clocks);
+
+/**
+ * @brief Provide the next batch of a stream (previous batch must be consumed)
+ * @param m Pointer to merger
+ * @param stream Stream index
+ * @param samples Samples, must stay valid until consumed
+ * @param sensor_ts Sensor timestamps, ascending
+ * @param count Number of samples
+ * @return 0 on success, negative value on error (-3 if previous batch is pending)
+ */
+int icm42688_merge_feed(icm42688_merge_t *m, uint8_t stream, const icm42688_data_t *samples,
+                        const uint32_t *sensor_ts, uint32_t count);
+
+/**
+ * @brief Mark a stream as finished so it no longer stalls the merge
+ * @param m Pointer to merger
+ * @param stream Stream index
+ * @return 0 on success, negative value on error
+ */
+int icm42688_merge_close(icm42688_merge_t *m, uint8_t stream);
+
+/**
+ * @brief Re-key a stream's pending head after its clock was refit
+ * @param m Pointer to merger
+ * @param stream Stream index
+ * @return 0 on success (also if nothing is pending or the clock is unchanged), negative value on error
+ */
+int icm42688_merge_refit(icm42688_merge_t *m, uint8_t stream);
+
+/**
+ * @brief Pop the earliest sample across all streams
+ * @param m Pointer to merger
+ * @param item Pointer to output item (host_us never below the previous item's)
+ * @return 1 if an item was produced, 0 if empty or stalled on an open stream, negative value on error
+ */
+int icm42688_merge_next(icm42688_merge_t *m, icm42688_merge_item_t *item);
+
+/**
+ * @brief Index of a stream stalling the merge
+ * @param m Pointer to merger
+ * @return Stream index, or -1 if no stream is starved
+ */
+int icm42688_merge_starved_stream(const icm42688_merge_t *m);
+#endif /* ICM42688_CFG_TIME_ALIGN */
+
+#endif // TIME_ALIGN_H
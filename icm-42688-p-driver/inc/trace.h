@@ -0,0 +1,177 @@
+/**
+ * @file trace.h
+ * @brief Optional pipeline tracing with cycle-counter timestamps
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ *
+ * Build with ICM42688_TRACE_ENABLE defined to record begin/end/instant events
+ * around driver stages (bus transfers, register decode, FIFO parse, interrupt
+ * entry) and around application code. Without it every ICM42688_TRACE_* macro
+ * expands to nothing and trace.c compiles to an empty translation unit.
+ *
+ * Timestamps are DWT->CYCCNT cycles on Cortex-M3/M4/M7 and CLOCK_MONOTONIC
+ * nanoseconds on Linux. Cortex-M0/M0+ has no cycle counter: there the
+ * timestamp is the SysTick count extended by the millisecond tick
+ * (ICM42688_TRACE_TICK(), HAL_GetTick() by default), so SysTick must run from
+ * the core clock with one reload per tick, as the STM32 HAL sets it up.
+ * Events go into a fixed ring per core; a slot is reserved with one atomic
+ * increment, so recording is safe from interrupts and from several threads
+ * without locks. The ring keeps the most recent ICM42688_TRACE_DEPTH events
+ * per core (flight recorder). On Linux every record also carries the thread id
+ * of the caller.
+ *
+ * Non-blocking transfers start in one context and finish in an interrupt, so
+ * they do not nest with the other spans; they are recorded as async spans
+ * (ICM42688_TRACE_ASYNC_BEGIN/END) matched by an id instead.
+ *
+ * icm42688_trace_dump() streams the buffers through a caller-supplied write
+ * function (UART, file); example/trace_export converts the dump into Chrome
+ * trace JSON for chrome://tracing or Perfetto.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "icm42688_config.h"
+
+#ifndef ICM42688_TRACE_DEPTH
+#define ICM42688_TRACE_DEPTH 1024  /**< Events per core, power of 2 */
+#endif
+
+#ifndef ICM42688_TRACE_CORES
+#if defined(__linux__)
+#define ICM42688_TRACE_CORES 8     /**< Per-core buffers (CPU number modulo this) */
+#else
+#define ICM42688_TRACE_CORES 1
+#endif
+#endif
+
+#ifndef ICM42688_TRACE_TID
+#if defined(__linux__)
+#define ICM42688_TRACE_TID 1       /**< Record the thread id with every event */
+#else
+#define ICM42688_TRACE_TID 0
+#endif
+#endif
+
+#if !defined(__linux__) && defined(__ARM_ARCH_6M__) && !defined(ICM42688_TRACE_TICK)
+#define ICM42688_TRACE_TICK() HAL_GetTick()  /**< SysTick interrupt count (Cortex-M0 timestamps) */
+#endif
+
+#define ICM42688_TRACE_MAGIC   0x54434D49u  /**< "IMCT" little-endian */
+#define ICM42688_TRACE_VERSION 2
+
+/**
+ * @brief Trace event identifiers
+ */
+typedef enum {
+    ICM42688_TRACE_EV_BUS_READ = 0,  /**< Blocking bus read */
+    ICM42688_TRACE_EV_BUS_WRITE,     /**< Blocking bus write */
+    ICM42688_TRACE_EV_BUS_ASYNC,     /**< Non-blocking transfer, start to completion */
+    ICM42688_TRACE_EV_READ_ALL,      /**< icm42688_read_all */
+    ICM42688_TRACE_EV_DECODE,        /**< Register data decode */
+    ICM42688_TRACE_EV_FIFO_READ,     /**< FIFO data transfer */
+    ICM42688_TRACE_EV_FIFO_PARSE,    /**< FIFO packet parse */
+    ICM42688_TRACE_EV_ISR,           /**< Interrupt entry */
+    ICM42688_TRACE_EV_USER           /**< First application-defined event */
+} icm42688_trace_event_t;
+
+/**
+ * @brief Event phase (matches Chrome trace "ph")
+ */
+typedef enum {
+    ICM42688_TRACE_PH_BEGIN = 'B',   /**< Duration start */
+    ICM42688_TRACE_PH_END = 'E',     /**< Duration end */
+    ICM42688_TRACE_PH_INSTANT = 'i', /**< Point event */
+    ICM42688_TRACE_PH_ASYNC_BEGIN = 'b', /**< Async span start, arg is the span id */
+    ICM42688_TRACE_PH_ASYNC_END = 'e'    /**< Async span end, arg is the span id */
+} icm42688_trace_phase_t;
+
+/**
+ * @brief Trace record (16 bytes, 24 with ICM42688_TRACE_TID; written as-is to the dump)
+ */
+typedef struct {
+    uint64_t ts;      /**< Timestamp (cycles on Cortex-M, 32 bits wrapping; ns on Linux) */
+    uint32_t arg;     /**< Event argument (e.g. byte count), span id for async phases */
+    uint16_t event;   /**< icm42688_trace_event_t or user value */
+    uint8_t phase;    /**< icm42688_trace_phase_t */
+    uint8_t core;     /**< Core index */
+#if ICM42688_TRACE_TID
+    uint32_t tid;     /**< Thread id of the caller */
+    uint32_t reserved;
+#endif
+} icm42688_trace_record_t;
+
+/**
+ * @brief Dump header
+ */
+typedef struct {
+    uint32_t magic;    /**< ICM42688_TRACE_MAGIC */
+    uint16_t version;  /**< ICM42688_TRACE_VERSION */
+    uint8_t ts_bits;   /**< Valid timestamp bits (32 or 64) */
+    uint8_t cores;     /**< Number of per-core sections that follow */
+    uint32_t ts_hz;    /**< Timestamp ticks per second */
+    uint32_t depth;    /**< Ring size per core */
+    uint16_t record_size; /**< sizeof(icm42688_trace_record_t); a thread id follows the first 16 bytes if >= 20 */
+    uint16_t reserved;
+} icm42688_trace_header_t;
+
+/**
+ * @brief Dump output function
+ * @param ctx User context
+ * @param data Bytes to write
+ * @param len Number of bytes
+ * @return 0 on success, negative value on error
+ */
+typedef int (*icm42688_trace_write_t)(void *ctx, const void *data, uint32_t len);
+
+#ifdef ICM42688_TRACE_ENABLE
+
+#define ICM42688_TRACE_BEGIN(ev, arg)   icm42688_trace_record((uint16_t)(ev), ICM42688_TRACE_PH_BEGIN, (uint32_t)(arg))
+#define ICM42688_TRACE_END(ev, arg)     icm42688_trace_record((uint16_t)(ev), ICM42688_TRACE_PH_END, (uint32_t)(arg))
+#define ICM42688_TRACE_INSTANT(ev, arg) icm42688_trace_record((uint16_t)(ev), ICM42688_TRACE_PH_INSTANT, (uint32_t)(arg))
+#define ICM42688_TRACE_ISR(irq)         ICM42688_TRACE_INSTANT(ICM42688_TRACE_EV_ISR, irq)
+#define ICM42688_TRACE_ASYNC_BEGIN(ev, id) icm42688_trace_record((uint16_t)(ev), ICM42688_TRACE_PH_ASYNC_BEGIN, (uint32_t)(id))
+#define ICM42688_TRACE_ASYNC_END(ev, id)   icm42688_trace_record((uint16_t)(ev), ICM42688_TRACE_PH_ASYNC_END, (uint32_t)(id))
+
+/**
+ * @brief Initialize tracing and start the timestamp source
+ * @param ts_hz Timestamp rate on Cortex-M (core clock, e.g. SystemCoreClock, which is also
+ *              the SysTick clock on Cortex-M0); ignored on Linux
+ */
+void icm42688_trace_init(uint32_t ts_hz);
+
+/**
+ * @brief Record an event (use the ICM42688_TRACE_* macros)
+ * @param event Event identifier
+ * @param phase Event phase
+ * @param arg Event argument
+ */
+void icm42688_trace_record(uint16_t event, uint8_t phase, uint32_t arg);
+
+/**
+ * @brief Write header and per-core buffers (stop recording first for a consistent snapshot)
+ *
+ * Layout: icm42688_trace_header_t, then for every core a uint32_t record
+ * count followed by that many icm42688_trace_record_t, oldest first.
+ * All fields little-endian.
+ *
+ * @param write Output function
+ * @param ctx Output function context
+ * @return 0 on success, negative value on error
+ */
+int icm42688_trace_dump(icm42688_trace_write_t write, void *ctx);
+
+#else
+
+#define ICM42688_TRACE_BEGIN(ev, arg)   ((void)0)
+#define ICM42688_TRACE_END(ev, arg)     ((void)0)
+#define ICM42688_TRACE_INSTANT(ev, arg) ((void)0)
+#define ICM42688_TRACE_ISR(irq)         ((void)0)
+#define ICM42688_TRACE_ASYNC_BEGIN(ev, id) ((void)0)
+#define ICM42688_TRACE_ASYNC_END(ev, id)   ((void)0)
+
+#endif // ICM42688_TRACE_ENABLE
+
+#endif // TRACE_H
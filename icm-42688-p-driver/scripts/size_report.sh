@@ -0,0 +1,102 @@
+#!/bin/sh
+# Compile the driver in the MINIMAL, TYPICAL and FULL profiles (icm42688_config.h)
+# and report per-object .text/.data/.bss sizes.
+#
+# Usage: scripts/size_report.sh [-o report.txt] [-b baseline.txt]
+#
+#   -o FILE   also write the report to FILE (commit it as the baseline)
+#   -b FILE   compare against a previous report; exit 1 if any profile's
+#             flash (text+data) or RAM (data+bss) total grew by more than
+#             SIZE_TOLERANCE bytes (default 0)
+#
+# Environment:
+#   CC, SIZE      toolchain (default arm-none-eabi-gcc, arm-none-eabi-size)
+#   ARCH_FLAGS    target flags (default -mcpu=cortex-m3 -mthumb)
+#   CFLAGS        extra flags, e.g. -DICM42688_CFG_TRACE=1
+#   HAL_INC       space-separated include dirs for stm32f1xx_hal.h and the
+#                 device header; i2c_driver.c and spi_driver.c are skipped
+#                 without it
+#   HAL_DEFS      device define (default -DSTM32F103xB)
+#
+# Objects are compiled with -Os -ffunction-sections -fdata-sections; the
+# numbers are per object before linking, so unused functions still count.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CC=${CC:-arm-none-eabi-gcc}
+SIZE=${SIZE:-arm-none-eabi-size}
+ARCH_FLAGS=${ARCH_FLAGS--mcpu=cortex-m3 -mthumb}
+HAL_DEFS=${HAL_DEFS:--DSTM32F103xB}
+SIZE_TOLERANCE=${SIZE_TOLERANCE:-0}
+
+out=""
+baseline=""
+while getopts "o:b:" opt; do
+    case $opt in
+        o) out=$OPTARG ;;
+        b) baseline=$OPTARG ;;
+        *) echo "usage: $0 [-o report.txt] [-b baseline.txt]" >&2; exit 2 ;;
+    esac
+done
+
+command -v "$CC" >/dev/null || { echo "$CC not found" >&2; exit 2; }
+command -v "$SIZE" >/dev/null || { echo "$SIZE not found" >&2; exit 2; }
+
+hal_flags=""
+for d in $HAL_INC; do
+    hal_flags="$hal_flags -I$d"
+done
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+report=$tmp/report.txt
+
+for profile in MINIMAL TYPICAL FULL; do
+    mkdir -p "$tmp/$profile"
+    for src in "$ROOT"/src/*.c; do
+        name=$(basename "$src" .c)
+        flags="$ARCH_FLAGS -std=c11 -Os -ffunction-sections -fdata-sections -I$ROOT/inc"
+        flags="$flags -DICM42688_PROFILE=ICM42688_PROFILE_$profile $CFLAGS"
+
+        if grep -q '"stm32f1xx_hal.h"' "$src"; then
+            if [ -z "$HAL_INC" ]; then
+                echo "# $profile $name skipped (set HAL_INC)" >&2
+                continue
+            fi
+            flags="$flags $HAL_DEFS $hal_flags"
+        fi
+
+        # shellcheck disable=SC2086
+        $CC $flags -c "$src" -o "$tmp/$profile/$name.o"
+    done
+
+    # Berkeley format: text data bss dec hex filename
+    $SIZE "$tmp/$profile"/*.o | awk -v p="$profile" 'NR > 1 {
+        n = $6; sub(".*/", "", n); sub("\\.o$", "", n)
+        printf "%-8s %-16s %7d %7d %7d\n", p, n, $1, $2, $3
+        t += $1; d += $2; b += $3
+    } END {
+        printf "%-8s %-16s %7d %7d %7d\n", p, "TOTAL", t, d, b
+    }' >> "$report"
+done
+
+{
+    printf "%-8s %-16s %7s %7s %7s\n" "profile" "object" "text" "data" "bss"
+    cat "$report"
+} | tee "$tmp/out.txt"
+
+[ -n "$out" ] && cp "$tmp/out.txt" "$out"
+
+if [ -n "$baseline" ]; then
+    awk -v tol="$SIZE_TOLERANCE" '
+        $2 != "TOTAL" { next }
+        FNR == NR { flash[$1] = $3 + $4; ram[$1] = $4 + $5; next }
+        ($1 in flash) {
+            df = $3 + $4 - flash[$1]; dr = $4 + $5 - ram[$1]
+            printf "%-8s flash %+d  ram %+d\n", $1, df, dr
+            if (df > tol || dr > tol) bad = 1
+        }
+        END { exit bad }
+    ' "$baseline" "$tmp/out.txt" || { echo "footprint regression against $baseline" >&2; exit 1; }
+fi
@@ -0,0 +1,306 @@
+/**
+ * @file allan.c
+ * @brief Allan variance noise characterization implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "allan.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#if ICM42688_CFG_ALLAN
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define OCT  ICM42688_ALLAN_OCTAVES
+#define AXES ICM42688_ALLAN_AXES
+#define L    ICM42688_ALLAN_OVERLAP
+#define R    ICM42688_ALLAN_RING
+
+_Static_assert((L & (L - 1)) == 0, "Allan overlap must be a power of 2");
+
+/* sqrt(2 ln 2 / pi): flat-region Allan deviation per unit of bias instability */
+#define BIAS_INSTABILITY_FACTOR 0.6643f
+
+/**
+ * @brief Log2 of the overlap factor
+ * @return log2(ICM42688_ALLAN_OVERLAP)
+ */
+static inline uint32_t overlap_shift(void) {
+    uint32_t s = 0;
+    while((1u << s) < L) s++;
+    return s;
+}
+
+/**
+ * @brief Raw sample of one axis
+ * @param d Sample
+ * @param axis Axis index
+ * @return Raw value
+ */
+static inline int32_t axis_value(const icm42688_data_t *d, int axis) {
+    switch(axis) {
+        case ICM42688_AXIS_ACCEL_X: return d->accel_x;
+        case ICM42688_AXIS_ACCEL_Y: return d->accel_y;
+        case ICM42688_AXIS_ACCEL_Z: return d->accel_z;
+        case ICM42688_AXIS_GYRO_X:  return d->gyro_x;
+        case ICM42688_AXIS_GYRO_Y:  return d->gyro_y;
+        default:                    return d->gyro_z;
+    }
+}
+
+/**
+ * @brief Fit ARW, bias instability and RRW from octave-spaced Allan deviation
+ * @param tau Cluster times
+ * @param adev Allan deviation
+ * @param n Number of points
+ * @param fit Pointer to fit
+ */
+static void fit_noise(const float *tau, const float *adev, uint8_t n, icm42688_noise_fit_t *fit) {
+    memset(fit, 0, sizeof(*fit));
+    if(n == 0) return;
+
+    /* Bias instability: minimum of the curve */
+    uint8_t min = 0;
+    for(uint8_t j = 1; j < n; j++) {
+        if(adev[j] < adev[min]) min = j;
+    }
+    fit->bias_instability = adev[min] / BIAS_INSTABILITY_FACTOR;
+    fit->bias_tau = tau[min];
+
+    if(n < 2) {
+        fit->random_walk = adev[0] * sqrtf(tau[0]);
+        return;
+    }
+
+    /* Random walk terms: segment whose log-log slope is closest to -1/2 and +1/2 */
+    float best_neg = 1e9f, best_pos = 1e9f;
+    for(uint8_t j = 0; j + 1 < n; j++) {
+        if(adev[j] <= 0.0f || adev[j + 1] <= 0.0f) continue;
+        float slope = log2f(adev[j + 1] / adev[j]) / log2f(tau[j + 1] / tau[j]);
+
+        if(fabsf(slope + 0.5f) < best_neg) {
+            best_neg = fabsf(slope + 0.5f);
+            fit->random_walk = adev[j] * sqrtf(tau[j]);
+        }
+        if(slope > 0.25f && fabsf(slope - 0.5f) < best_pos) {
+            best_pos = fabsf(slope - 0.5f);
+            fit->rate_random_walk = adev[j + 1] * sqrtf(3.0f / tau[j + 1]);
+        }
+    }
+}
+
+/**
+ * @brief Fill tau and fits once adev, clusters and octaves are set
+ * @param report Pointer to report
+ * @param tau0 Sample period
+ */
+static void finish_report(icm42688_allan_report_t *report, float tau0) {
+    for(uint8_t j = 0; j < report->octaves; j++) {
+        report->tau[j] = tau0 * (float)(1u << j);
+    }
+    for(int a = 0; a < AXES; a++) {
+        fit_noise(report->tau, report->adev[a], report->octaves, &report->fit[a]);
+    }
+}
+
+int icm42688_allan_init(icm42688_allan_t *av, float odr_hz, float accel_scale, float gyro_scale) {
+    if(!av || !(odr_hz > 0.0f)) return -1;
+
+    memset(av, 0, sizeof(*av));
+    av->tau0 = 1.0f / odr_hz;
+    av->accel_scale = accel_scale;
+    av->gyro_scale = gyro_scale;
+
+    /* S_0 = 0 starts every ring */
+    for(int a = 0; a < AXES; a++) {
+        for(int j = 0; j < OCT; j++) {
+            av->oct[a][j].filled = 1;
+        }
+    }
+    return 0;
+}
+
+int icm42688_allan_push(icm42688_allan_t *av, const icm42688_data_t *data) {
+    if(!av || !data) return -1;
+
+    uint32_t n = ++av->samples;
+    uint32_t shift = overlap_shift();
+
+    for(int a = 0; a < AXES; a++) {
+        int64_t s = (av->sum[a] += axis_value(data, a));
+
+        for(uint32_t j = 0; j < OCT; j++) {
+            /* Octave j stores S every 2^(j - log2 L) samples; strides grow with j */
+            uint32_t stride_shift = j > shift ? j - shift : 0;
+            if(n & ((1u << stride_shift) - 1u)) break;
+
+            icm42688_allan_octave_t *o = &av->oct[a][j];
+            uint32_t q = j > shift ? L : (1u << j);  /* ring entries per cluster */
+
+            o->pos = (uint8_t)(o->pos + 1 == R ? 0 : o->pos + 1);
+            o->ring[o->pos] = s;
+            if(o->filled < R) o->filled++;
+
+            if(o->filled >= 2 * q + 1) {
+                int mid = o->pos - (int)q;
+                int old = o->pos - 2 * (int)q;
+                if(mid < 0) mid += R;
+                if(old < 0) old += R;
+
+                /* S(k+2m) - 2 S(k+m) + S(k): difference of adjacent cluster sums */
+                double d = (double)(s - 2 * o->ring[mid] + o->ring[old]);
+                o->acc += d * d;
+                o->count++;
+            }
+        }
+    }
+    return 0;
+}
+
+int icm42688_allan_report(const icm42688_allan_t *av, icm42688_allan_report_t *report) {
+    if(!av || !report) return -1;
+
+    memset(report, 0, sizeof(*report));
+
+    for(uint8_t j = 0; j < OCT; j++) {
+        if(av->oct[0][j].count == 0) break;
+
+        double m = (double)(1u << j);
+        for(int a = 0; a < AXES; a++) {
+            const icm42688_allan_octave_t *o = &av->oct[a][j];
+            float scale = a < ICM42688_AXIS_GYRO_X ? av->accel_scale : av->gyro_scale;
+            report->adev[a][j] = (float)sqrt(o->acc / (2.0 * m * m * o->count)) * scale;
+        }
+        report->clusters[j] = av->oct[0][j].count;
+        report->octaves = (uint8_t)(j + 1);
+    }
+    if(report->octaves == 0) return -3;
+
+    finish_report(report, av->tau0);
+    return 0;
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Offline job queue shared by the worker threads
+ */
+typedef struct {
+    const icm42688_data_t *samples;
+    uint32_t count;
+    uint8_t octaves;
+    float scale[AXES];
+    icm42688_allan_report_t *report;
+    uint32_t next_job;
+} offline_ctx_t;
+
+/**
+ * @brief Fully overlapping Allan deviation of one axis at one cluster size
+ * @param ctx Offline context
+ * @param axis Axis index
+ * @param j Octave
+ */
+static void offline_job(offline_ctx_t *ctx, int axis, uint32_t j) {
+    static const size_t offsets[AXES] = {
+        offsetof(icm42688_data_t, accel_x), offsetof(icm42688_data_t, accel_y),
+        offsetof(icm42688_data_t, accel_z), offsetof(icm42688_data_t, gyro_x),
+        offsetof(icm42688_data_t, gyro_y), offsetof(icm42688_data_t, gyro_z)
+    };
+    /* Walk one field through the sample array instead of switching per access */
+    const uint8_t *base = (const uint8_t *)ctx->samples + offsets[axis];
+#define X(k) (*(const int16_t *)(base + (size_t)(k) * sizeof(icm42688_data_t)))
+
+    uint32_t m = 1u << j;
+    uint32_t terms = ctx->count - 2 * m + 1;
+    int64_t a = 0, b = 0;
+    double acc = 0.0;
+
+    /* Sliding sums of two adjacent clusters: A = x[k..k+m), B = x[k+m..k+2m) */
+    for(uint32_t i = 0; i < m; i++) {
+        a += X(i);
+        b += X(i + m);
+    }
+    for(uint32_t k = 0;; k++) {
+        double d = (double)(b - a);
+        acc += d * d;
+        if(k + 1 == terms) break;
+
+        int32_t mid = X(k + m);
+        a += mid - X(k);
+        b += X(k + 2 * m) - mid;
+    }
+#undef X
+
+    ctx->report->adev[axis][j] = (float)sqrt(acc / (2.0 * (double)m * m * terms)) * ctx->scale[axis];
+    if(axis == 0) ctx->report->clusters[j] = terms;
+}
+
+/**
+ * @brief Worker thread: take (axis, octave) jobs until none are left
+ * @param arg Offline context
+ * @return NULL
+ */
+static void *offline_worker(void *arg) {
+    offline_ctx_t *ctx = (offline_ctx_t *)arg;
+    uint32_t jobs = (uint32_t)ctx->octaves * AXES;
+
+    for(;;) {
+        /* Longest clusters first: every job costs O(count), so order only balances the tail */
+        uint32_t job = __atomic_fetch_add(&ctx->next_job, 1, __ATOMIC_RELAXED);
+        if(job >= jobs) break;
+        offline_job(ctx, (int)(job % AXES), ctx->octaves - 1u - job / AXES);
+    }
+    return NULL;
+}
+
+int icm42688_allan_offline(const icm42688_data_t *samples, uint32_t count, float odr_hz,
+                           float accel_scale, float gyro_scale, unsigned threads,
+                           icm42688_allan_report_t *report) {
+    if(!samples || !report || !(odr_hz > 0.0f)) return -1;
+
+    memset(report, 0, sizeof(*report));
+
+    offline_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.samples = samples;
+    ctx.count = count;
+    ctx.report = report;
+    for(int a = 0; a < AXES; a++) {
+        ctx.scale[a] = a < ICM42688_AXIS_GYRO_X ? accel_scale : gyro_scale;
+    }
+
+    /* Largest cluster with at least one difference: 2m <= count */
+    while(ctx.octaves < OCT && (2ull << ctx.octaves) <= count) ctx.octaves++;
+    if(ctx.octaves == 0) return -3;
+
+    if(threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if(threads > (unsigned)ctx.octaves * AXES) threads = (unsigned)ctx.octaves * AXES;
+    if(threads > 64) threads = 64;
+
+    pthread_t tid[64];
+    unsigned started = 0;
+    for(; started + 1 < threads; started++) {
+        if(pthread_create(&tid[started], NULL, offline_worker, &ctx) != 0) break;
+    }
+    offline_worker(&ctx);
+    for(unsigned i = 0; i < started; i++) {
+        pthread_join(tid[i], NULL);
+    }
+
+    report->octaves = ctx.octaves;
+    finish_report(report, 1.0f / odr_hz);
+    return 0;
+}
+
+#endif /* __linux__ */
+
+#endif /* ICM42688_CFG_ALLAN */
@@ -0,0 +1,240 @@
+/**
+ * @file autorange.c
+ * @brief Saturation detection and automatic full-scale range selection implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "autorange.h"
+#include <stddef.h>
+#include <string.h>
+
+#if ICM42688_CFG_AUTORANGE
+
+/**
+ * @brief Branch-free rail test
+ * @param v Raw value
+ * @return 1 if v is -32768 or +32767
+ */
+static inline uint8_t railed(int16_t v) {
+    return (uint16_t)(v + 32767) >= 65534u;
+}
+
+/**
+ * @brief Largest absolute value of three axes
+ * @param x X value
+ * @param y Y value
+ * @param z Z value
+ * @return max(|x|, |y|, |z|)
+ */
+static inline int32_t peak3(int16_t x, int16_t y, int16_t z) {
+    int32_t ax = x < 0 ? -(int32_t)x : x;
+    int32_t ay = y < 0 ? -(int32_t)y : y;
+    int32_t az = z < 0 ? -(int32_t)z : z;
+    int32_t m = ax > ay ? ax : ay;
+    return m > az ? m : az;
+}
+
+/**
+ * @brief Make a range change visible to the decoder
+ * @param ctl Range state (fs already holds the new range)
+ * @param old_fs Range of the samples queued before the switch
+ * @param backlog Number of queued samples still in old_fs
+ * @param settle Samples to flag once the new range applies
+ */
+static void schedule_switch(icm42688_range_ctl_t *ctl, uint8_t old_fs, uint16_t backlog, uint8_t settle) {
+    ctl->backlog = backlog;
+    ctl->data_fs = backlog ? old_fs : ctl->fs;
+    ctl->settle = backlog ? 0 : settle;
+    ctl->railed = 0;
+}
+
+/**
+ * @brief Run one sensor's range controller
+ * @param ar Pointer to controller
+ * @param ctl Range state
+ * @param peak Largest absolute raw value of the sample
+ * @param sat Non-zero if an axis of the sample is railed
+ * @param gyro 1 for the gyro, 0 for the accel
+ * @param fifo_bytes If not NULL, receives FIFO_COUNT read just before the range register is written
+ * @return 1 if the range changed, 0 otherwise, negative value on error
+ */
+static int update_range(icm42688_autorange_t *ar, icm42688_range_ctl_t *ctl, int32_t peak, uint8_t sat, int gyro,
+                        uint16_t *fifo_bytes) {
+    const icm42688_autorange_config_t *cfg = &ar->cfg;
+    uint8_t next = ctl->fs;
+
+    /* Taken before the switch, which already accounted for them */
+    if(ctl->backlog) {
+        if(--ctl->backlog == 0) schedule_switch(ctl, ctl->fs, 0, cfg->settle_samples);
+        ctl->quiet = 0;
+        return 0;
+    }
+
+    ctl->railed = sat ? (uint8_t)(ctl->railed < 2 ? ctl->railed + 1 : 2) : 0;
+
+    /* Ignore samples whose scale is not known yet, unless they keep saturating */
+    if(ctl->settle) {
+        ctl->settle--;
+        ctl->quiet = 0;
+        if(ctl->railed < 2) return 0;
+    }
+
+    if(peak >= cfg->up_thresh) {
+        ctl->quiet = 0;
+        if(ctl->fs > ctl->coarsest) next = (uint8_t)(ctl->fs - 1);
+    } else if(peak < cfg->down_thresh) {
+        if(ctl->quiet < cfg->hold_samples) ctl->quiet++;
+        if(ctl->quiet >= cfg->hold_samples && ctl->fs < ctl->finest) next = (uint8_t)(ctl->fs + 1);
+    } else {
+        ctl->quiet = 0;
+    }
+
+    if(next == ctl->fs) return 0;
+
+    /* Whatever is queued now was sampled with the old range; packets landing
+     * during the write are the first after the backlog and get flagged */
+#if ICM42688_CFG_FIFO
+    if(fifo_bytes && icm42688_read_fifo_count(ar->dev, fifo_bytes) != 0) return -2;
+#endif
+    int ret = gyro ? icm42688_set_gyro_fsr(ar->dev, (icm42688_gyro_fs_t)next)
+                   : icm42688_set_accel_fsr(ar->dev, (icm42688_accel_fs_t)next);
+    if(ret != 0) return -2;
+
+    uint8_t old = ctl->fs;
+    ctl->fs = next;
+    ctl->quiet = 0;
+    ctl->switches++;
+    schedule_switch(ctl, old, 0, cfg->settle_samples);
+    return 1;
+}
+
+/**
+ * @brief Decode one sample with the ranges in effect and run both controllers
+ * @param ar Pointer to controller
+ * @param raw Raw sample
+ * @param out Pointer to ranged sample
+ * @param fifo_bytes NULL for polled data, else FIFO_COUNT before the accel [0] and gyro [1] switch
+ * @return Bit 0 set if the accel range changed, bit 1 for the gyro, negative value on error
+ */
+static int process_sample(icm42688_autorange_t *ar, const icm42688_data_t *raw, icm42688_ranged_sample_t *out,
+                          uint16_t *fifo_bytes) {
+    icm42688_range_decode(raw, ar->accel.data_fs, ar->gyro.data_fs, out);
+    if(ar->accel.settle) out->flags |= ICM42688_RANGE_ACCEL_SETTLING;
+    if(ar->gyro.settle) out->flags |= ICM42688_RANGE_GYRO_SETTLING;
+
+    int ra = update_range(ar, &ar->accel, peak3(raw->accel_x, raw->accel_y, raw->accel_z),
+                          out->sat_mask & (ICM42688_SAT_ACCEL_X | ICM42688_SAT_ACCEL_Y | ICM42688_SAT_ACCEL_Z), 0,
+                          fifo_bytes);
+    int rg = update_range(ar, &ar->gyro, peak3(raw->gyro_x, raw->gyro_y, raw->gyro_z),
+                          out->sat_mask & (ICM42688_SAT_GYRO_X | ICM42688_SAT_GYRO_Y | ICM42688_SAT_GYRO_Z), 1,
+                          fifo_bytes ? &fifo_bytes[1] : NULL);
+
+    if(ra < 0 || rg < 0) return -2;
+    return ra | (rg << 1);
+}
+
+void icm42688_autorange_config_default(icm42688_autorange_config_t *cfg) {
+    if(!cfg) return;
+
+    cfg->accel_coarsest = ICM42688_ACCEL_FS_16G;
+    cfg->accel_finest = ICM42688_ACCEL_FS_2G;
+    cfg->gyro_coarsest = ICM42688_GYRO_FS_2000DPS;
+    cfg->gyro_finest = ICM42688_GYRO_FS_15_625DPS;
+    cfg->up_thresh = 30000;
+    cfg->down_thresh = 12000;  /* 24000 after switching finer, still below up_thresh */
+    cfg->hold_samples = 200;
+    cfg->settle_samples = 2;
+}
+
+int icm42688_autorange_init(icm42688_autorange_t *ar, icm42688_t *dev, const icm42688_autorange_config_t *cfg,
+                            icm42688_accel_fs_t accel_fs, icm42688_gyro_fs_t gyro_fs) {
+    if(!ar || !dev) return -1;
+
+    memset(ar, 0, sizeof(*ar));
+    ar->dev = dev;
+    if(cfg) {
+        ar->cfg = *cfg;
+    } else {
+        icm42688_autorange_config_default(&ar->cfg);
+    }
+
+    const icm42688_autorange_config_t *c = &ar->cfg;
+    if(c->accel_coarsest > c->accel_finest || c->accel_finest > ICM42688_ACCEL_FS_2G) return -1;
+    if(c->gyro_coarsest > c->gyro_finest || c->gyro_finest > ICM42688_GYRO_FS_15_625DPS) return -1;
+    if(c->down_thresh <= 0 || c->down_thresh * 2 >= c->up_thresh) return -1;
+    if(accel_fs < c->accel_coarsest || accel_fs > c->accel_finest) return -1;
+    if(gyro_fs < c->gyro_coarsest || gyro_fs > c->gyro_finest) return -1;
+
+    ar->accel.fs = (uint8_t)accel_fs;
+    ar->accel.data_fs = (uint8_t)accel_fs;
+    ar->accel.coarsest = c->accel_coarsest;
+    ar->accel.finest = c->accel_finest;
+    ar->gyro.fs = (uint8_t)gyro_fs;
+    ar->gyro.data_fs = (uint8_t)gyro_fs;
+    ar->gyro.coarsest = c->gyro_coarsest;
+    ar->gyro.finest = c->gyro_finest;
+
+    if(icm42688_set_accel_fsr(dev, accel_fs) != 0) return -2;
+    if(icm42688_set_gyro_fsr(dev, gyro_fs) != 0) return -2;
+    return 0;
+}
+
+void icm42688_range_decode(const icm42688_data_t *raw, uint8_t accel_fs, uint8_t gyro_fs,
+                           icm42688_ranged_sample_t *out) {
+    /* One coarser range step doubles the LSB weight */
+    int32_t ka = (int32_t)1 << (ICM42688_ACCEL_FS_2G - accel_fs);
+    int32_t kg = (int32_t)1 << (ICM42688_GYRO_FS_15_625DPS - gyro_fs);
+
+    out->accel[0] = raw->accel_x * ka;
+    out->accel[1] = raw->accel_y * ka;
+    out->accel[2] = raw->accel_z * ka;
+    out->gyro[0] = raw->gyro_x * kg;
+    out->gyro[1] = raw->gyro_y * kg;
+    out->gyro[2] = raw->gyro_z * kg;
+    out->temp = raw->temp;
+    out->accel_fs = accel_fs;
+    out->gyro_fs = gyro_fs;
+    out->sat_mask = (uint8_t)(railed(raw->accel_x) | (railed(raw->accel_y) << 1) | (railed(raw->accel_z) << 2) |
+                              (railed(raw->gyro_x) << 3) | (railed(raw->gyro_y) << 4) | (railed(raw->gyro_z) << 5));
+    out->flags = 0;
+}
+
+int icm42688_autorange_process(icm42688_autorange_t *ar, const icm42688_data_t *raw,
+                               icm42688_ranged_sample_t *out) {
+    if(!ar || !raw || !out) return -1;
+
+    int r = process_sample(ar, raw, out, NULL);
+    if(r < 0) return -2;
+    return r ? 1 : 0;
+}
+
+#if ICM42688_CFG_FIFO
+int icm42688_autorange_process_fifo(icm42688_autorange_t *ar, const icm42688_data_t *raw, uint16_t count,
+                                    uint8_t packet_size, icm42688_ranged_sample_t *out) {
+    if(!ar || !raw || !out || packet_size == 0) return -1;
+
+    int changed = 0;
+    for(uint16_t i = 0; i < count; i++) {
+        uint16_t bytes[2];
+        int r = process_sample(ar, &raw[i], &out[i], bytes);
+        if(r < 0) return -2;
+        if(r == 0) continue;
+        changed = 1;
+
+        /* Everything queued before the register write was sampled with the old range */
+        uint16_t rest = (uint16_t)(count - 1 - i);
+        if(r & 1) {
+            schedule_switch(&ar->accel, out[i].accel_fs, (uint16_t)(rest + bytes[0] / packet_size),
+                            ar->cfg.settle_samples);
+        }
+        if(r & 2) {
+            schedule_switch(&ar->gyro, out[i].gyro_fs, (uint16_t)(rest + bytes[1] / packet_size),
+                            ar->cfg.settle_samples);
+        }
+    }
+    return changed;
+}
+#endif
+
+#endif /* ICM42688_CFG_AUTORANGE */
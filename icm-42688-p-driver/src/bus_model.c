@@ -0,0 +1,147 @@
+/**
+ * @file bus_model.c
+ * @brief Bus timing model and capacity planner implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "bus_model.h"
+#include "icm-42688.h"
+#include <string.h>
+
+#if ICM42688_CFG_BUS_MODEL
+
+/**
+ * @brief Convert bus clock cycles to nanoseconds
+ * @param t Pointer to timing
+ * @param bits Clock cycles
+ * @return Duration in nanoseconds
+ */
+static uint32_t bits_ns(const icm42688_bus_timing_t *t, uint32_t bits) {
+    return (uint32_t)(((uint64_t)bits * 1000000000ULL + t->clock_hz - 1) / t->clock_hz);
+}
+
+int icm42688_bus_timing_default(icm42688_bus_timing_t *t, icm42688_bus_type_t type, uint32_t clock_hz) {
+    if(!t || clock_hz == 0) return -1;
+
+    t->type = type;
+    t->clock_hz = clock_hz;
+
+    if(type == ICM42688_BUS_I2C) {
+        /* tBUF from the I2C specification for standard, fast and fast-mode plus */
+        if(clock_hz <= 100000) {
+            t->frame_ns = 4700;
+        } else if(clock_hz <= 400000) {
+            t->frame_ns = 1300;
+        } else {
+            t->frame_ns = 500;
+        }
+        t->byte_gap_ns = 200;
+        t->call_ns = 3000;
+    } else if(type == ICM42688_BUS_SPI) {
+        /* Two HAL_GPIO_WritePin calls around the transfer plus tCS setup/hold */
+        t->frame_ns = 1000;
+        t->byte_gap_ns = 500;
+        t->call_ns = 1500;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+uint32_t icm42688_bus_read_ns(const icm42688_bus_timing_t *t, uint16_t len) {
+    if(!t || t->clock_hz == 0) return 0;
+
+    if(t->type == ICM42688_BUS_I2C) {
+        /* S + addr/W + ACK + reg + ACK + Sr + addr/R + ACK + len * (data + ACK) + P */
+        uint32_t bits = 1 + 9 + 9 + 1 + 9 + 9u * len + 1;
+        return bits_ns(t, bits) + t->frame_ns + t->byte_gap_ns * (3u + len) + t->call_ns;
+    }
+
+    /* CS, register byte (HAL_SPI_Transmit), data bytes (HAL_SPI_Receive), CS */
+    return bits_ns(t, 8u * (1u + len)) + t->frame_ns + t->byte_gap_ns * (1u + len) + 2 * t->call_ns;
+}
+
+uint32_t icm42688_bus_write_ns(const icm42688_bus_timing_t *t, uint16_t len) {
+    if(!t || t->clock_hz == 0) return 0;
+
+    if(t->type == ICM42688_BUS_I2C) {
+        /* S + addr/W + ACK + reg + ACK + len * (data + ACK) + P */
+        uint32_t bits = 1 + 9 + 9 + 9u * len + 1;
+        return bits_ns(t, bits) + t->frame_ns + t->byte_gap_ns * (2u + len) + t->call_ns;
+    }
+
+    return bits_ns(t, 8u * (1u + len)) + t->frame_ns + t->byte_gap_ns * (1u + len) + 2 * t->call_ns;
+}
+
+int icm42688_bus_plan(const icm42688_bus_timing_t *t, const icm42688_bus_device_t *devs, uint8_t count,
+                      icm42688_bus_plan_t *plan) {
+    if(!t || !devs || !plan || t->clock_hz == 0) return -1;
+    if(count == 0 || count > ICM42688_BUS_MAX_DEVICES) return -1;
+
+    memset(plan, 0, sizeof(*plan));
+
+    uint64_t busy_ns = 0;
+    uint64_t total_txn_ns = 0;
+    uint64_t bytes = 0;
+
+    /* Pass 1: cost of one read cycle per device */
+    for(uint8_t i = 0; i < count; i++) {
+        const icm42688_bus_device_t *d = &devs[i];
+        icm42688_bus_device_plan_t *r = &plan->device[i];
+
+        if(d->odr_hz == 0 || d->sample_bytes == 0) return -1;
+        if(d->strategy != ICM42688_READ_PER_SAMPLE && d->strategy != ICM42688_READ_FIFO_BURST) return -1;
+
+        if(d->strategy == ICM42688_READ_FIFO_BURST) {
+            /* The watermark must leave at least one packet of slack in the FIFO */
+            if(d->watermark == 0 || d->watermark >= ICM42688_FIFO_SIZE / d->sample_bytes) return -1;
+            r->transaction_ns = icm42688_bus_read_ns(t, 1) + icm42688_bus_read_ns(t, 2)
+                              + icm42688_bus_read_ns(t, (uint16_t)((uint32_t)d->watermark * d->sample_bytes));
+            r->reads_per_sec = (d->odr_hz + d->watermark - 1) / d->watermark;
+            bytes += (uint64_t)r->reads_per_sec * (3u + (uint32_t)d->watermark * d->sample_bytes);
+        } else {
+            r->transaction_ns = icm42688_bus_read_ns(t, d->sample_bytes);
+            r->reads_per_sec = d->odr_hz;
+            bytes += (uint64_t)r->reads_per_sec * d->sample_bytes;
+        }
+
+        uint64_t per_sec = (uint64_t)r->transaction_ns * r->reads_per_sec;
+        r->bus_ns_per_sec = per_sec > UINT32_MAX ? UINT32_MAX : (uint32_t)per_sec;
+        busy_ns += per_sec;
+        total_txn_ns += r->transaction_ns;
+    }
+
+    plan->utilization = (float)((double)busy_ns / 1e9);
+    plan->headroom = 1.0f - plan->utilization;
+    plan->bytes_per_sec = bytes > UINT32_MAX ? UINT32_MAX : (uint32_t)bytes;
+    plan->feasible = plan->utilization < 1.0f;
+
+    /* Pass 2: worst case, every other device has just started a read cycle */
+    for(uint8_t i = 0; i < count; i++) {
+        const icm42688_bus_device_t *d = &devs[i];
+        icm42688_bus_device_plan_t *r = &plan->device[i];
+        uint64_t period_ns = 1000000000ULL / d->odr_hz;
+        uint64_t blocked = total_txn_ns;  /* others + own */
+        uint64_t latency = blocked;
+        uint64_t deadline;
+
+        if(d->strategy == ICM42688_READ_FIFO_BURST) {
+            /* Oldest sample waits for the watermark; FIFO absorbs the bus delay */
+            latency += period_ns * (d->watermark - 1u);
+            uint32_t slack = (uint32_t)(ICM42688_FIFO_SIZE / d->sample_bytes) - d->watermark;
+            deadline = period_ns * slack;
+        } else {
+            /* Data registers are overwritten at the next ODR tick */
+            deadline = period_ns;
+        }
+
+        r->worst_latency_ns = latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+        r->keeps_up = blocked <= deadline;
+        if(!r->keeps_up) plan->feasible = 0;
+    }
+
+    return 0;
+}
+
+#endif /* ICM42688_CFG_BUS_MODEL */
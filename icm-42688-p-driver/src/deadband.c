@@ -0,0 +1,203 @@
+/**
+ * @file deadband.c
+ * @brief Send-on-delta sample reduction implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "deadband.h"
+#include <string.h>
+
+#if ICM42688_CFG_DEADBAND
+
+#define CH ICM42688_DEADBAND_CHANNELS
+
+/**
+ * @brief Unpack sample channels
+ * @param d Sample data
+ * @param v Output channel values
+ */
+static inline void unpack(const icm42688_data_t *d, int32_t v[CH]) {
+    v[0] = d->accel_x;
+    v[1] = d->accel_y;
+    v[2] = d->accel_z;
+    v[3] = d->gyro_x;
+    v[4] = d->gyro_y;
+    v[5] = d->gyro_z;
+    v[6] = d->temp;
+}
+
+/**
+ * @brief Saturate to int16
+ * @param v Value
+ * @return Clamped value
+ */
+static inline int16_t sat16(int32_t v) {
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+/**
+ * @brief Pack channel values into a sample
+ * @param v Channel values
+ * @param d Output sample data
+ */
+static inline void pack(const int32_t v[CH], icm42688_data_t *d) {
+    d->accel_x = sat16(v[0]);
+    d->accel_y = sat16(v[1]);
+    d->accel_z = sat16(v[2]);
+    d->gyro_x = sat16(v[3]);
+    d->gyro_y = sat16(v[4]);
+    d->gyro_z = sat16(v[5]);
+    d->temp = sat16(v[6]);
+}
+
+/**
+ * @brief Predict channel values k samples after the last sent one
+ * @param m Pointer to predictor
+ * @param k Samples since the last sent one (>= 1)
+ * @param v Output channel values
+ */
+static inline void predict(const icm42688_deadband_model_t *m, uint32_t k, int32_t v[CH]) {
+    for(int c = 0; c < CH; c++) {
+        /* Round to nearest; slope is 0 for the hold predictor */
+        int64_t x = m->last[c] + (((int64_t)m->slope[c] * k + 32768) >> 16);
+        v[c] = (int32_t)(x > 65535 ? 65535 : (x < -65536 ? -65536 : x));
+    }
+}
+
+/**
+ * @brief Advance predictor with a sent sample
+ * @param m Pointer to predictor
+ * @param v Channel values of the sent sample
+ * @param k Samples since the previous sent one (>= 1)
+ * @param ts Timestamp of the sent sample
+ */
+static void model_update(icm42688_deadband_model_t *m, const int32_t v[CH], uint32_t k, uint32_t ts) {
+    for(int c = 0; c < CH; c++) {
+        if(m->predict == ICM42688_PREDICT_LINEAR && m->valid) {
+            int64_t s = ((int64_t)(v[c] - m->last[c]) * 65536) / (int32_t)k;
+            m->slope[c] = (int32_t)(s > INT32_MAX ? INT32_MAX : (s < -INT32_MAX ? -INT32_MAX : s));
+        } else {
+            m->slope[c] = 0;
+        }
+        m->last[c] = v[c];
+    }
+    m->last_ts = ts;
+    m->valid = 1;
+    m->seq++;
+}
+
+void icm42688_deadband_config_default(icm42688_deadband_config_t *cfg) {
+    if(!cfg) return;
+
+    cfg->accel_deadband = 164;   /* 0.01 g at +-2 g */
+    cfg->gyro_deadband = 210;    /* 0.1 dps at +-15.625 dps */
+    cfg->temp_deadband = 66;     /* 0.5 C */
+    cfg->max_interval = 1000;
+    cfg->predict = ICM42688_PREDICT_HOLD;
+}
+
+int icm42688_deadband_init(icm42688_deadband_t *db, const icm42688_deadband_config_t *cfg) {
+    if(!db) return -1;
+
+    memset(db, 0, sizeof(*db));
+    if(cfg) {
+        db->cfg = *cfg;
+    } else {
+        icm42688_deadband_config_default(&db->cfg);
+    }
+    if(db->cfg.max_interval == 0) return -1;
+    if(db->cfg.predict != ICM42688_PREDICT_HOLD && db->cfg.predict != ICM42688_PREDICT_LINEAR) return -1;
+
+    for(int c = 0; c < 3; c++) {
+        db->band[c] = db->cfg.accel_deadband;
+        db->band[3 + c] = db->cfg.gyro_deadband;
+    }
+    db->band[6] = db->cfg.temp_deadband;
+
+    icm42688_deadband_model_init(&db->model, db->cfg.predict);
+    return 0;
+}
+
+int icm42688_deadband_process(icm42688_deadband_t *db, const icm42688_sample_t *in,
+                              icm42688_reduced_sample_t *out) {
+    if(!db || !in || !out) return -1;
+
+    int32_t v[CH];
+    int32_t p[CH];
+    uint32_t k = db->since + 1;
+    uint32_t over = 0;
+
+    unpack(&in->data, v);
+    predict(&db->model, k, p);
+
+    /* Branch-free: OR of the sign bits of (band - |error|) */
+    for(int c = 0; c < CH; c++) {
+        int32_t e = v[c] - p[c];
+        int32_t a = e < 0 ? -e : e;
+        over |= (uint32_t)(db->band[c] - a) >> 31;
+    }
+
+    uint8_t reason = 0;
+    if(!db->model.valid) reason |= ICM42688_EMIT_FIRST;
+    if(over) reason |= ICM42688_EMIT_DELTA;
+    if(k >= db->cfg.max_interval) reason |= ICM42688_EMIT_HEARTBEAT;
+
+    db->stats.in++;
+    if(!reason) {
+        db->since = k;
+        return 0;
+    }
+
+    out->sample = *in;
+    out->skipped = (uint16_t)(db->model.valid ? k - 1 : 0);
+    out->reason = reason;
+    out->seq = db->model.seq;
+
+    model_update(&db->model, v, k, in->timestamp_us);
+    db->since = 0;
+    db->stats.out++;
+    if(reason == ICM42688_EMIT_HEARTBEAT) db->stats.heartbeats++;
+    return 1;
+}
+
+void icm42688_deadband_model_init(icm42688_deadband_model_t *model, icm42688_predict_t predict) {
+    if(!model) return;
+
+    memset(model, 0, sizeof(*model));
+    model->predict = (uint8_t)predict;
+}
+
+int icm42688_deadband_expand(icm42688_deadband_model_t *model, const icm42688_reduced_sample_t *in,
+                             icm42688_sample_t *out, uint32_t max_out) {
+    if(!model || !in || !out) return -1;
+
+    uint32_t k = (uint32_t)in->skipped + 1;
+    if(max_out < k) return -1;
+
+    /* The skipped samples follow one this receiver never saw: nothing to rebuild from */
+    uint8_t gap = !model->valid || in->seq != model->seq;
+    /* Same if the slope is not the sender's yet */
+    uint32_t n = gap || !model->synced ? 1 : k;
+
+    uint32_t dt = in->sample.timestamp_us - model->last_ts;
+    for(uint32_t i = 1; i < n; i++) {
+        int32_t p[CH];
+        predict(model, i, p);
+        pack(p, &out[i - 1].data);
+        out[i - 1].timestamp_us = model->last_ts + (uint32_t)(((uint64_t)dt * i) / k);
+    }
+    out[n - 1] = in->sample;
+
+    int32_t v[CH];
+    unpack(&in->sample.data, v);
+    if(gap) model->valid = 0;
+    model_update(model, v, k, in->sample.timestamp_us);
+    model->seq = (uint8_t)(in->seq + 1);
+
+    /* After a gap the slope restarts at 0, which matches the sender only at its first sample */
+    model->synced = !gap || model->predict == ICM42688_PREDICT_HOLD || (in->reason & ICM42688_EMIT_FIRST);
+    return (int)n;
+}
+
+#endif /* ICM42688_CFG_DEADBAND */
@@ -0,0 +1,140 @@
+/**
+ * @file event_capture.c
+ * @brief Triggered pre/post-event capture implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "event_capture.h"
+#include <stddef.h>
+#include <string.h>
+
+#if ICM42688_CFG_EVENT_CAPTURE
+
+/* Larger than any int16 value or difference: a threshold that never fires */
+#define THRESH_OFF 0x20000
+
+/**
+ * @brief Branch-free |v| > t test for t >= 0
+ * @param v Value
+ * @param t Threshold
+ * @return Nonzero if |v| exceeds t
+ */
+static inline uint32_t exceeds(int32_t v, int32_t t) {
+    return (uint32_t)(v + t) > (uint32_t)(2 * t);
+}
+
+/**
+ * @brief Start a capture: copy the pre-trigger window into a free slot
+ * @param cap Pointer to capture engine
+ * @return 0 on success, -3 if every slot is busy
+ */
+static int start_capture(icm42688_capture_t *cap) {
+    int8_t free_slot = -1;
+    for(int8_t i = 0; i < ICM42688_CAPTURE_SLOTS; i++) {
+        if(cap->slot[i].state == ICM42688_CAPTURE_FREE) {
+            free_slot = i;
+            break;
+        }
+    }
+    if(free_slot < 0) return -3;
+
+    icm42688_capture_slot_t *sl = &cap->slot[free_slot];
+    uint16_t n = cap->pre_count;
+    uint16_t start = (uint16_t)((cap->pre_pos + ICM42688_CAPTURE_PRE - n) % ICM42688_CAPTURE_PRE);
+    uint16_t first = (uint16_t)(ICM42688_CAPTURE_PRE - start);
+    if(first > n) first = n;
+
+    /* Oldest first: tail of the ring, then the wrapped head */
+    memcpy(&sl->samples[0], &cap->pre[start], first * sizeof(icm42688_sample_t));
+    memcpy(&sl->samples[first], &cap->pre[0], (n - first) * sizeof(icm42688_sample_t));
+
+    sl->count = n;
+    sl->trigger_index = n;
+    sl->sequence = cap->stats.triggers++;
+    sl->state = ICM42688_CAPTURE_FILLING;
+    cap->active = free_slot;
+    return 0;
+}
+
+int icm42688_capture_init(icm42688_capture_t *cap, int32_t accel_thresh, int32_t jerk_thresh) {
+    if(!cap || accel_thresh < 0 || jerk_thresh < 0) return -1;
+
+    memset(cap, 0, sizeof(*cap));
+    cap->active = -1;
+    cap->accel_thresh = (accel_thresh == 0 || accel_thresh > THRESH_OFF) ? THRESH_OFF : accel_thresh;
+    cap->jerk_thresh = (jerk_thresh == 0 || jerk_thresh > THRESH_OFF) ? THRESH_OFF : jerk_thresh;
+    return 0;
+}
+
+int icm42688_capture_push(icm42688_capture_t *cap, const icm42688_sample_t *s) {
+    if(!cap || !s) return -1;
+
+    const icm42688_data_t *d = &s->data;
+    int32_t at = cap->accel_thresh;
+    int32_t jt = cap->jerk_thresh;
+
+    /* No jerk reference before the first sample */
+    if(cap->stats.samples++ == 0) {
+        cap->last[0] = d->accel_x;
+        cap->last[1] = d->accel_y;
+        cap->last[2] = d->accel_z;
+    }
+
+    uint32_t hit = exceeds(d->accel_x, at) | exceeds(d->accel_y, at) | exceeds(d->accel_z, at)
+                 | exceeds(d->accel_x - cap->last[0], jt)
+                 | exceeds(d->accel_y - cap->last[1], jt)
+                 | exceeds(d->accel_z - cap->last[2], jt);
+
+    cap->last[0] = d->accel_x;
+    cap->last[1] = d->accel_y;
+    cap->last[2] = d->accel_z;
+
+    /* Triggers during an ongoing capture belong to the same event; a lost
+     * event is counted once, on the sample where the condition starts */
+    if(hit && cap->active < 0 && start_capture(cap) != 0 && !cap->hit_prev) cap->stats.dropped++;
+    cap->hit_prev = hit != 0;
+
+    int ret = 0;
+    if(cap->active >= 0) {
+        icm42688_capture_slot_t *sl = &cap->slot[cap->active];
+        sl->samples[sl->count++] = *s;
+        if(sl->count - sl->trigger_index >= ICM42688_CAPTURE_POST) {
+            sl->state = ICM42688_CAPTURE_READY;
+            cap->active = -1;
+            ret = 1;
+        }
+    }
+
+    /* The pre window keeps running during captures so the next event has history */
+    cap->pre[cap->pre_pos] = *s;
+    cap->pre_pos = (uint16_t)((cap->pre_pos + 1) % ICM42688_CAPTURE_PRE);
+    if(cap->pre_count < ICM42688_CAPTURE_PRE) cap->pre_count++;
+
+    return ret;
+}
+
+const icm42688_capture_slot_t *icm42688_capture_get(const icm42688_capture_t *cap) {
+    if(!cap) return NULL;
+
+    const icm42688_capture_slot_t *oldest = NULL;
+    for(int i = 0; i < ICM42688_CAPTURE_SLOTS; i++) {
+        const icm42688_capture_slot_t *sl = &cap->slot[i];
+        if(sl->state != ICM42688_CAPTURE_READY) continue;
+        if(!oldest || (int32_t)(sl->sequence - oldest->sequence) < 0) oldest = sl;
+    }
+    return oldest;
+}
+
+int icm42688_capture_release(icm42688_capture_t *cap, const icm42688_capture_slot_t *slot) {
+    if(!cap || !slot) return -1;
+    if(slot < &cap->slot[0] || slot >= &cap->slot[ICM42688_CAPTURE_SLOTS]) return -1;
+
+    icm42688_capture_slot_t *sl = &cap->slot[slot - &cap->slot[0]];
+    if(sl->state != ICM42688_CAPTURE_READY) return -3;
+
+    sl->state = ICM42688_CAPTURE_FREE;
+    return 0;
+}
+
+#endif /* ICM42688_CFG_EVENT_CAPTURE */
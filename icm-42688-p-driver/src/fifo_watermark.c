@@ -0,0 +1,166 @@
+/**
+ * @file fifo_watermark.c
+ * @brief Adaptive FIFO watermark controller implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "fifo_watermark.h"
+#include "trace.h"
+
+#if ICM42688_CFG_FIFO_WATERMARK
+
+/**
+ * @brief Program watermark in packets and update statistics
+ * @param ctl Pointer to controller
+ * @param packets Watermark in packets
+ * @return 0 on success, negative value on error
+ */
+static int program_watermark(icm42688_fifo_wm_t *ctl, uint16_t packets) {
+    uint16_t bytes = (uint16_t)(packets * ctl->cfg.packet_size);
+
+    if(icm42688_set_fifo_watermark(ctl->dev, bytes) != 0) return -2;
+
+    ctl->watermark = packets;
+    ctl->stats.reprograms++;
+    return 0;
+}
+
+int icm42688_fifo_wm_init(icm42688_fifo_wm_t *ctl, icm42688_t *dev,
+                          const icm42688_fifo_wm_config_t *cfg) {
+    if(!ctl || !dev || !cfg) return -1;
+    if(cfg->odr_hz == 0 || cfg->packet_size == 0 || cfg->packet_size > ICM42688_FIFO_SIZE) return -1;
+
+    ctl->dev = dev;
+    ctl->cfg = *cfg;
+    if(ctl->cfg.min_packets == 0) ctl->cfg.min_packets = 1;
+    if(ctl->cfg.hysteresis == 0) ctl->cfg.hysteresis = 1;
+
+    ctl->capacity = (uint16_t)(ICM42688_FIFO_SIZE / cfg->packet_size);
+    ctl->period_us = 1000000UL / cfg->odr_hz;
+    if(ctl->period_us == 0) ctl->period_us = 1;
+
+    ctl->drain_us = 0;
+    ctl->quiet_us = 0;
+    ctl->window_start_us = 0;
+    ctl->window_irqs = 0;
+    ctl->window_valid = 0;
+    ctl->overflow_pending = 0;
+    ctl->stats = (icm42688_fifo_wm_stats_t){0};
+
+    return program_watermark(ctl, icm42688_fifo_wm_target(ctl, 0));
+}
+
+uint16_t icm42688_fifo_wm_target(const icm42688_fifo_wm_t *ctl, uint32_t drain_us) {
+    if(!ctl) return 1;
+
+    /* Oldest sample age at consumption is roughly watermark * period + drain time */
+    uint32_t latency_limit = 0;
+    if(ctl->cfg.latency_budget_us > drain_us) {
+        latency_limit = (ctl->cfg.latency_budget_us - drain_us) / ctl->period_us;
+    }
+
+    /* Samples keep arriving while the consumer drains; keep 1/8 of FIFO spare */
+    uint32_t drain_packets = (drain_us + ctl->period_us - 1) / ctl->period_us;
+    uint32_t reserve = drain_packets + ctl->capacity / 8;
+    uint32_t capacity_limit = (reserve < ctl->capacity) ? ctl->capacity - reserve : 1;
+
+    uint32_t target = (latency_limit < capacity_limit) ? latency_limit : capacity_limit;
+    if(target < ctl->cfg.min_packets) target = ctl->cfg.min_packets;
+    if(target > capacity_limit) target = capacity_limit;
+    if(target == 0) target = 1;
+
+    return (uint16_t)target;
+}
+
+void icm42688_fifo_wm_on_interrupt(icm42688_fifo_wm_t *ctl, uint32_t now_us) {
+    if(!ctl) return;
+
+    ICM42688_TRACE_ISR(1);
+    ctl->stats.interrupts++;
+
+    if(!ctl->window_valid) {
+        ctl->window_start_us = now_us;
+        ctl->window_irqs = 0;
+        ctl->window_valid = 1;
+    }
+    ctl->window_irqs++;
+
+    uint32_t elapsed = now_us - ctl->window_start_us;
+    if(elapsed >= 1000000UL) {
+        ctl->stats.interrupts_per_sec = (uint32_t)(((uint64_t)ctl->window_irqs * 1000000UL) / elapsed);
+        ctl->window_start_us = now_us;
+        ctl->window_irqs = 0;
+    }
+}
+
+int icm42688_fifo_wm_drain(icm42688_fifo_wm_t *ctl, uint8_t *buf, uint16_t size, uint16_t *bytes,
+                           uint8_t *int_status) {
+    if(!ctl || !buf || !bytes) return -1;
+
+    uint8_t status = 0;
+    uint16_t count = 0;
+
+    *bytes = 0;
+
+    if(icm42688_read_int_status(ctl->dev, &status) != 0) return -2;
+    if(int_status) *int_status = status;
+    if(status & ICM42688_INT_STATUS_FIFO_FULL) {
+        ctl->stats.overflows++;
+        ctl->overflow_pending = 1;
+    }
+
+    if(icm42688_read_fifo_count(ctl->dev, &count) != 0) return -2;
+
+    /* Only read whole packets */
+    if(count > size) count = size;
+    count = (uint16_t)(count - (count % ctl->cfg.packet_size));
+    if(count == 0) return 0;
+
+    if(icm42688_read_fifo(ctl->dev, buf, count) != 0) return -2;
+
+    ctl->stats.reads++;
+    ctl->stats.bytes_read += count;
+    ctl->stats.bytes_per_read = (uint16_t)(ctl->stats.bytes_read / ctl->stats.reads);
+
+    *bytes = count;
+    return 0;
+}
+
+int icm42688_fifo_wm_update(icm42688_fifo_wm_t *ctl, uint32_t drain_us) {
+    if(!ctl) return -1;
+
+    /* Follow stalls immediately; relax slowly, and only after a quiet hold period */
+    if(drain_us >= ctl->drain_us) {
+        ctl->drain_us = drain_us;
+        ctl->quiet_us = 0;
+    } else if(ctl->quiet_us < ICM42688_FIFO_WM_HOLD_US) {
+        /* Roughly one watermark of samples passed since the previous update */
+        ctl->quiet_us += (uint32_t)ctl->watermark * ctl->period_us;
+    } else {
+        ctl->drain_us -= (ctl->drain_us - drain_us) / 8;
+    }
+
+    uint16_t target = icm42688_fifo_wm_target(ctl, ctl->drain_us);
+
+    uint8_t overflow = ctl->overflow_pending;
+    if(overflow) {
+        uint16_t halved = (uint16_t)(ctl->watermark / 2);
+        if(halved == 0) halved = 1;
+        if(target > halved) target = halved;
+        ctl->overflow_pending = 0;
+    }
+
+    /* Overflows shrink at once; any other change must be large enough to matter */
+    if(target == ctl->watermark) return 0;
+    if(!overflow) {
+        uint16_t step = target > ctl->watermark ? (uint16_t)(target - ctl->watermark)
+                                                : (uint16_t)(ctl->watermark - target);
+        if(step < ctl->cfg.hysteresis) return 0;
+    }
+
+    if(program_watermark(ctl, target) != 0) return -2;
+    return 1;
+}
+
+#endif /* ICM42688_CFG_FIFO_WATERMARK */
@@ -0,0 +1,304 @@
+/**
+ * @file host_pipeline.c
+ * @brief Multi-threaded host pipeline implementation (Linux)
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#if defined(__linux__)
+
+#include "host_pipeline.h"
+#include <string.h>
+
+#define QUEUE_MASK (ICM42688_PIPELINE_QUEUE_DEPTH - 1)
+#define DEQUE_MASK (ICM42688_PIPELINE_MAX_STREAMS - 1)
+
+_Static_assert((ICM42688_PIPELINE_QUEUE_DEPTH & QUEUE_MASK) == 0, "queue depth must be a power of 2");
+_Static_assert((ICM42688_PIPELINE_MAX_STREAMS & DEQUE_MASK) == 0, "max streams must be a power of 2");
+
+/**
+ * @brief Push stream on the owner end of a deque and wake a sleeping worker
+ * @param p Pointer to pipeline
+ * @param worker Target worker
+ * @param s Stream to push
+ */
+static void deque_push(icm42688_pipeline_t *p, uint16_t worker, icm42688_stream_t *s) {
+    icm42688_deque_t *d = &p->deques[worker];
+
+    /* runnable is updated under the deque lock (then the pipeline lock), so it
+     * always matches the deque contents and a thief can never decrement first */
+    pthread_mutex_lock(&d->lock);
+    d->items[d->bottom & DEQUE_MASK] = s;
+    d->bottom++;
+
+    pthread_mutex_lock(&p->lock);
+    p->runnable++;
+    pthread_cond_signal(&p->work);
+    pthread_mutex_unlock(&p->lock);
+    pthread_mutex_unlock(&d->lock);
+}
+
+/**
+ * @brief Account for a stream taken off a deque (deque lock held)
+ * @param p Pointer to pipeline
+ */
+static void runnable_take(icm42688_pipeline_t *p) {
+    pthread_mutex_lock(&p->lock);
+    p->runnable--;
+    pthread_mutex_unlock(&p->lock);
+}
+
+/**
+ * @brief Pop stream from the owner end (LIFO keeps the stream's data cache-hot)
+ * @param p Pointer to pipeline
+ * @param d Pointer to deque
+ * @return Stream or NULL if empty
+ */
+static icm42688_stream_t *deque_pop(icm42688_pipeline_t *p, icm42688_deque_t *d) {
+    icm42688_stream_t *s = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if(d->bottom != d->top) {
+        d->bottom--;
+        s = d->items[d->bottom & DEQUE_MASK];
+        runnable_take(p);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return s;
+}
+
+/**
+ * @brief Steal stream from the far end of another worker's deque
+ * @param p Pointer to pipeline
+ * @param d Pointer to deque
+ * @return Stream or NULL if empty
+ */
+static icm42688_stream_t *deque_steal(icm42688_pipeline_t *p, icm42688_deque_t *d) {
+    icm42688_stream_t *s = NULL;
+
+    if(pthread_mutex_trylock(&d->lock) != 0) return NULL;
+    if(d->bottom != d->top) {
+        s = d->items[d->top & DEQUE_MASK];
+        d->top++;
+        runnable_take(p);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return s;
+}
+
+/**
+ * @brief Find runnable stream: own deque first, then steal round-robin
+ * @param w Pointer to worker
+ * @return Stream or NULL if none found
+ */
+static icm42688_stream_t *find_work(icm42688_worker_t *w) {
+    icm42688_pipeline_t *p = w->pipeline;
+    icm42688_stream_t *s = deque_pop(p, &p->deques[w->index]);
+
+    for(uint16_t i = 1; !s && i < p->num_workers; i++) {
+        uint16_t victim = (uint16_t)((w->index + i) % p->num_workers);
+        s = deque_steal(p, &p->deques[victim]);
+        if(s) w->steals++;
+    }
+    return s;
+}
+
+/**
+ * @brief Run up to one quantum of batches of a stream, then requeue or release it
+ * @param w Pointer to worker
+ * @param s Stream owned by this worker
+ */
+static void run_stream(icm42688_worker_t *w, icm42688_stream_t *s) {
+    icm42688_pipeline_t *p = w->pipeline;
+    uint32_t done = 0;
+
+    for(uint32_t n = 0; n < ICM42688_PIPELINE_BATCH_QUANTUM; n++) {
+        pthread_mutex_lock(&s->lock);
+        if(s->head == s->tail) {
+            pthread_mutex_unlock(&s->lock);
+            break;
+        }
+        /* Slot stays reserved until head advances, process it outside the lock */
+        icm42688_batch_t *b = &s->queue[s->head & QUEUE_MASK];
+        pthread_mutex_unlock(&s->lock);
+
+        for(uint8_t i = 0; i < s->num_stages; i++) {
+            if(s->stages[i].fn(s->stages[i].ctx, s->id, b->samples, b->count) != 0) {
+                s->errors++;
+            }
+        }
+        s->batches++;
+        s->samples += b->count;
+
+        pthread_mutex_lock(&s->lock);
+        s->head++;
+        pthread_cond_signal(&s->not_full);
+        pthread_mutex_unlock(&s->lock);
+        done++;
+    }
+
+    pthread_mutex_lock(&s->lock);
+    int more = (s->head != s->tail);
+    if(!more) s->scheduled = 0;
+    pthread_mutex_unlock(&s->lock);
+
+    /* Requeue at the owner end: other streams on this deque are stealable meanwhile */
+    if(more) deque_push(p, w->index, s);
+
+    if(done) {
+        pthread_mutex_lock(&p->lock);
+        p->inflight -= done;
+        if(p->inflight == 0) pthread_cond_broadcast(&p->idle);
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+/**
+ * @brief Worker thread entry
+ * @param arg Pointer to worker
+ * @return NULL
+ */
+static void *worker_main(void *arg) {
+    icm42688_worker_t *w = (icm42688_worker_t *)arg;
+    icm42688_pipeline_t *p = w->pipeline;
+
+    for(;;) {
+        icm42688_stream_t *s = find_work(w);
+        if(s) {
+            run_stream(w, s);
+            continue;
+        }
+
+        pthread_mutex_lock(&p->lock);
+        while(p->runnable == 0 && !p->stop) {
+            pthread_cond_wait(&p->work, &p->lock);
+        }
+        int stop = p->stop && p->runnable == 0;
+        pthread_mutex_unlock(&p->lock);
+        if(stop) break;
+    }
+    return NULL;
+}
+
+int icm42688_pipeline_init(icm42688_pipeline_t *p, uint16_t num_workers) {
+    if(!p || num_workers == 0 || num_workers > ICM42688_PIPELINE_MAX_WORKERS) return -1;
+
+    memset(p, 0, sizeof(*p));
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_cond_init(&p->idle, NULL);
+
+    for(uint16_t i = 0; i < num_workers; i++) {
+        pthread_mutex_init(&p->deques[i].lock, NULL);
+    }
+
+    /* Workers read num_workers in find_work, so it is fixed before the first one starts */
+    p->num_workers = num_workers;
+
+    for(uint16_t i = 0; i < num_workers; i++) {
+        p->workers[i].pipeline = p;
+        p->workers[i].index = i;
+        if(pthread_create(&p->workers[i].thread, NULL, worker_main, &p->workers[i]) != 0) {
+            pthread_mutex_lock(&p->lock);
+            p->stop = 1;
+            pthread_cond_broadcast(&p->work);
+            pthread_mutex_unlock(&p->lock);
+
+            for(uint16_t j = 0; j < i; j++) {
+                pthread_join(p->workers[j].thread, NULL);
+            }
+            p->num_workers = 0;
+            return -2;
+        }
+    }
+    return 0;
+}
+
+int icm42688_pipeline_add_stream(icm42688_pipeline_t *p, icm42688_stream_t *s, uint32_t id,
+                                 const icm42688_stage_t *stages, uint8_t num_stages) {
+    if(!p || !s || (!stages && num_stages)) return -1;
+    if(num_stages > ICM42688_PIPELINE_MAX_STAGES) return -1;
+    if(p->num_streams >= ICM42688_PIPELINE_MAX_STREAMS) return -3;
+
+    for(uint8_t i = 0; i < num_stages; i++) {
+        if(!stages[i].fn) return -1;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+    memcpy(s->stages, stages, num_stages * sizeof(*stages));
+    s->num_stages = num_stages;
+    s->home = (uint16_t)(p->num_streams % p->num_workers);
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->not_full, NULL);
+
+    p->num_streams++;
+    return 0;
+}
+
+int icm42688_pipeline_submit(icm42688_pipeline_t *p, icm42688_stream_t *s,
+                             const icm42688_data_t *samples, uint32_t count, int block) {
+    if(!p || !s || (!samples && count)) return -1;
+
+    uint32_t accepted = 0;
+
+    while(accepted < count) {
+        pthread_mutex_lock(&s->lock);
+        while(s->tail - s->head == ICM42688_PIPELINE_QUEUE_DEPTH) {
+            if(!block) {
+                pthread_mutex_unlock(&s->lock);
+                return (int)accepted;
+            }
+            pthread_cond_wait(&s->not_full, &s->lock);
+        }
+
+        icm42688_batch_t *b = &s->queue[s->tail & QUEUE_MASK];
+        uint32_t n = count - accepted;
+        if(n > ICM42688_PIPELINE_BATCH_SIZE) n = ICM42688_PIPELINE_BATCH_SIZE;
+        memcpy(b->samples, &samples[accepted], n * sizeof(*samples));
+        b->count = (uint16_t)n;
+
+        pthread_mutex_lock(&p->lock);
+        p->inflight++;
+        pthread_mutex_unlock(&p->lock);
+
+        s->tail++;
+        int wake = !s->scheduled;
+        s->scheduled = 1;
+        pthread_mutex_unlock(&s->lock);
+
+        if(wake) deque_push(p, s->home, s);
+        accepted += n;
+    }
+    return (int)accepted;
+}
+
+int icm42688_pipeline_drain(icm42688_pipeline_t *p) {
+    if(!p) return -1;
+
+    pthread_mutex_lock(&p->lock);
+    while(p->inflight != 0) {
+        pthread_cond_wait(&p->idle, &p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return 0;
+}
+
+int icm42688_pipeline_shutdown(icm42688_pipeline_t *p) {
+    if(!p) return -1;
+
+    if(p->num_workers) icm42688_pipeline_drain(p);
+
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+
+    for(uint16_t i = 0; i < p->num_workers; i++) {
+        pthread_join(p->workers[i].thread, NULL);
+    }
+    p->num_workers = 0;
+    return 0;
+}
+
+#endif /* __linux__ */
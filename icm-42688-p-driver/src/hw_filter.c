@@ -0,0 +1,208 @@
+/**
+ * @file hw_filter.c
+ * @brief On-sensor filter configuration implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "hw_filter.h"
+#include <string.h>
+
+#if ICM42688_CFG_HW_FILTER
+
+/**
+ * @brief Anti-alias filter table entry (index = DELT - 1)
+ */
+typedef struct {
+    uint16_t bw_hz;
+    uint16_t deltsqr;
+    uint8_t bitshift;
+} aaf_entry_t;
+
+/* Datasheet AAF bandwidth table, DELT 1..63 */
+static const aaf_entry_t aaf_table[ICM42688_AAF_DELT_MAX] = {
+    {  42,    1, 15 }, {  84,    4, 13 }, { 126,    9, 12 }, { 170,   16, 11 },
+    { 213,   25, 10 }, { 258,   36, 10 }, { 303,   49,  9 }, { 348,   64,  9 },
+    { 394,   81,  9 }, { 441,  100,  8 }, { 488,  122,  8 }, { 536,  144,  8 },
+    { 585,  170,  8 }, { 634,  196,  7 }, { 684,  224,  7 }, { 734,  256,  7 },
+    { 785,  288,  7 }, { 837,  324,  7 }, { 890,  360,  6 }, { 943,  400,  6 },
+    { 997,  440,  6 }, {1051,  488,  6 }, {1107,  528,  6 }, {1163,  576,  6 },
+    {1220,  624,  6 }, {1277,  680,  6 }, {1336,  736,  5 }, {1395,  784,  5 },
+    {1454,  848,  5 }, {1515,  896,  5 }, {1577,  960,  5 }, {1639, 1024,  5 },
+    {1702, 1088,  5 }, {1766, 1152,  5 }, {1830, 1232,  5 }, {1896, 1296,  5 },
+    {1962, 1376,  4 }, {2029, 1440,  4 }, {2097, 1536,  4 }, {2166, 1600,  4 },
+    {2235, 1696,  4 }, {2306, 1760,  4 }, {2377, 1856,  4 }, {2449, 1952,  4 },
+    {2522, 2016,  4 }, {2596, 2112,  4 }, {2671, 2208,  4 }, {2746, 2304,  4 },
+    {2823, 2400,  4 }, {2900, 2496,  4 }, {2978, 2592,  4 }, {3057, 2720,  4 },
+    {3137, 2816,  3 }, {3217, 2944,  3 }, {3299, 3008,  3 }, {3381, 3136,  3 },
+    {3464, 3264,  3 }, {3548, 3392,  3 }, {3633, 3456,  3 }, {3718, 3584,  3 },
+    {3805, 3712,  3 }, {3892, 3840,  3 }, {3979, 3968,  3 }
+};
+
+/* Notch bandwidth in Hz for NF_BW_SEL 0..7 */
+static const uint16_t notch_bw_table[8] = { 1449, 680, 329, 162, 80, 40, 20, 10 };
+
+/* 2*pi / 32 kHz in Q46, so f * K >> 16 is the notch angle in Q30 radians */
+#define NOTCH_RAD_PER_HZ_Q46 13816870609LL
+#define Q30_ONE              (1LL << 30)
+
+/* |COSWZ| above 0.875 switches to the fine encoding 8 * (1 - COSWZ) */
+#define COSWZ_FINE_Q30 939524096LL
+
+/**
+ * @brief cos(2*pi*f / 32 kHz) in Q30
+ *
+ * Taylor series to x^10 in nested form, evaluated in 64-bit integers. The
+ * angle is at most 0.59 rad, so the truncation error is below 1e-11 and the
+ * result is within a few Q30 LSB (~1e-8) of the exact value, far below the
+ * 1/2048 step of the finest COSWZ encoding.
+ *
+ * @param freq_hz Frequency, ICM42688_NOTCH_MIN_HZ..ICM42688_NOTCH_MAX_HZ
+ * @return Cosine in Q30
+ */
+static int64_t notch_cos(uint16_t freq_hz) {
+    int64_t x = ((int64_t)freq_hz * NOTCH_RAD_PER_HZ_Q46 + (1LL << 15)) >> 16;
+    int64_t x2 = (x * x) >> 30;
+    int64_t t = Q30_ONE - x2 / 90;
+
+    t = Q30_ONE - ((x2 * t) >> 30) / 56;
+    t = Q30_ONE - ((x2 * t) >> 30) / 30;
+    t = Q30_ONE - ((x2 * t) >> 30) / 12;
+    return Q30_ONE - ((x2 * t) >> 30) / 2;
+}
+
+int icm42688_aaf_compute(uint16_t bw_hz, icm42688_aaf_t *aaf) {
+    if(!aaf || bw_hz == 0) return -1;
+
+    uint8_t best = 0;
+    uint16_t best_err = 0xFFFF;
+    for(uint8_t i = 0; i < ICM42688_AAF_DELT_MAX; i++) {
+        uint16_t bw = aaf_table[i].bw_hz;
+        uint16_t err = bw > bw_hz ? (uint16_t)(bw - bw_hz) : (uint16_t)(bw_hz - bw);
+        if(err < best_err) {
+            best_err = err;
+            best = i;
+        }
+    }
+
+    aaf->delt = (uint8_t)(best + 1);
+    aaf->deltsqr = aaf_table[best].deltsqr;
+    aaf->bitshift = aaf_table[best].bitshift;
+    aaf->bw_hz = aaf_table[best].bw_hz;
+    return 0;
+}
+
+int icm42688_notch_compute(const uint16_t freq_hz[3], uint16_t bw_hz, icm42688_notch_t *notch) {
+    if(!freq_hz || !notch) return -1;
+
+    for(int axis = 0; axis < 3; axis++) {
+        uint16_t f = freq_hz[axis];
+        if(f < ICM42688_NOTCH_MIN_HZ || f > ICM42688_NOTCH_MAX_HZ) return -1;
+
+        /* Cosine is positive over 1-3 kHz, so only the two positive encodings occur */
+        int64_t c = notch_cos(f);
+        if(c > COSWZ_FINE_Q30) {
+            notch->coswz[axis] = (uint16_t)((Q30_ONE - c + (1LL << 18)) >> 19);  /* round(8 * (1 - c) * 256) */
+            notch->coswz_sel[axis] = 1;
+        } else {
+            notch->coswz[axis] = (uint16_t)((c + (1LL << 21)) >> 22);            /* round(c * 256) */
+            notch->coswz_sel[axis] = 0;
+        }
+    }
+
+    uint8_t best = 0;
+    uint16_t best_err = 0xFFFF;
+    for(uint8_t i = 0; i < 8; i++) {
+        uint16_t bw = notch_bw_table[i];
+        uint16_t err = bw > bw_hz ? (uint16_t)(bw - bw_hz) : (uint16_t)(bw_hz - bw);
+        if(err < best_err) {
+            best_err = err;
+            best = i;
+        }
+    }
+    notch->bw_sel = best;
+    notch->bw_hz = notch_bw_table[best];
+    return 0;
+}
+
+void icm42688_filter_config_default(icm42688_filter_config_t *cfg) {
+    if(!cfg) return;
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->gyro_ui_order = ICM42688_UI_FILT_ORD_1;
+    cfg->gyro_ui_bw = ICM42688_UI_FILT_BW_ODR_4;
+    cfg->accel_ui_order = ICM42688_UI_FILT_ORD_1;
+    cfg->accel_ui_bw = ICM42688_UI_FILT_BW_ODR_4;
+
+    /* Reset values: gyro DELT 13 (585 Hz), accel DELT 24 (1163 Hz) */
+    cfg->gyro_aaf_enable = 1;
+    icm42688_aaf_compute(585, &cfg->gyro_aaf);
+    cfg->accel_aaf_enable = 1;
+    icm42688_aaf_compute(1163, &cfg->accel_aaf);
+}
+
+/**
+ * @brief Program bank 1 and bank 2 registers (bank already selected by caller)
+ * @param dev Pointer to sensor context
+ * @param cfg Pointer to configuration
+ * @return 0 on success, negative value on error
+ */
+static int write_static_banks(icm42688_t *dev, const icm42688_filter_config_t *cfg) {
+    uint8_t g[9];  /* GYRO_CONFIG_STATIC2..10 */
+    uint8_t a[3];  /* ACCEL_CONFIG_STATIC2..4 */
+
+    if(icm42688_set_bank(dev, 1) != 0) return -2;
+    if(dev->bus.read(ICM42688_REG_GYRO_CONFIG_STATIC2, g, sizeof(g)) != 0) return -2;
+
+    g[0] = (uint8_t)((g[0] & ~0x03u) | (cfg->gyro_aaf_enable ? 0 : 0x02) | (cfg->notch_enable ? 0 : 0x01));
+    g[1] = (uint8_t)((g[1] & ~0x3Fu) | (cfg->gyro_aaf.delt & 0x3F));
+    g[2] = (uint8_t)(cfg->gyro_aaf.deltsqr & 0xFF);
+    g[3] = (uint8_t)((cfg->gyro_aaf.bitshift << 4) | ((cfg->gyro_aaf.deltsqr >> 8) & 0x0F));
+    if(cfg->notch_enable) {
+        uint8_t hi = 0;
+        for(int axis = 0; axis < 3; axis++) {
+            g[4 + axis] = (uint8_t)(cfg->notch.coswz[axis] & 0xFF);
+            hi |= (uint8_t)(((cfg->notch.coswz[axis] >> 8) & 0x01) << axis);
+            hi |= (uint8_t)((cfg->notch.coswz_sel[axis] & 0x01) << (3 + axis));
+        }
+        g[7] = (uint8_t)((g[7] & ~0x3Fu) | hi);
+        g[8] = (uint8_t)((g[8] & ~0x70u) | ((cfg->notch.bw_sel & 0x07) << 4));
+    }
+    if(dev->bus.write(ICM42688_REG_GYRO_CONFIG_STATIC2, g, sizeof(g)) != 0) return -2;
+
+    if(icm42688_set_bank(dev, 2) != 0) return -2;
+    if(dev->bus.read(ICM42688_REG_ACCEL_CONFIG_STATIC2, a, sizeof(a)) != 0) return -2;
+
+    a[0] = (uint8_t)((a[0] & 0x80u) | ((cfg->accel_aaf.delt & 0x3F) << 1) | (cfg->accel_aaf_enable ? 0 : 0x01));
+    a[1] = (uint8_t)(cfg->accel_aaf.deltsqr & 0xFF);
+    a[2] = (uint8_t)((cfg->accel_aaf.bitshift << 4) | ((cfg->accel_aaf.deltsqr >> 8) & 0x0F));
+    if(dev->bus.write(ICM42688_REG_ACCEL_CONFIG_STATIC2, a, sizeof(a)) != 0) return -2;
+
+    return 0;
+}
+
+int icm42688_configure_filters(icm42688_t *dev, const icm42688_filter_config_t *cfg) {
+    if(!dev || !cfg) return -1;
+    if(cfg->gyro_ui_order > ICM42688_UI_FILT_ORD_3 || cfg->accel_ui_order > ICM42688_UI_FILT_ORD_3) return -1;
+    if(cfg->gyro_ui_bw > 15 || cfg->accel_ui_bw > 15) return -1;
+    if(cfg->gyro_aaf.delt == 0 || cfg->gyro_aaf.delt > ICM42688_AAF_DELT_MAX) return -1;
+    if(cfg->accel_aaf.delt == 0 || cfg->accel_aaf.delt > ICM42688_AAF_DELT_MAX) return -1;
+
+    uint8_t r[3];  /* GYRO_CONFIG1, GYRO_ACCEL_CONFIG0, ACCEL_CONFIG1 */
+
+    if(icm42688_set_bank(dev, 0) != 0) return -2;
+    if(dev->bus.read(ICM42688_REG_GYRO_CONFIG1, r, sizeof(r)) != 0) return -2;
+
+    r[0] = (uint8_t)((r[0] & ~0x0Cu) | (cfg->gyro_ui_order << 2));
+    r[1] = (uint8_t)((cfg->accel_ui_bw << 4) | cfg->gyro_ui_bw);
+    r[2] = (uint8_t)((r[2] & ~0x18u) | (cfg->accel_ui_order << 3));
+    if(dev->bus.write(ICM42688_REG_GYRO_CONFIG1, r, sizeof(r)) != 0) return -2;
+
+    int ret = write_static_banks(dev, cfg);
+
+    /* Always try to return to bank 0: every other driver call assumes it */
+    if(icm42688_set_bank(dev, 0) != 0) return -2;
+    return ret;
+}
+
+#endif /* ICM42688_CFG_HW_FILTER */
@@ -0,0 +1,271 @@
+/**
+ * @file i2c_async.c
+ * @brief Non-blocking I2C transaction queue implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "i2c_async.h"
+#include "icm-42688.h"
+#include "trace.h"
+#include <stddef.h>
+#include <string.h>
+
+#if ICM42688_CFG_I2C_ASYNC
+
+/* Queue state is shared with the completion interrupt: mask IRQs around updates.
+ * Other cores provide I2C_ASYNC_IRQ_SAVE() / I2C_ASYNC_IRQ_RESTORE(state). */
+#if defined(I2C_ASYNC_IRQ_SAVE) && defined(I2C_ASYNC_IRQ_RESTORE)
+static inline uint32_t irq_save(void) { return I2C_ASYNC_IRQ_SAVE(); }
+static inline void irq_restore(uint32_t primask) { I2C_ASYNC_IRQ_RESTORE(primask); }
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+static inline uint32_t irq_save(void) {
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+static inline void irq_restore(uint32_t primask) {
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+#else
+static inline uint32_t irq_save(void) { return 0; }
+static inline void irq_restore(uint32_t primask) { (void)primask; }
+#endif
+
+/* Burst FIFO read stages */
+#define STAGE_NONE       0
+#define STAGE_FIFO_COUNT 1
+#define STAGE_FIFO_DATA  2
+
+/**
+ * @brief Call the completion callbacks of a list of finished transactions (IRQs enabled)
+ * @param list Transactions linked through next
+ * @param status Status to report
+ */
+static void report(i2c_async_txn_t *list, int status) {
+    while(list) {
+        i2c_async_txn_t *txn = list;
+        list = txn->next;
+        txn->next = NULL;
+        if(txn->done) txn->done(txn, status);
+    }
+}
+
+/**
+ * @brief Start the next queued transaction, round-robin across clients (IRQs masked)
+ * @param bus Pointer to bus
+ * @return Transactions that failed to start, to be reported once IRQs are enabled again
+ */
+static i2c_async_txn_t *dispatch(i2c_async_bus_t *bus) {
+    i2c_async_txn_t *failed = NULL;
+    i2c_async_txn_t **failed_tail = &failed;
+
+    while(!bus->active && bus->pending) {
+        i2c_async_txn_t *txn = NULL;
+
+        for(uint8_t i = 0; i < I2C_ASYNC_MAX_CLIENTS; i++) {
+            uint8_t c = (uint8_t)((bus->turn + i) % I2C_ASYNC_MAX_CLIENTS);
+            if(bus->head[c]) {
+                txn = bus->head[c];
+                bus->head[c] = txn->next;
+                if(!bus->head[c]) bus->tail[c] = NULL;
+                bus->turn = (uint8_t)((c + 1) % I2C_ASYNC_MAX_CLIENTS);
+                break;
+            }
+        }
+        if(!txn) break;
+
+        bus->pending--;
+        bus->active = txn;
+        txn->next = NULL;
+        ICM42688_TRACE_ASYNC_BEGIN(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+        if(bus->start(bus->ctx, txn) == 0) break;
+
+        /* Failed to start: report it later and move on to the next client */
+        ICM42688_TRACE_ASYNC_END(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+        bus->active = NULL;
+        bus->stats.errors++;
+        *failed_tail = txn;
+        failed_tail = &txn->next;
+    }
+    return failed;
+}
+
+/**
+ * @brief Turn a finished FIFO count read into the FIFO data read (IRQs masked)
+ *
+ * The data read is restarted while the transaction is still active, so no
+ * other client gets the bus between count and data.
+ *
+ * @param bus Pointer to bus
+ * @param txn Active burst transaction whose count stage just finished
+ * @return 1 if the data stage is running, 0 if there is no whole packet to read,
+ *         -1 if the data read could not be started
+ */
+static int fifo_data_stage(i2c_async_bus_t *bus, i2c_async_txn_t *txn) {
+    uint16_t count = (uint16_t)((txn->data[0] << 8) | txn->data[1]);
+    uint16_t room = (uint16_t)(txn->capacity - 2);
+
+    if(count > room) count = room;
+    count = (uint16_t)(count - count % txn->packet_size);
+    if(count == 0) return 0;
+
+    txn->stage = STAGE_FIFO_DATA;
+    txn->reg = ICM42688_REG_FIFO_DATA;
+    txn->data += 2;
+    txn->len = count;
+    ICM42688_TRACE_ASYNC_BEGIN(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+    if(bus->start(bus->ctx, txn) == 0) return 1;
+
+    ICM42688_TRACE_ASYNC_END(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+    txn->data -= 2;
+    return -1;
+}
+
+int i2c_async_init(i2c_async_bus_t *bus, i2c_async_start_t start, void *ctx) {
+    if(!bus || !start) return -1;
+
+    memset(bus, 0, sizeof(*bus));
+    bus->start = start;
+    bus->ctx = ctx;
+    return 0;
+}
+
+int i2c_async_submit(i2c_async_bus_t *bus, i2c_async_txn_t *txn) {
+    if(!bus || !txn || !txn->data || txn->len == 0) return -1;
+    if(txn->client >= I2C_ASYNC_MAX_CLIENTS) return -1;
+
+    txn->next = NULL;
+    if(txn->stage != STAGE_NONE) {
+        /* Burst: rewind to the count stage in case the transaction is reused */
+        txn->stage = STAGE_FIFO_COUNT;
+        txn->reg = ICM42688_REG_FIFO_COUNTH;
+        txn->len = 2;
+    }
+
+    uint32_t primask = irq_save();
+    uint8_t c = txn->client;
+    if(bus->tail[c]) {
+        bus->tail[c]->next = txn;
+    } else {
+        bus->head[c] = txn;
+    }
+    bus->tail[c] = txn;
+    bus->pending++;
+    bus->stats.submitted++;
+    if(bus->pending > bus->stats.max_pending) bus->stats.max_pending = bus->pending;
+
+    i2c_async_txn_t *failed = dispatch(bus);
+    irq_restore(primask);
+
+    report(failed, -2);
+    return 0;
+}
+
+void i2c_async_complete(i2c_async_bus_t *bus, int status) {
+    if(!bus) return;
+
+    uint32_t primask = irq_save();
+    i2c_async_txn_t *txn = bus->active;
+    if(!txn) {
+        irq_restore(primask);
+        return;
+    }
+
+    ICM42688_TRACE_ASYNC_END(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+    if(status == 0 && txn->stage == STAGE_FIFO_COUNT) {
+        int next = fifo_data_stage(bus, txn);
+        if(next == 1) {
+            irq_restore(primask);
+            return;
+        }
+        if(next < 0) status = -2;
+    } else if(txn->stage == STAGE_FIFO_DATA) {
+        /* Report the whole buffer: count in data[0..1], exactly len - 2 packet bytes */
+        txn->data -= 2;
+        txn->len = (uint16_t)(txn->len + 2);
+    }
+    if(status != 0 && txn->stage != STAGE_NONE) txn->len = 0;
+
+    if(status == 0) {
+        bus->stats.completed++;
+    } else {
+        bus->stats.errors++;
+    }
+
+    /* Keep the bus busy: start the next transfer before running the callback */
+    bus->active = NULL;
+    i2c_async_txn_t *failed = dispatch(bus);
+    irq_restore(primask);
+
+    txn->next = NULL;
+    if(txn->done) txn->done(txn, status == 0 ? 0 : -2);
+    report(failed, -2);
+}
+
+int i2c_async_cancel(i2c_async_bus_t *bus, i2c_async_txn_t *txn, i2c_async_abort_t abort) {
+    if(!bus || !txn || txn->client >= I2C_ASYNC_MAX_CLIENTS) return -1;
+
+    uint32_t primask = irq_save();
+    i2c_async_txn_t *failed = NULL;
+    if(bus->active == txn) {
+        if(abort) abort(bus->ctx, txn);
+        ICM42688_TRACE_ASYNC_END(ICM42688_TRACE_EV_BUS_ASYNC, (uintptr_t)txn);
+        if(txn->stage == STAGE_FIFO_DATA) txn->data -= 2;
+        bus->active = NULL;
+        failed = dispatch(bus);
+    } else {
+        uint8_t c = txn->client;
+        i2c_async_txn_t *prev = NULL;
+        i2c_async_txn_t *cur = bus->head[c];
+        while(cur && cur != txn) {
+            prev = cur;
+            cur = cur->next;
+        }
+        if(!cur) {
+            irq_restore(primask);
+            return -3;
+        }
+        if(prev) {
+            prev->next = txn->next;
+        } else {
+            bus->head[c] = txn->next;
+        }
+        if(bus->tail[c] == txn) bus->tail[c] = prev;
+        bus->pending--;
+    }
+    bus->stats.errors++;
+    irq_restore(primask);
+
+    txn->next = NULL;
+    if(txn->stage != STAGE_NONE) txn->len = 0;
+    report(failed, -2);
+    return 0;
+}
+
+int i2c_async_idle(const i2c_async_bus_t *bus) {
+    if(!bus) return 1;
+    return !bus->active && bus->pending == 0;
+}
+
+int i2c_async_fifo_burst(i2c_async_txn_t *txn, uint8_t device_addr, uint8_t client, uint8_t packet_size,
+                         uint8_t *buf, uint16_t len, i2c_async_done_t done, void *user) {
+    if(!txn || !buf || packet_size == 0 || len < 2 + packet_size) return -1;
+
+    txn->device_addr = device_addr;
+    txn->reg = ICM42688_REG_FIFO_COUNTH;
+    txn->write = 0;
+    txn->client = client;
+    txn->data = buf;
+    txn->len = 2;
+    txn->done = done;
+    txn->user = user;
+    txn->next = NULL;
+    txn->stage = STAGE_FIFO_COUNT;
+    txn->packet_size = packet_size;
+    txn->capacity = len;
+    return 0;
+}
+
+#endif /* ICM42688_CFG_I2C_ASYNC */
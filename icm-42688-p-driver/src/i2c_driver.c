@@ -6,32 +6,120 @@
  */
 
 #include "i2c_driver.h"
+#include "trace.h"
 #include "stm32f1xx_hal.h"
 
+#if ICM42688_CFG_I2C
+
 extern I2C_HandleTypeDef hi2c1; /**< I2C1 handle - change for different ports */
 extern I2C_HandleTypeDef hi2c2; /**< I2C2 handle (if available) */
 
 /* Global I2C driver instance */
 static i2c_driver_t g_i2c_driver = {0};
 
+#if ICM42688_CFG_I2C_ASYNC
+/* Non-blocking transport binding per I2C port */
+typedef struct {
+    I2C_HandleTypeDef *hi2c;
+    i2c_async_bus_t *bus;
+    uint8_t use_dma;
+} i2c_async_port_t;
+
+static i2c_async_port_t g_async_port[2] = {0};
+
+/* Completion state of a blocking transfer routed through the queue */
+typedef struct {
+    volatile uint8_t done;
+    volatile int status;
+} i2c_blocking_wait_t;
+
+static void blocking_done(i2c_async_txn_t *txn, int status) {
+    i2c_blocking_wait_t *wait = (i2c_blocking_wait_t *)txn->user;
+
+    wait->status = status;
+    wait->done = 1;
+}
+
+/* Abort hook: reset the peripheral, which stops a stalled transfer (and its DMA)
+ * synchronously and leaves the handle ready for the next queued transfer */
+static void stm32_i2c_async_abort(void *ctx, const i2c_async_txn_t *txn) {
+    i2c_async_port_t *port = (i2c_async_port_t *)ctx;
+
+    (void)txn;
+    HAL_I2C_DeInit(port->hi2c);
+    HAL_I2C_Init(port->hi2c);
+}
+
+/* Blocking transfer queued behind (and arbitrated with) the non-blocking traffic.
+ * Must not be called from interrupt context or with interrupts masked. */
+static int async_blocking(i2c_async_port_t *port, uint8_t device_addr, uint8_t reg, uint8_t write,
+                          uint8_t *data, uint16_t len) {
+    i2c_blocking_wait_t wait = {0, 0};
+    i2c_async_txn_t txn = {0};
+
+    txn.device_addr = device_addr;
+    txn.reg = reg;
+    txn.write = write;
+    txn.client = I2C_DRIVER_BLOCKING_CLIENT;
+    txn.data = data;
+    txn.len = len;
+    txn.done = blocking_done;
+    txn.user = &wait;
+
+    if (i2c_async_submit(port->bus, &txn) != 0) {
+        return -1;
+    }
+    uint32_t start = HAL_GetTick();
+    while (!wait.done) {
+        /* The completion or error interrupt ends the wait, unless it was lost */
+        if (HAL_GetTick() - start >= I2C_DRIVER_TIMEOUT_MS &&
+            i2c_async_cancel(port->bus, &txn, stm32_i2c_async_abort) == 0) {
+            return -2; /* txn is off the queue; nothing refers to this frame any more */
+        }
+    }
+    return wait.status;
+}
+#endif /* ICM42688_CFG_I2C_ASYNC */
+
 /* ICM-42688 I2C address */
 #define ICM_42688_I2C_ADDRESS (0x68 << 1)
 
-/* STM32 HAL callback functions */
+/* STM32 HAL callback functions; once the port runs the non-blocking transport,
+ * blocking transfers go through its queue instead of racing it for the bus */
 static int stm32_i2c1_read_callback(uint8_t device_addr, uint8_t reg, uint8_t *data, uint16_t len) {
-    return HAL_I2C_Mem_Read(&hi2c1, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, 1000);
+#if ICM42688_CFG_I2C_ASYNC
+    if (g_async_port[0].bus) {
+        return async_blocking(&g_async_port[0], device_addr, reg, 0, data, len);
+    }
+#endif
+    return HAL_I2C_Mem_Read(&hi2c1, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_DRIVER_TIMEOUT_MS);
 }
 
 static int stm32_i2c1_write_callback(uint8_t device_addr, uint8_t reg, uint8_t *data, uint16_t len) {
-    return HAL_I2C_Mem_Write(&hi2c1, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, 1000);
+#if ICM42688_CFG_I2C_ASYNC
+    if (g_async_port[0].bus) {
+        return async_blocking(&g_async_port[0], device_addr, reg, 1, data, len);
+    }
+#endif
+    return HAL_I2C_Mem_Write(&hi2c1, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_DRIVER_TIMEOUT_MS);
 }
 
 static int stm32_i2c2_read_callback(uint8_t device_addr, uint8_t reg, uint8_t *data, uint16_t len) {
-    return HAL_I2C_Mem_Read(&hi2c2, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, 1000);
+#if ICM42688_CFG_I2C_ASYNC
+    if (g_async_port[1].bus) {
+        return async_blocking(&g_async_port[1], device_addr, reg, 0, data, len);
+    }
+#endif
+    return HAL_I2C_Mem_Read(&hi2c2, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_DRIVER_TIMEOUT_MS);
 }
 
 static int stm32_i2c2_write_callback(uint8_t device_addr, uint8_t reg, uint8_t *data, uint16_t len) {
-    return HAL_I2C_Mem_Write(&hi2c2, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, 1000);
+#if ICM42688_CFG_I2C_ASYNC
+    if (g_async_port[1].bus) {
+        return async_blocking(&g_async_port[1], device_addr, reg, 1, data, len);
+    }
+#endif
+    return HAL_I2C_Mem_Write(&hi2c2, device_addr, reg, I2C_MEMADD_SIZE_8BIT, data, len, I2C_DRIVER_TIMEOUT_MS);
 }
 
 int i2c_driver_init(i2c_driver_t *driver, uint8_t device_addr,
@@ -61,17 +149,105 @@ int i2c_driver_init_i2c2(uint8_t device_addr) {
 }
 
 int i2c_read_wrapper(uint8_t reg, uint8_t *data, uint16_t len) {
+    int ret;
+
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_BUS_READ, len);
     if (g_i2c_driver.read_callback) {
-        return g_i2c_driver.read_callback(g_i2c_driver.device_address, reg, data, len);
+        ret = g_i2c_driver.read_callback(g_i2c_driver.device_address, reg, data, len);
+    } else {
+        /* Default to I2C1 */
+        ret = (stm32_i2c1_read_callback(ICM_42688_I2C_ADDRESS, reg, data, len) == 0) ? 0 : -1;
     }
-    /* Default to I2C1 */
-    return (HAL_I2C_Mem_Read(&hi2c1, 0x68 << 1, reg, I2C_MEMADD_SIZE_8BIT, data, len, 1000) == HAL_OK) ? 0 : -1;
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_READ, ret == 0 ? len : 0);
+
+    return ret;
 }
 
 int i2c_write_wrapper(uint8_t reg, uint8_t *data, uint16_t len) {
+    int ret;
+
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_BUS_WRITE, len);
     if (g_i2c_driver.write_callback) {
-        return g_i2c_driver.write_callback(g_i2c_driver.device_address, reg, data, len);
+        ret = g_i2c_driver.write_callback(g_i2c_driver.device_address, reg, data, len);
+    } else {
+        /* Default to I2C1 */
+        ret = stm32_i2c1_write_callback(ICM_42688_I2C_ADDRESS, reg, data, len);
     }
-    /* Default to I2C1 */
-    return stm32_i2c1_write_callback(ICM_42688_I2C_ADDRESS, reg, data, len);
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_WRITE, ret == 0 ? len : 0);
+
+    return ret;
 }
+
+#if ICM42688_CFG_I2C_ASYNC
+/* Non-blocking start hook: returns as soon as the transfer is running */
+static int stm32_i2c_async_start(void *ctx, const i2c_async_txn_t *txn) {
+    i2c_async_port_t *port = (i2c_async_port_t *)ctx;
+    HAL_StatusTypeDef status;
+
+    /* STM32F1 I2C DMA needs at least 2 bytes; single-byte transfers use interrupts */
+    if (port->use_dma && txn->len >= 2) {
+        if (txn->write) {
+            status = HAL_I2C_Mem_Write_DMA(port->hi2c, txn->device_addr, txn->reg, I2C_MEMADD_SIZE_8BIT, txn->data, txn->len);
+        } else {
+            status = HAL_I2C_Mem_Read_DMA(port->hi2c, txn->device_addr, txn->reg, I2C_MEMADD_SIZE_8BIT, txn->data, txn->len);
+        }
+    } else {
+        if (txn->write) {
+            status = HAL_I2C_Mem_Write_IT(port->hi2c, txn->device_addr, txn->reg, I2C_MEMADD_SIZE_8BIT, txn->data, txn->len);
+        } else {
+            status = HAL_I2C_Mem_Read_IT(port->hi2c, txn->device_addr, txn->reg, I2C_MEMADD_SIZE_8BIT, txn->data, txn->len);
+        }
+    }
+
+    return (status == HAL_OK) ? 0 : -2;
+}
+
+static int i2c_driver_async_init(i2c_async_port_t *port, I2C_HandleTypeDef *hi2c,
+                                 i2c_async_bus_t *bus, uint8_t use_dma) {
+    if (!bus) {
+        return -1; /* Error: invalid parameters */
+    }
+
+    port->hi2c = hi2c;
+    port->bus = bus;
+    port->use_dma = use_dma;
+
+    return i2c_async_init(bus, stm32_i2c_async_start, port);
+}
+
+int i2c_driver_async_init_i2c1(i2c_async_bus_t *bus, uint8_t use_dma) {
+    return i2c_driver_async_init(&g_async_port[0], &hi2c1, bus, use_dma);
+}
+
+int i2c_driver_async_init_i2c2(i2c_async_bus_t *bus, uint8_t use_dma) {
+    return i2c_driver_async_init(&g_async_port[1], &hi2c2, bus, use_dma);
+}
+
+void i2c_driver_async_irq(void *hi2c, int status) {
+    ICM42688_TRACE_ISR(0);
+
+    for (int i = 0; i < 2; i++) {
+        if (g_async_port[i].bus && g_async_port[i].hi2c == hi2c) {
+            i2c_async_complete(g_async_port[i].bus, status);
+            return;
+        }
+    }
+}
+
+#ifndef I2C_DRIVER_NO_HAL_CALLBACKS
+/* Overrides of the weak HAL completion callbacks */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    i2c_driver_async_irq(hi2c, 0);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    i2c_driver_async_irq(hi2c, 0);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    i2c_driver_async_irq(hi2c, -2);
+}
+#endif /* I2C_DRIVER_NO_HAL_CALLBACKS */
+#endif /* ICM42688_CFG_I2C_ASYNC */
+
+#endif /* ICM42688_CFG_I2C */
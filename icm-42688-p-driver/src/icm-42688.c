@@ -6,6 +6,8 @@
  */
 
 #include "icm-42688.h"
+#include "trace.h"
+#include <stddef.h>
 
 
 /**
@@ -58,6 +60,7 @@ int icm42688_init(icm42688_t *dev) {
     return 0;
 }
 
+#if ICM42688_CFG_SPLIT_READS
 int icm42688_read_temp(icm42688_t *dev, int16_t *temp) {
     if(!dev || !temp) return -1;
 
@@ -91,14 +94,20 @@ int icm42688_read_gyro(icm42688_t *dev, int16_t *gyro_x, int16_t *gyro_y, int16_
     *gyro_z = (int16_t)((buf[4] << 8) | buf[5]);
     return 0;
 }
+#endif /* ICM42688_CFG_SPLIT_READS */
 
 int icm42688_read_all(icm42688_t *dev, icm42688_data_t *data) {
     if(!dev || !data) return -1;
 
     uint8_t buf[14];
-    
-    if(dev->bus.read(ICM42688_REG_TEMP_DATA1, buf, 14) != 0) return -2;
 
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_READ_ALL, 14);
+    if(dev->bus.read(ICM42688_REG_TEMP_DATA1, buf, 14) != 0) {
+        ICM42688_TRACE_END(ICM42688_TRACE_EV_READ_ALL, 0);
+        return -2;
+    }
+
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_DECODE, 0);
     data->temp = (int16_t)((buf[0] << 8) | buf[1]);
 
     data->accel_x = (int16_t)((buf[2] << 8) | buf[3]);
@@ -108,7 +117,218 @@ int icm42688_read_all(icm42688_t *dev, icm42688_data_t *data) {
     data->gyro_x = (int16_t)((buf[8] << 8) | buf[9]);
     data->gyro_y = (int16_t)((buf[10] << 8) | buf[11]);
     data->gyro_z = (int16_t)((buf[12] << 8) | buf[13]);
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_DECODE, 0);
+
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_READ_ALL, 14);
+    return 0;
+}
+
+#if ICM42688_CFG_FIFO
+int icm42688_fifo_init(icm42688_t *dev, uint16_t watermark) {
+    if(!dev) return -1;
+
+    /* Packet 3: accel + gyro + temp + timestamp */
+    if(write_register(dev, ICM42688_REG_FIFO_CONFIG1, 0x0F) != 0) return -2;
+    if(icm42688_set_fifo_watermark(dev, watermark) != 0) return -2;
+
+    /* Route watermark and full interrupts to INT1 */
+    if(write_register(dev, ICM42688_REG_INT_SOURCE0, 0x06) != 0) return -2;
+    if(write_register(dev, ICM42688_REG_FIFO_CONFIG, ICM42688_FIFO_MODE_STREAM) != 0) return -2;
+
+    return icm42688_flush_fifo(dev);
+}
+
+int icm42688_set_fifo_watermark(icm42688_t *dev, uint16_t watermark) {
+    if(!dev) return -1;
+    if(watermark == 0 || watermark > ICM42688_FIFO_WM_MAX) return -1;
+
+    /* FIFO_CONFIG2 and FIFO_CONFIG3 are adjacent, write both in one transaction */
+    uint8_t buf[2];
+    buf[0] = (uint8_t)(watermark & 0xFF);
+    buf[1] = (uint8_t)((watermark >> 8) & 0x0F);
+    if(dev->bus.write(ICM42688_REG_FIFO_CONFIG2, buf, 2) != 0) return -2;
 
     return 0;
 }
 
+int icm42688_read_fifo_count(icm42688_t *dev, uint16_t *count) {
+    if(!dev || !count) return -1;
+
+    uint8_t buf[2];
+    if(dev->bus.read(ICM42688_REG_FIFO_COUNTH, buf, 2) != 0) return -2;
+
+    *count = (uint16_t)((buf[0] << 8) | buf[1]);
+    return 0;
+}
+
+int icm42688_read_fifo(icm42688_t *dev, uint8_t *buf, uint16_t len) {
+    if(!dev || !buf) return -1;
+    if(len == 0) return 0;
+
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_FIFO_READ, len);
+    int ret = dev->bus.read(ICM42688_REG_FIFO_DATA, buf, len);
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_FIFO_READ, len);
+
+    if(ret != 0) return -2;
+    return 0;
+}
+
+int icm42688_flush_fifo(icm42688_t *dev) {
+    if(!dev) return -1;
+
+    if(write_register(dev, ICM42688_REG_SIGNAL_PATH_RESET, ICM42688_FIFO_FLUSH) != 0) return -2;
+    return 0;
+}
+#endif /* ICM42688_CFG_FIFO */
+
+int icm42688_read_int_status(icm42688_t *dev, uint8_t *status) {
+    if(!dev || !status) return -1;
+
+    if(read_register(dev, ICM42688_REG_INT_STATUS, status) != 0) return -2;
+    return 0;
+}
+
+#if ICM42688_CFG_RANGE
+int icm42688_set_bank(icm42688_t *dev, uint8_t bank) {
+    if(!dev || bank > 4) return -1;
+
+    if(write_register(dev, ICM42688_REG_BANK_SEL, bank) != 0) return -2;
+    return 0;
+}
+
+/**
+ * @brief Replace FS_SEL bits [7:5] of a configuration register
+ * @param dev Pointer to sensor context
+ * @param reg ACCEL_CONFIG0 or GYRO_CONFIG0
+ * @param fs Full-scale selection
+ * @return 0 on success, negative value on error
+ */
+static int set_fs_sel(icm42688_t *dev, uint8_t reg, uint8_t fs) {
+    uint8_t value;
+
+    if(read_register(dev, reg, &value) != 0) return -2;
+    value = (uint8_t)((value & 0x1F) | (fs << 5));
+    if(write_register(dev, reg, value) != 0) return -2;
+    return 0;
+}
+
+int icm42688_set_accel_fsr(icm42688_t *dev, icm42688_accel_fs_t fs) {
+    if(!dev || fs > ICM42688_ACCEL_FS_2G) return -1;
+    return set_fs_sel(dev, ICM42688_REG_ACCEL_CONFIG0, (uint8_t)fs);
+}
+
+int icm42688_set_gyro_fsr(icm42688_t *dev, icm42688_gyro_fs_t fs) {
+    if(!dev || fs > ICM42688_GYRO_FS_15_625DPS) return -1;
+    return set_fs_sel(dev, ICM42688_REG_GYRO_CONFIG0, (uint8_t)fs);
+}
+#endif /* ICM42688_CFG_RANGE */
+
+#if ICM42688_CFG_FIFO
+/**
+ * @brief Decode big-endian 16-bit value
+ * @param p Pointer to MSB
+ * @return Signed 16-bit value
+ */
+static int16_t be16(const uint8_t *p) {
+    return (int16_t)((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Decode raw FIFO bytes into either plain data or timestamped samples
+ * @param buf Raw FIFO bytes
+ * @param len Number of bytes in buffer
+ * @param data Output data array (used when samples is NULL)
+ * @param samples Output sample array with FIFO timestamps (may be NULL)
+ * @param max_samples Capacity of output array
+ * @param consumed Optional pointer to number of bytes decoded
+ * @return Number of samples decoded
+ */
+static int parse_packets(const uint8_t *buf, uint16_t len, icm42688_data_t *data,
+                         icm42688_sample_t *samples, uint16_t max_samples, uint16_t *consumed) {
+    uint16_t pos = 0;
+    uint16_t n = 0;
+
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_FIFO_PARSE, len);
+    while(n < max_samples && pos < len) {
+        uint8_t header = buf[pos];
+        uint8_t has_accel = (header & ICM42688_FIFO_HEADER_ACCEL) != 0;
+        uint8_t has_gyro = (header & ICM42688_FIFO_HEADER_GYRO) != 0;
+        uint16_t size;
+
+        /* Empty FIFO marker or invalid header ends the stream */
+        if((header & ICM42688_FIFO_HEADER_MSG) || (!has_accel && !has_gyro)) break;
+
+        if(has_accel && has_gyro) {
+#if ICM42688_CFG_FIFO_PACKET4
+            size = (header & ICM42688_FIFO_HEADER_20) ? ICM42688_FIFO_PACKET4_SIZE
+                                                      : ICM42688_FIFO_PACKET3_SIZE;
+#else
+            if(header & ICM42688_FIFO_HEADER_20) break;
+            size = ICM42688_FIFO_PACKET3_SIZE;
+#endif
+        } else {
+#if ICM42688_CFG_FIFO_PACKET1_2
+            size = ICM42688_FIFO_PACKET1_SIZE;
+#else
+            break;
+#endif
+        }
+        if((uint16_t)(len - pos) < size) break;
+
+        const uint8_t *p = &buf[pos + 1];
+        icm42688_data_t *d = samples ? &samples[n].data : &data[n];
+        d->accel_x = d->accel_y = d->accel_z = 0;
+        d->gyro_x = d->gyro_y = d->gyro_z = 0;
+
+        if(has_accel) {
+            d->accel_x = be16(&p[0]);
+            d->accel_y = be16(&p[2]);
+            d->accel_z = be16(&p[4]);
+            p += 6;
+        }
+        if(has_gyro) {
+            d->gyro_x = be16(&p[0]);
+            d->gyro_y = be16(&p[2]);
+            d->gyro_z = be16(&p[4]);
+            p += 6;
+        }
+
+        /* 8-bit FIFO temperature is 2.07 LSB/C, TEMP_DATA is 132.48 LSB/C */
+        if(ICM42688_CFG_FIFO_PACKET4 && size == ICM42688_FIFO_PACKET4_SIZE) {
+            d->temp = be16(p);
+            p += 2;
+        } else {
+            d->temp = (int16_t)((int8_t)p[0] * 64);
+            p += 1;
+        }
+
+        /* Packets 3 and 4 end with the 16-bit ODR timestamp, 1 and 2 have none */
+        if(samples) {
+            samples[n].timestamp_us = (size >= ICM42688_FIFO_PACKET3_SIZE)
+                                    ? (uint32_t)(uint16_t)be16(p) : 0;
+        }
+
+        pos += size;
+        n++;
+    }
+
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_FIFO_PARSE, n);
+
+    if(consumed) *consumed = pos;
+    return (int)n;
+}
+
+int icm42688_parse_fifo(const uint8_t *buf, uint16_t len, icm42688_data_t *out,
+                        uint16_t max_samples, uint16_t *consumed) {
+    if(!buf || !out) return -1;
+
+    return parse_packets(buf, len, out, NULL, max_samples, consumed);
+}
+
+int icm42688_parse_fifo_samples(const uint8_t *buf, uint16_t len, icm42688_sample_t *out,
+                                uint16_t max_samples, uint16_t *consumed) {
+    if(!buf || !out) return -1;
+
+    return parse_packets(buf, len, NULL, out, max_samples, consumed);
+}
+#endif /* ICM42688_CFG_FIFO */
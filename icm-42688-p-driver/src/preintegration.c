@@ -0,0 +1,168 @@
+/**
+ * @file preintegration.c
+ * @brief IMU preintegration with coning/sculling compensation implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "preintegration.h"
+#include <string.h>
+
+#if ICM42688_CFG_PREINTEGRATION
+
+/**
+ * @brief Cross product r = a x b
+ * @param r Result vector
+ * @param a Left operand
+ * @param b Right operand
+ */
+static void cross(float r[3], const float a[3], const float b[3]) {
+    r[0] = a[1] * b[2] - a[2] * b[1];
+    r[1] = a[2] * b[0] - a[0] * b[2];
+    r[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/**
+ * @brief Clear interval accumulators
+ * @param pi Pointer to preintegrator
+ * @note The previous step (last_dalpha, last_dv) is kept: the coning and
+ *       sculling terms of the first step in the next interval need it like
+ *       those of every other step.
+ */
+static void clear_interval(icm42688_preint_t *pi) {
+    memset(pi->alpha, 0, sizeof(pi->alpha));
+    memset(pi->beta, 0, sizeof(pi->beta));
+    memset(pi->vel, 0, sizeof(pi->vel));
+    memset(pi->scul, 0, sizeof(pi->scul));
+    pi->start_q8 = pi->recon_q8;
+    pi->count = 0;
+}
+
+/**
+ * @brief Advance reconstructed sample time from a raw read timestamp
+ * @param pi Pointer to preintegrator
+ * @param timestamp_us Raw timestamp
+ * @return Reconstructed step since previous sample, 1/256 us
+ */
+static int64_t reconstruct_time(icm42688_preint_t *pi, uint32_t timestamp_us) {
+    pi->raw_q8 += (uint64_t)(uint32_t)(timestamp_us - pi->last_raw_us) << 8;
+    pi->last_raw_us = timestamp_us;
+
+    int64_t predicted = (int64_t)pi->recon_q8 + pi->period_q8;
+    int64_t err = (int64_t)pi->raw_q8 - predicted;
+
+    /* Gaps (dropped samples, stalls) resynchronize instead of being smoothed */
+    if(err > 4LL * pi->period_q8 || err < -4LL * pi->period_q8) {
+        int64_t step = (int64_t)pi->raw_q8 - (int64_t)pi->recon_q8;
+        pi->recon_q8 = pi->raw_q8;
+        return step;
+    }
+
+    /* Phase follows at 1/16, period at 1/256 of the error */
+    int64_t step = pi->period_q8 + err / 16;
+    pi->period_q8 += (int32_t)(err / 256);
+    if(pi->period_q8 < pi->nominal_q8 / 2) pi->period_q8 = pi->nominal_q8 / 2;
+    if(pi->period_q8 > pi->nominal_q8 * 2) pi->period_q8 = pi->nominal_q8 * 2;
+
+    pi->recon_q8 += (uint64_t)step;
+    return step;
+}
+
+int icm42688_preint_init(icm42688_preint_t *pi, uint32_t odr_hz, uint32_t out_hz,
+                         float gyro_scale, float accel_scale) {
+    if(!pi || odr_hz == 0 || out_hz == 0 || out_hz > odr_hz) return -1;
+
+    memset(pi, 0, sizeof(*pi));
+    pi->gyro_scale = gyro_scale;
+    pi->accel_scale = accel_scale;
+    pi->interval_us = 1000000UL / out_hz;
+    pi->nominal_q8 = (int32_t)((256000000ULL + odr_hz / 2) / odr_hz);
+    pi->period_q8 = pi->nominal_q8;
+
+    return 0;
+}
+
+void icm42688_preint_reset(icm42688_preint_t *pi) {
+    if(!pi) return;
+
+    clear_interval(pi);
+    memset(pi->last_dalpha, 0, sizeof(pi->last_dalpha));
+    memset(pi->last_dv, 0, sizeof(pi->last_dv));
+}
+
+int icm42688_preint_push(icm42688_preint_t *pi, const icm42688_data_t *data, uint32_t timestamp_us,
+                         icm42688_preint_out_t *out) {
+    if(!pi || !data || !out) return -1;
+
+    float w[3] = {
+        data->gyro_x * pi->gyro_scale, data->gyro_y * pi->gyro_scale, data->gyro_z * pi->gyro_scale
+    };
+    float a[3] = {
+        data->accel_x * pi->accel_scale, data->accel_y * pi->accel_scale, data->accel_z * pi->accel_scale
+    };
+
+    if(!pi->started) {
+        pi->started = 1;
+        pi->last_raw_us = timestamp_us;
+        memcpy(pi->last_w, w, sizeof(w));
+        memcpy(pi->last_a, a, sizeof(a));
+        clear_interval(pi);
+        return 0;
+    }
+
+    float dt = (float)reconstruct_time(pi, timestamp_us) * (1.0f / 256e6f);
+
+    /* Trapezoidal increments over [t-1, t] */
+    float dalpha[3], dv[3];
+    for(int i = 0; i < 3; i++) {
+        dalpha[i] = 0.5f * (pi->last_w[i] + w[i]) * dt;
+        dv[i] = 0.5f * (pi->last_a[i] + a[i]) * dt;
+    }
+
+    /* Coning: beta += 1/2 (alpha + dalpha_prev / 6) x dalpha */
+    float tmp[3], c[3];
+    for(int i = 0; i < 3; i++) tmp[i] = pi->alpha[i] + pi->last_dalpha[i] * (1.0f / 6.0f);
+    cross(c, tmp, dalpha);
+    for(int i = 0; i < 3; i++) pi->beta[i] += 0.5f * c[i];
+
+    /* Sculling, same order as coning:
+     * scul += (alpha + dalpha_prev / 6) x dv + (vel + dv_prev / 6) x dalpha */
+    float c1[3], c2[3], tmp2[3];
+    for(int i = 0; i < 3; i++) {
+        tmp[i] = pi->alpha[i] + pi->last_dalpha[i] * (1.0f / 6.0f);
+        tmp2[i] = pi->vel[i] + pi->last_dv[i] * (1.0f / 6.0f);
+    }
+    cross(c1, tmp, dv);
+    cross(c2, tmp2, dalpha);
+    for(int i = 0; i < 3; i++) {
+        pi->scul[i] += c1[i] + c2[i];
+        pi->alpha[i] += dalpha[i];
+        pi->vel[i] += dv[i];
+        pi->last_dalpha[i] = dalpha[i];
+        pi->last_dv[i] = dv[i];
+    }
+
+    memcpy(pi->last_w, w, sizeof(w));
+    memcpy(pi->last_a, a, sizeof(a));
+    pi->count++;
+
+    /* Close the interval on the sample nearest to the boundary */
+    uint64_t elapsed_q8 = pi->recon_q8 - pi->start_q8;
+    if(elapsed_q8 + (uint64_t)(pi->period_q8 / 2) < ((uint64_t)pi->interval_us << 8)) return 0;
+
+    /* dV = vel + 1/2 alpha x vel + 1/2 scul */
+    float rot[3];
+    cross(rot, pi->alpha, pi->vel);
+    for(int i = 0; i < 3; i++) {
+        out->delta_angle[i] = pi->alpha[i] + pi->beta[i];
+        out->delta_velocity[i] = pi->vel[i] + 0.5f * rot[i] + 0.5f * pi->scul[i];
+    }
+    out->dt_us = (uint32_t)(elapsed_q8 >> 8);
+    out->timestamp_us = (uint32_t)(pi->recon_q8 >> 8) + (pi->last_raw_us - (uint32_t)(pi->raw_q8 >> 8));
+    out->samples = pi->count;
+
+    clear_interval(pi);
+    return 1;
+}
+
+#endif /* ICM42688_CFG_PREINTEGRATION */
@@ -0,0 +1,123 @@
+/**
+ * @file read_sched.c
+ * @brief Multi-rate register read scheduler implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "read_sched.h"
+#include <string.h>
+
+#if ICM42688_CFG_READ_SCHED
+
+/* Channel layout relative to TEMP_DATA1: temp, accel, gyro */
+static const uint8_t ch_offset[ICM42688_SCHED_CHANNELS] = { 0, 2, 8 };
+static const uint8_t ch_len[ICM42688_SCHED_CHANNELS] = { 2, 6, 6 };
+
+#define READ_ALL_BYTES 14
+
+/**
+ * @brief Build the burst list for one set of due channels
+ * @param plan Pointer to plan
+ * @param mask Due channels
+ * @param overhead_bytes Cost of an extra transaction in byte times
+ */
+static void build_plan(icm42688_sched_plan_t *plan, uint8_t mask, uint8_t overhead_bytes) {
+    icm42688_sched_span_t *cur = NULL;
+
+    plan->count = 0;
+    for(uint8_t ch = 0; ch < ICM42688_SCHED_CHANNELS; ch++) {
+        if(!(mask & (1u << ch))) continue;
+
+        uint8_t end = (uint8_t)(ch_offset[ch] + ch_len[ch]);
+        if(cur) {
+            uint8_t gap = (uint8_t)(ch_offset[ch] - (cur->offset + cur->len));
+
+            /* Reading through the gap costs no more than starting a new transaction */
+            if(gap <= overhead_bytes) {
+                cur->len = (uint8_t)(end - cur->offset);
+                continue;
+            }
+        }
+        cur = &plan->span[plan->count++];
+        cur->offset = ch_offset[ch];
+        cur->len = ch_len[ch];
+    }
+
+    /* A burst delivers every channel it covers completely, due or not */
+    for(uint8_t i = 0; i < plan->count; i++) {
+        icm42688_sched_span_t *sp = &plan->span[i];
+        sp->valid = 0;
+        for(uint8_t ch = 0; ch < ICM42688_SCHED_CHANNELS; ch++) {
+            if(ch_offset[ch] >= sp->offset && ch_offset[ch] + ch_len[ch] <= sp->offset + sp->len) {
+                sp->valid |= (uint8_t)(1u << ch);
+            }
+        }
+    }
+}
+
+int icm42688_sched_init(icm42688_sched_t *sch, icm42688_t *dev, uint16_t temp_div, uint16_t accel_div,
+                        uint16_t gyro_div, uint8_t overhead_bytes) {
+    if(!sch || !dev) return -1;
+    if(temp_div == 0 && accel_div == 0 && gyro_div == 0) return -1;
+
+    memset(sch, 0, sizeof(*sch));
+    sch->dev = dev;
+    sch->div[0] = temp_div;
+    sch->div[1] = accel_div;
+    sch->div[2] = gyro_div;
+
+    for(uint8_t mask = 0; mask < (1u << ICM42688_SCHED_CHANNELS); mask++) {
+        build_plan(&sch->plan[mask], mask, overhead_bytes);
+    }
+    return 0;
+}
+
+int icm42688_sched_tick(icm42688_sched_t *sch, icm42688_data_t *data, uint8_t *valid) {
+    if(!sch || !data || !valid) return -1;
+
+    uint8_t due = 0;
+    for(uint8_t ch = 0; ch < ICM42688_SCHED_CHANNELS; ch++) {
+        if(sch->div[ch] == 0) continue;
+        if(sch->phase[ch] == 0) {
+            due |= (uint8_t)(1u << ch);
+            sch->phase[ch] = sch->div[ch];
+        }
+        sch->phase[ch]--;
+    }
+
+    const icm42688_sched_plan_t *plan = &sch->plan[due];
+    uint8_t buf[READ_ALL_BYTES];
+    uint8_t got = 0;
+
+    for(uint8_t i = 0; i < plan->count; i++) {
+        const icm42688_sched_span_t *sp = &plan->span[i];
+        if(sch->dev->bus.read((uint8_t)(ICM42688_REG_TEMP_DATA1 + sp->offset), &buf[sp->offset], sp->len) != 0) return -2;
+        got |= sp->valid;
+        sch->stats.transactions++;
+        sch->stats.bytes += sp->len;
+    }
+    sch->stats.ticks++;
+    sch->stats.read_all_bytes += READ_ALL_BYTES;
+
+    icm42688_data_t *d = &sch->data;
+    if(got & ICM42688_SCHED_VALID_TEMP) {
+        d->temp = (int16_t)((buf[0] << 8) | buf[1]);
+    }
+    if(got & ICM42688_SCHED_VALID_ACCEL) {
+        d->accel_x = (int16_t)((buf[2] << 8) | buf[3]);
+        d->accel_y = (int16_t)((buf[4] << 8) | buf[5]);
+        d->accel_z = (int16_t)((buf[6] << 8) | buf[7]);
+    }
+    if(got & ICM42688_SCHED_VALID_GYRO) {
+        d->gyro_x = (int16_t)((buf[8] << 8) | buf[9]);
+        d->gyro_y = (int16_t)((buf[10] << 8) | buf[11]);
+        d->gyro_z = (int16_t)((buf[12] << 8) | buf[13]);
+    }
+
+    *data = *d;
+    *valid = got;
+    return 0;
+}
+
+#endif /* ICM42688_CFG_READ_SCHED */
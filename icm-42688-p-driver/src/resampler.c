@@ -0,0 +1,300 @@
+/**
+ * @file resampler.c
+ * @brief Polyphase resampler implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "resampler.h"
+#include <math.h>
+#include <string.h>
+
+#if ICM42688_CFG_RESAMPLER
+
+#define P     ICM42688_RESAMPLE_PHASES
+#define T     ICM42688_RESAMPLE_TAPS
+#define CH    ICM42688_RESAMPLE_CHANNELS
+#define PI_F  3.14159265358979f
+
+/* Window taps j = CENTER and CENTER + 1 bracket the output time */
+#define CENTER (T / 2 - 1)
+
+/* Sum of (2j - T + 1)^2 over the window, for the grid fit */
+#define GRID_SXX ((int64_t)T * (T * T - 1) / 3)
+
+/**
+ * @brief Store one filter row, quantizing if needed
+ * @param rs Pointer to resampler
+ * @param phase Row index
+ * @param row Coefficients, summing to 1
+ */
+static void store_row(icm42688_resampler_t *rs, int phase, const float *row) {
+#if ICM42688_RESAMPLE_FIXED
+    /* Q14, with the rounding residual folded into the largest tap for exact DC gain */
+    int32_t sum = 0;
+    int big = 0;
+    for(int j = 0; j < T; j++) {
+        rs->coef[phase][j] = (int16_t)lrintf(row[j] * 16384.0f);
+        sum += rs->coef[phase][j];
+        if(fabsf(row[j]) > fabsf(row[big])) big = j;
+    }
+    rs->coef[phase][big] = (int16_t)(rs->coef[phase][big] + (16384 - sum));
+#else
+    for(int j = 0; j < T; j++) {
+        rs->coef[phase][j] = row[j];
+    }
+#endif
+}
+
+/**
+ * @brief Apply one filter row to all channels and write the output sample
+ * @param rs Pointer to resampler
+ * @param c Filter row, starting at window tap first
+ * @param first First window tap
+ * @param taps Number of taps
+ * @param out Output sample
+ */
+static void interpolate(const icm42688_resampler_t *rs, const icm42688_resample_coef_t *c, int first, int taps,
+                        icm42688_data_t *out) {
+    int16_t v[CH];
+
+    for(int ch = 0; ch < CH; ch++) {
+        /* Oldest sample of the window sits at pos + 1 in the mirrored buffer */
+        const icm42688_resample_hist_t *x = &rs->hist[ch][rs->pos + 1 + first];
+#if ICM42688_RESAMPLE_FIXED
+        int32_t acc = 0x2000;
+        for(int j = 0; j < taps; j++) {
+            acc += (int32_t)x[j] * c[j];
+        }
+        acc >>= 14;
+#else
+        float sum = 0.0f;
+        for(int j = 0; j < taps; j++) {
+            sum += x[j] * c[j];
+        }
+        long acc = lrintf(sum);
+#endif
+        if(acc > INT16_MAX) acc = INT16_MAX;
+        if(acc < INT16_MIN) acc = INT16_MIN;
+        v[ch] = (int16_t)acc;
+    }
+
+    out->accel_x = v[0];
+    out->accel_y = v[1];
+    out->accel_z = v[2];
+    out->gyro_x = v[3];
+    out->gyro_y = v[4];
+    out->gyro_z = v[5];
+    out->temp = v[6];
+}
+
+/**
+ * @brief Fit a uniform grid to the input times of the window
+ *
+ * The polyphase rows assume equally spaced inputs. A least-squares line
+ * through the window timestamps gives the grid the rows are applied on, and
+ * every tap gets a first-order correction factor that moves its value from
+ * the actual sample time to its grid point, using the slope between its
+ * neighbours: x'[j] = x[j] + corr[j] * (x[j+1] - x[j-1]).
+ *
+ * @param rs Pointer to resampler
+ * @param grid Output: grid times of window taps CENTER and CENTER + 1, us * 2^16
+ * @param corr Output: per-tap correction factors (Q14 in fixed point)
+ * @return 1 if any tap is more than 1 us off its grid point, 0 otherwise
+ */
+static int fit_grid(const icm42688_resampler_t *rs, int64_t grid[2], icm42688_resample_coef_t corr[T]) {
+    const int64_t *t = &rs->hist_t[rs->pos + 1];
+    int64_t sum = 0, sxy = 0;
+    int irregular = 0;
+
+    for(int j = 0; j < T; j++) {
+        sum += t[j] - t[0];
+        sxy += (int64_t)(2 * j - T + 1) * (t[j] - t[0]);
+    }
+
+    /* g[j] = mean + slope * (2j - T + 1) / 2, all in us * 2^16 */
+    int64_t mean_q16 = (t[0] << 16) + (sum << 16) / T;
+    int64_t half_slope_q16 = (sxy << 16) / GRID_SXX;
+
+    for(int j = 0; j < T; j++) {
+        int64_t g = mean_q16 + half_slope_q16 * (2 * j - T + 1);
+        int64_t dev = g - (t[j] << 16);
+        int lo = j > 0 ? j - 1 : j;
+        int hi = j < T - 1 ? j + 1 : j;
+        int64_t dt = t[hi] - t[lo];
+
+        if(dev > 65536 || dev < -65536) irregular = 1;
+#if ICM42688_RESAMPLE_FIXED
+        corr[j] = (int16_t)(dt > 0 ? (dev >> 2) / dt : 0);
+#else
+        corr[j] = dt > 0 ? (float)dev / 65536.0f / (float)dt : 0.0f;
+#endif
+        if(j == CENTER) grid[0] = g;
+        if(j == CENTER + 1) grid[1] = g;
+    }
+    return irregular;
+}
+
+/**
+ * @brief Fold the per-tap time corrections into one filter row
+ * @param rs Pointer to resampler
+ * @param phase Row index
+ * @param corr Per-tap correction factors from fit_grid()
+ * @param row Output row over the whole window (T taps)
+ */
+static void corrected_row(const icm42688_resampler_t *rs, int phase, const icm42688_resample_coef_t corr[T],
+                          icm42688_resample_coef_t row[T]) {
+    const icm42688_resample_coef_t *c = rs->coef[phase];
+
+    memcpy(row, c, sizeof(rs->coef[phase]));
+    for(int j = rs->first_tap; j < rs->first_tap + rs->num_taps; j++) {
+        int lo = j > 0 ? j - 1 : j;
+        int hi = j < T - 1 ? j + 1 : j;
+#if ICM42688_RESAMPLE_FIXED
+        int16_t k = (int16_t)(((int32_t)c[j] * corr[j] + 0x2000) >> 14);
+#else
+        float k = c[j] * corr[j];
+#endif
+        /* The +k / -k pairs cancel, so the DC gain stays exactly one */
+        row[hi] += k;
+        row[lo] -= k;
+    }
+}
+
+/**
+ * @brief Append an input sample to the mirrored history
+ * @param rs Pointer to resampler
+ * @param s Input sample
+ */
+static void push_history(icm42688_resampler_t *rs, const icm42688_sample_t *s) {
+    if(rs->filled == 0 && !rs->started) {
+        rs->origin_us = s->timestamp_us;
+        rs->last_raw_us = s->timestamp_us;
+        rs->last_t = 0;
+    }
+    rs->last_t += (int32_t)(s->timestamp_us - rs->last_raw_us);
+    rs->last_raw_us = s->timestamp_us;
+
+    uint8_t p = (uint8_t)((rs->pos + 1) % T);
+    const icm42688_data_t *d = &s->data;
+    const int16_t v[CH] = { d->accel_x, d->accel_y, d->accel_z, d->gyro_x, d->gyro_y, d->gyro_z, d->temp };
+
+    for(int ch = 0; ch < CH; ch++) {
+        rs->hist[ch][p] = v[ch];
+        rs->hist[ch][p + T] = v[ch];
+    }
+    rs->hist_t[p] = rs->last_t;
+    rs->hist_t[p + T] = rs->last_t;
+    rs->pos = p;
+    if(rs->filled < T) rs->filled++;
+}
+
+int icm42688_resample_init(icm42688_resampler_t *rs, icm42688_resample_kernel_t kernel,
+                           uint32_t out_hz, float cutoff) {
+    if(!rs || out_hz == 0) return -1;
+    if(kernel == ICM42688_RESAMPLE_SINC && !(cutoff > 0.0f && cutoff <= 1.0f)) return -1;
+
+    memset(rs, 0, sizeof(*rs));
+    rs->period_q16 = (1000000ULL << 16) / out_hz;
+    rs->pos = T - 1;
+
+    for(int p = 0; p <= P; p++) {
+        float mu = (float)p / (float)P;
+        float row[T] = {0};
+
+        if(kernel == ICM42688_RESAMPLE_CUBIC) {
+            /* Catmull-Rom over window taps CENTER-1 .. CENTER+2 */
+            float mu2 = mu * mu, mu3 = mu2 * mu;
+            row[CENTER - 1] = 0.5f * (-mu3 + 2.0f * mu2 - mu);
+            row[CENTER]     = 0.5f * (3.0f * mu3 - 5.0f * mu2 + 2.0f);
+            row[CENTER + 1] = 0.5f * (-3.0f * mu3 + 4.0f * mu2 + mu);
+            row[CENTER + 2] = 0.5f * (mu3 - mu2);
+        } else {
+            float sum = 0.0f;
+            for(int j = 0; j < T; j++) {
+                float d = (float)(j - CENTER) - mu;
+                float x = PI_F * cutoff * d;
+                float h = (fabsf(x) < 1e-6f) ? cutoff : cutoff * sinf(x) / x;
+                float r = d / (float)(T / 2);
+                float w = (fabsf(r) < 1.0f)
+                        ? 0.42f + 0.5f * cosf(PI_F * r) + 0.08f * cosf(2.0f * PI_F * r)
+                        : 0.0f;
+                row[j] = h * w;
+                sum += row[j];
+            }
+            for(int j = 0; j < T; j++) {
+                row[j] /= sum;
+            }
+        }
+        store_row(rs, p, row);
+    }
+
+    if(kernel == ICM42688_RESAMPLE_CUBIC) {
+        rs->first_tap = CENTER - 1;
+        rs->num_taps = 4;
+    } else {
+        rs->first_tap = 0;
+        rs->num_taps = T;
+    }
+    return 0;
+}
+
+int icm42688_resample_process(icm42688_resampler_t *rs, const icm42688_sample_t *in, uint16_t count,
+                              icm42688_sample_t *out, uint16_t max_out, uint16_t *consumed) {
+    if(!rs || (!in && count) || (!out && max_out) || !consumed) return -1;
+
+    icm42688_resample_coef_t corr[T];
+    icm42688_resample_coef_t row[T];
+    uint16_t i = 0;
+    uint16_t n = 0;
+
+    for(;;) {
+        if(rs->filled == T) {
+            int64_t grid[2] = { 0, 0 };
+            int irregular = fit_grid(rs, grid, corr);
+            int64_t t0_q16 = grid[0] > 0 ? grid[0] : 0;
+            int64_t t1_q16 = grid[1];
+
+            if(!rs->started) {
+                rs->next_out_q16 = (uint64_t)t0_q16;
+                rs->started = 1;
+            }
+
+            /* Input gap: skip grid points that fell more than a period before this bracket */
+            if((int64_t)rs->next_out_q16 + (int64_t)rs->period_q16 < t0_q16) {
+                uint64_t behind = (uint64_t)t0_q16 - rs->next_out_q16;
+                rs->next_out_q16 += ((behind + rs->period_q16 - 1) / rs->period_q16) * rs->period_q16;
+            }
+
+            while(t1_q16 > t0_q16 && (int64_t)rs->next_out_q16 < t1_q16) {
+                if(n == max_out) {
+                    *consumed = i;
+                    return n;
+                }
+
+                /* Successive fits can overlap by a fraction of a microsecond; clamp to the bracket */
+                int64_t rel = (int64_t)rs->next_out_q16 - t0_q16;
+                uint64_t mu_q16 = rel > 0 ? ((uint64_t)rel << 16) / (uint64_t)(t1_q16 - t0_q16) : 0;
+                int phase = (int)((mu_q16 * P + 0x8000) >> 16);
+
+                if(irregular) {
+                    corrected_row(rs, phase, corr, row);
+                    interpolate(rs, row, 0, T, &out[n].data);
+                } else {
+                    interpolate(rs, &rs->coef[phase][rs->first_tap], rs->first_tap, rs->num_taps, &out[n].data);
+                }
+                out[n].timestamp_us = rs->origin_us + (uint32_t)(rs->next_out_q16 >> 16);
+                n++;
+                rs->next_out_q16 += rs->period_q16;
+            }
+        }
+
+        if(i == count) break;
+        push_history(rs, &in[i++]);
+    }
+
+    *consumed = i;
+    return n;
+}
+
+#endif /* ICM42688_CFG_RESAMPLER */
@@ -0,0 +1,293 @@
+/**
+ * @file sample_codec.c
+ * @brief Lossless block codec for ICM-42688 sample logs
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "sample_codec.h"
+#include <stddef.h>
+#include <string.h>
+
+#if ICM42688_CFG_SAMPLE_CODEC
+
+#define CH ICM42688_CODEC_CHANNELS
+
+_Static_assert(ICM42688_CODEC_BLOCK_MAX >= 1 && ICM42688_CODEC_BLOCK_MAX <= 255,
+               "block sample count must fit the one-byte count field");
+
+/* Channel order inside a block */
+static const uint8_t channel_offset[CH] = {
+    offsetof(icm42688_data_t, accel_x), offsetof(icm42688_data_t, accel_y),
+    offsetof(icm42688_data_t, accel_z), offsetof(icm42688_data_t, gyro_x),
+    offsetof(icm42688_data_t, gyro_y),  offsetof(icm42688_data_t, gyro_z),
+    offsetof(icm42688_data_t, temp)
+};
+
+/**
+ * @brief Bit writer state
+ */
+typedef struct {
+    uint8_t *p;     /**< Next output byte */
+    uint32_t acc;   /**< Pending bits */
+    uint8_t bits;   /**< Number of pending bits */
+} bit_writer_t;
+
+/**
+ * @brief Read channel value of a sample
+ * @param d Pointer to sample
+ * @param ch Channel index
+ * @return Channel value
+ */
+static inline int16_t get_channel(const icm42688_data_t *d, int ch) {
+    return *(const int16_t *)((const uint8_t *)d + channel_offset[ch]);
+}
+
+/**
+ * @brief Zigzag map signed residual to unsigned
+ * @param v Residual
+ * @return Zigzag code
+ */
+static inline uint16_t zigzag(int16_t v) {
+    return (uint16_t)(((uint16_t)v << 1) ^ (uint16_t)(v >> 15));
+}
+
+/**
+ * @brief Inverse zigzag mapping
+ * @param z Zigzag code
+ * @return Residual
+ */
+static inline uint16_t unzigzag(uint16_t z) {
+    return (uint16_t)((z >> 1) ^ (uint16_t)-(int16_t)(z & 1));
+}
+
+/**
+ * @brief Number of bits needed to hold a value
+ * @param v Value
+ * @return Bit width (0..16)
+ */
+static uint8_t bit_width(uint16_t v) {
+    uint8_t w = 0;
+    while(v) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+}
+
+/**
+ * @brief Compute zigzag residuals of one channel with a given predictor
+ * @param in Input samples
+ * @param count Number of samples
+ * @param ch Channel index
+ * @param pred Predictor
+ * @param zz Output residuals for samples 1..count-1
+ * @return Bit width covering all residuals
+ */
+static uint8_t residuals(const icm42688_data_t *in, uint16_t count, int ch,
+                         icm42688_codec_pred_t pred, uint16_t *zz) {
+    uint16_t all = 0;
+    uint16_t prev2 = 0;
+    uint16_t prev = (uint16_t)get_channel(&in[0], ch);
+
+    for(uint16_t n = 1; n < count; n++) {
+        uint16_t x = (uint16_t)get_channel(&in[n], ch);
+        uint16_t p = (pred == ICM42688_CODEC_PRED_LINEAR && n >= 2) ? (uint16_t)(2 * prev - prev2) : prev;
+        uint16_t z = zigzag((int16_t)(uint16_t)(x - p));
+        zz[n - 1] = z;
+        all |= z;
+        prev2 = prev;
+        prev = x;
+    }
+    return bit_width(all);
+}
+
+/**
+ * @brief Append value to bit stream
+ * @param w Pointer to writer
+ * @param v Value
+ * @param width Number of bits (0..16)
+ */
+static inline void put_bits(bit_writer_t *w, uint16_t v, uint8_t width) {
+    w->acc |= (uint32_t)v << w->bits;
+    w->bits += width;
+    while(w->bits >= 8) {
+        *w->p++ = (uint8_t)w->acc;
+        w->acc >>= 8;
+        w->bits -= 8;
+    }
+}
+
+/**
+ * @brief Unpack fixed-width values from a bit stream
+ *
+ * Every value is fetched independently with one unaligned 32-bit load at its
+ * own bit offset, so there is no carried reader state between iterations.
+ * The last few values, whose load would run past the block, take the byte
+ * path.
+ *
+ * @param base Payload start
+ * @param end One past the last payload byte
+ * @param bitpos Bit offset of the first value
+ * @param width Bits per value (1..16)
+ * @param n Number of values
+ * @param dst Output values
+ */
+static void unpack(const uint8_t *base, const uint8_t *end, uint32_t bitpos, uint8_t width,
+                   uint16_t n, uint16_t *dst) {
+    const uint32_t mask = (1UL << width) - 1;
+    uint16_t i = 0;
+
+    for(; i < n; i++, bitpos += width) {
+        const uint8_t *q = base + (bitpos >> 3);
+        if(end - q < 4) break;
+        uint32_t word;
+        memcpy(&word, q, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap32(word);
+#endif
+        dst[i] = (uint16_t)((word >> (bitpos & 7)) & mask);
+    }
+    for(; i < n; i++, bitpos += width) {
+        const uint8_t *q = base + (bitpos >> 3);
+        uint32_t word = 0;
+        for(int b = 0; b < 3 && q + b < end; b++) word |= (uint32_t)q[b] << (8 * b);
+        dst[i] = (uint16_t)((word >> (bitpos & 7)) & mask);
+    }
+}
+
+int icm42688_codec_encode(const icm42688_data_t *in, uint16_t count, icm42688_codec_pred_t pred,
+                          uint8_t *out, uint16_t out_size) {
+    if(!in || !out || count == 0 || count > ICM42688_CODEC_BLOCK_MAX) return -1;
+    if(pred > ICM42688_CODEC_PRED_LINEAR) return -1;
+
+    uint16_t zz[ICM42688_CODEC_BLOCK_MAX];
+    uint16_t zz_alt[ICM42688_CODEC_BLOCK_MAX];
+    uint8_t desc[CH];
+    uint32_t payload_bits = 0;
+
+    /* First pass: choose predictor and width per channel */
+    for(int ch = 0; ch < CH; ch++) {
+        icm42688_codec_pred_t p = (pred == ICM42688_CODEC_PRED_AUTO) ? ICM42688_CODEC_PRED_DELTA : pred;
+        uint8_t width = residuals(in, count, ch, p, zz);
+
+        if(pred == ICM42688_CODEC_PRED_AUTO && count > 2) {
+            uint8_t alt = residuals(in, count, ch, ICM42688_CODEC_PRED_LINEAR, zz_alt);
+            if(alt < width) {
+                width = alt;
+                p = ICM42688_CODEC_PRED_LINEAR;
+            }
+        }
+        desc[ch] = (uint8_t)(width | (p << 5));
+        payload_bits += (uint32_t)width * (count - 1);
+    }
+
+    uint32_t total = 2 + 3 * CH + (payload_bits + 7) / 8;
+    if(total > out_size) return -3;
+
+    uint8_t *o = out;
+    *o++ = ICM42688_CODEC_MAGIC;
+    *o++ = (uint8_t)count;
+    for(int ch = 0; ch < CH; ch++) {
+        uint16_t seed = (uint16_t)get_channel(&in[0], ch);
+        *o++ = (uint8_t)(seed & 0xFF);
+        *o++ = (uint8_t)(seed >> 8);
+        *o++ = desc[ch];
+    }
+
+    /* Second pass: pack residuals */
+    bit_writer_t w = { o, 0, 0 };
+    for(int ch = 0; ch < CH; ch++) {
+        uint8_t width = desc[ch] & 0x1F;
+        if(width == 0) continue;
+
+        residuals(in, count, ch, (icm42688_codec_pred_t)(desc[ch] >> 5), zz);
+        for(uint16_t n = 0; n + 1 < count; n++) {
+            put_bits(&w, zz[n], width);
+        }
+    }
+    if(w.bits) *w.p++ = (uint8_t)w.acc;
+
+    return (int)(w.p - out);
+}
+
+int icm42688_codec_decode_soa(const uint8_t *in, uint16_t in_size,
+                              int16_t soa[ICM42688_CODEC_CHANNELS][ICM42688_CODEC_BLOCK_MAX],
+                              uint16_t *count) {
+    if(!in || !soa || !count) return -1;
+    if(in_size < 2 + 3 * CH || in[0] != ICM42688_CODEC_MAGIC) return -2;
+
+    uint16_t n_samples = in[1];
+    if(n_samples == 0 || n_samples > ICM42688_CODEC_BLOCK_MAX) return -2;
+
+    /* Validate descriptors and payload length before touching the bit stream */
+    uint32_t payload_bits = 0;
+    for(int ch = 0; ch < CH; ch++) {
+        uint8_t desc = in[2 + 3 * ch + 2];
+        uint8_t width = desc & 0x1F;
+        uint8_t pred = desc >> 5;
+        if(width > 16 || pred < ICM42688_CODEC_PRED_DELTA || pred > ICM42688_CODEC_PRED_LINEAR) return -2;
+        payload_bits += (uint32_t)width * (n_samples - 1);
+    }
+    uint32_t total = 2 + 3 * CH + (payload_bits + 7) / 8;
+    if(total > in_size) return -2;
+
+    const uint8_t *payload = &in[2 + 3 * CH];
+    const uint8_t *end = &in[total];
+    uint32_t bitpos = 0;
+
+    for(int ch = 0; ch < CH; ch++) {
+        const uint8_t *hdr = &in[2 + 3 * ch];
+        uint8_t width = hdr[2] & 0x1F;
+        uint8_t pred = hdr[2] >> 5;
+        int16_t *col = soa[ch];
+        uint16_t zz[ICM42688_CODEC_BLOCK_MAX];
+        uint16_t prev = (uint16_t)(hdr[0] | (hdr[1] << 8));
+        uint16_t prev2 = prev;
+
+        /* Pass 1: bulk unpack, pass 2: undo the prediction */
+        if(width) unpack(payload, end, bitpos, width, (uint16_t)(n_samples - 1), zz);
+        else memset(zz, 0, (n_samples - 1) * sizeof(zz[0]));
+        bitpos += (uint32_t)width * (n_samples - 1);
+
+        col[0] = (int16_t)prev;
+        if(pred == ICM42688_CODEC_PRED_DELTA) {
+            for(uint16_t n = 1; n < n_samples; n++) {
+                prev = (uint16_t)(prev + unzigzag(zz[n - 1]));
+                col[n] = (int16_t)prev;
+            }
+            continue;
+        }
+        for(uint16_t n = 1; n < n_samples; n++) {
+            uint16_t p = n >= 2 ? (uint16_t)(2 * prev - prev2) : prev;
+            uint16_t x = (uint16_t)(p + unzigzag(zz[n - 1]));
+            col[n] = (int16_t)x;
+            prev2 = prev;
+            prev = x;
+        }
+    }
+
+    *count = n_samples;
+    return (int)total;
+}
+
+int icm42688_codec_decode(const uint8_t *in, uint16_t in_size, icm42688_data_t *out, uint16_t *count) {
+    if(!out || !count) return -1;
+
+    int16_t soa[CH][ICM42688_CODEC_BLOCK_MAX];
+    int used = icm42688_codec_decode_soa(in, in_size, soa, count);
+    if(used < 0) return used;
+
+    for(uint16_t n = 0; n < *count; n++) {
+        out[n].accel_x = soa[0][n];
+        out[n].accel_y = soa[1][n];
+        out[n].accel_z = soa[2][n];
+        out[n].gyro_x = soa[3][n];
+        out[n].gyro_y = soa[4][n];
+        out[n].gyro_z = soa[5][n];
+        out[n].temp = soa[6][n];
+    }
+    return used;
+}
+
+#endif /* ICM42688_CFG_SAMPLE_CODEC */
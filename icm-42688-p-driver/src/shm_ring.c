@@ -0,0 +1,323 @@
+/**
+ * @file shm_ring.c
+ * @brief Shared-memory sample ring implementation (Linux)
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#if defined(__linux__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  /* syscall, shm_open */
+#endif
+
+#include "shm_ring.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WAIT_SUFFIX "-wait"
+#define WAIT_SIZE   64
+
+/**
+ * @brief Size of a mapping with the given capacity
+ * @param capacity Slots
+ * @return Bytes
+ */
+static size_t ring_size(uint32_t capacity) {
+    return sizeof(icm42688_shm_ring_t) + (size_t)capacity * sizeof(icm42688_sample_t);
+}
+
+/**
+ * @brief Sleep until the futex word changes from the observed value
+ * @param word Futex word (may be in a read-only shared mapping)
+ * @param seen Observed value
+ * @param timeout_ms Timeout, -1 = forever
+ */
+static void futex_wait(const uint32_t *word, uint32_t seen, int timeout_ms) {
+    struct timespec ts;
+    struct timespec *tp = NULL;
+
+    if(timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        tp = &ts;
+    }
+    /* Shared futex: the key is the backing page, valid across processes */
+    syscall(SYS_futex, word, FUTEX_WAIT, seen, tp, NULL, 0);
+}
+
+/**
+ * @brief Map the side object holding the sleeping-subscriber count
+ * @param name Ring name
+ * @param create Nonzero to create a fresh object (publisher)
+ * @return Waiter count, NULL on failure
+ */
+static uint32_t *waiters_map(const char *name, int create) {
+    char wname[64 + sizeof(WAIT_SUFFIX)];
+    int fd;
+
+    snprintf(wname, sizeof(wname), "%s" WAIT_SUFFIX, name);
+    if(create) {
+        shm_unlink(wname);
+        fd = shm_open(wname, O_CREAT | O_EXCL | O_RDWR, 0666);
+        /* Subscribers may run as other users; the umask must not make this read-only */
+        if(fd >= 0 && (fchmod(fd, 0666) != 0 || ftruncate(fd, WAIT_SIZE) != 0)) {
+            close(fd);
+            shm_unlink(wname);
+            return NULL;
+        }
+    } else {
+        fd = shm_open(wname, O_RDWR, 0);
+    }
+    if(fd < 0) return NULL;
+
+    void *map = mmap(NULL, WAIT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return map == MAP_FAILED ? NULL : (uint32_t *)map;
+}
+
+/**
+ * @brief Mark a ring closed and wake every subscriber sleeping on it
+ * @param ring Ring mapped read-write
+ */
+static void ring_close(icm42688_shm_ring_t *ring) {
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&ring->wake, 1, __ATOMIC_SEQ_CST);
+    syscall(SYS_futex, &ring->wake, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Close a ring left under this name by an earlier publisher
+ * @param name Ring name
+ */
+static void ring_close_existing(const char *name) {
+    struct stat st;
+    int fd = shm_open(name, O_RDWR, 0);
+    if(fd < 0) return;
+
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(icm42688_shm_ring_t)) {
+        void *map = mmap(NULL, sizeof(icm42688_shm_ring_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(map != MAP_FAILED) {
+            icm42688_shm_ring_t *ring = (icm42688_shm_ring_t *)map;
+            if(ring->magic == ICM42688_SHM_MAGIC && ring->version == ICM42688_SHM_VERSION) ring_close(ring);
+            munmap(map, sizeof(icm42688_shm_ring_t));
+        }
+    }
+    close(fd);
+}
+
+int icm42688_shm_create(icm42688_shm_pub_t *pub, const char *name, uint32_t capacity) {
+    if(!pub || !name) return -1;
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0) return -1;
+    if(strlen(name) + sizeof(WAIT_SUFFIX) > sizeof(pub->name)) return -1;
+
+    memset(pub, 0, sizeof(*pub));
+    size_t size = ring_size(capacity);
+
+    /* Start from a fresh object so old subscribers cannot mix layouts; tell them first */
+    ring_close_existing(name);
+    shm_unlink(name);
+
+    /* Before the ring: a subscriber that finds the ring also finds the waiter count */
+    pub->waiters = waiters_map(name, 1);
+    if(!pub->waiters) return -2;
+
+    void *map = MAP_FAILED;
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd >= 0) {
+        if(ftruncate(fd, (off_t)size) == 0) map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(map == MAP_FAILED) shm_unlink(name);
+    }
+    if(map == MAP_FAILED) {
+        munmap(pub->waiters, WAIT_SIZE);
+        pub->waiters = NULL;
+        return -2;
+    }
+
+    icm42688_shm_ring_t *ring = (icm42688_shm_ring_t *)map;
+    ring->capacity = capacity;
+    ring->slot_size = sizeof(icm42688_sample_t);
+    ring->version = ICM42688_SHM_VERSION;
+
+    /* Magic last: subscribers reject the ring until the header is complete */
+    __atomic_store_n(&ring->magic, ICM42688_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    pub->ring = ring;
+    pub->map_size = size;
+    strcpy(pub->name, name);
+    return 0;
+}
+
+int icm42688_shm_publish(icm42688_shm_pub_t *pub, const icm42688_sample_t *samples, uint32_t count) {
+    if(!pub || !pub->ring || !samples) return -1;
+
+    icm42688_shm_ring_t *ring = pub->ring;
+    if(count == 0) return 0;
+    if(count > ring->capacity) return -1;
+
+    uint32_t mask = ring->capacity - 1;
+    uint64_t head = ring->head;
+
+    /* Announce the overwrite before touching the slots */
+    __atomic_store_n(&ring->reserve, head + count, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    uint32_t pos = (uint32_t)(head & mask);
+    uint32_t first = ring->capacity - pos;
+    if(first > count) first = count;
+    memcpy(&ring->slots[pos], samples, first * sizeof(*samples));
+    memcpy(&ring->slots[0], samples + first, (count - first) * sizeof(*samples));
+
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+
+    /*
+     * Bump the futex word before reading the waiter count; a subscriber
+     * counts itself before reading the word, so either it is counted here or
+     * it sees the new value and does not sleep.
+     */
+    __atomic_fetch_add(&ring->wake, 1, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(pub->waiters, __ATOMIC_SEQ_CST) != 0) {
+        syscall(SYS_futex, &ring->wake, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        pub->wakes++;
+    }
+    return 0;
+}
+
+void icm42688_shm_destroy(icm42688_shm_pub_t *pub, int unlink) {
+    if(!pub || !pub->ring) return;
+
+    ring_close(pub->ring);
+    munmap(pub->ring, pub->map_size);
+    munmap(pub->waiters, WAIT_SIZE);
+    if(unlink) {
+        char wname[64 + sizeof(WAIT_SUFFIX)];
+        snprintf(wname, sizeof(wname), "%s" WAIT_SUFFIX, pub->name);
+        shm_unlink(pub->name);
+        shm_unlink(wname);
+    }
+    pub->ring = NULL;
+    pub->waiters = NULL;
+}
+
+int icm42688_shm_subscribe(icm42688_shm_sub_t *sub, const char *name) {
+    if(!sub || !name) return -1;
+
+    memset(sub, 0, sizeof(*sub));
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0) return -2;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(icm42688_shm_ring_t)) {
+        close(fd);
+        return -3;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return -2;
+
+    const icm42688_shm_ring_t *ring = (const icm42688_shm_ring_t *)map;
+    if(__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != ICM42688_SHM_MAGIC ||
+       ring->version != ICM42688_SHM_VERSION || ring->slot_size != sizeof(icm42688_sample_t) ||
+       ring->capacity == 0 || ring_size(ring->capacity) > (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        return -3;
+    }
+
+    sub->waiters = waiters_map(name, 0);
+    if(!sub->waiters) {
+        munmap(map, (size_t)st.st_size);
+        return -2;
+    }
+
+    sub->ring = ring;
+    sub->map_size = (size_t)st.st_size;
+    sub->cursor = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return 0;
+}
+
+int icm42688_shm_peek(icm42688_shm_sub_t *sub, const icm42688_sample_t **batch, uint32_t max, int timeout_ms) {
+    if(!sub || !sub->ring || !batch || max == 0) return -1;
+
+    const icm42688_shm_ring_t *ring = sub->ring;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if(head == sub->cursor && timeout_ms != 0 && !__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE)) {
+        /* Count ourselves before reading the futex word (see icm42688_shm_publish) */
+        __atomic_fetch_add(sub->waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t seen = __atomic_load_n(&ring->wake, __ATOMIC_SEQ_CST);
+
+        /* Re-check after reading the futex word so a publish in between is not missed */
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if(head == sub->cursor && !__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE)) {
+            futex_wait(&ring->wake, seen, timeout_ms);
+            head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        }
+        __atomic_fetch_sub(sub->waiters, 1, __ATOMIC_SEQ_CST);
+    }
+    if(head == sub->cursor) return __atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE) ? -3 : 0;
+
+    /* Lapped: resume at the oldest sample still in the ring */
+    if(head - sub->cursor > ring->capacity) {
+        uint64_t oldest = head - ring->capacity;
+        sub->stats.lost += oldest - sub->cursor;
+        sub->stats.overruns++;
+        sub->cursor = oldest;
+    }
+
+    uint32_t mask = ring->capacity - 1;
+    uint32_t pos = (uint32_t)(sub->cursor & mask);
+    uint64_t avail = head - sub->cursor;
+    uint32_t n = ring->capacity - pos;
+    if(n > avail) n = (uint32_t)avail;
+    if(n > max) n = max;
+
+    *batch = &ring->slots[pos];
+    return (int)n;
+}
+
+int icm42688_shm_release(icm42688_shm_sub_t *sub, uint32_t count) {
+    if(!sub || !sub->ring) return -1;
+
+    const icm42688_shm_ring_t *ring = sub->ring;
+
+    /* Order the caller's reads of the batch before the overwrite check */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint64_t reserve = __atomic_load_n(&ring->reserve, __ATOMIC_RELAXED);
+
+    if(reserve > sub->cursor + ring->capacity) {
+        /* Slots from the cursor up to reserve - capacity were rewritten */
+        uint64_t oldest = reserve - ring->capacity;
+        uint64_t end = sub->cursor + count;
+        uint64_t next = oldest > end ? oldest : end;
+        sub->stats.lost += next - sub->cursor;
+        sub->stats.overruns++;
+        sub->cursor = next;
+        return -3;
+    }
+
+    sub->cursor += count;
+    sub->stats.consumed += count;
+    return 0;
+}
+
+void icm42688_shm_unsubscribe(icm42688_shm_sub_t *sub) {
+    if(!sub || !sub->ring) return;
+
+    munmap((void *)sub->ring, sub->map_size);
+    munmap(sub->waiters, WAIT_SIZE);
+    sub->ring = NULL;
+    sub->waiters = NULL;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,405 @@
+/**
+ * @file spectrum.c
+ * @brief Streaming Welch PSD vibration analysis implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "spectrum.h"
+#include <math.h>
+#include <string.h>
+
+#if ICM42688_CFG_SPECTRUM
+
+#if ICM42688_SPECTRUM_N != 64 && ICM42688_SPECTRUM_N != 256 && ICM42688_SPECTRUM_N != 1024
+#error "ICM42688_SPECTRUM_N must be 64, 256 or 1024"
+#endif
+
+#define N     ICM42688_SPECTRUM_N
+#define HALF  (ICM42688_SPECTRUM_N / 2)
+#define PI_F  3.14159265358979f
+
+#if ICM42688_SPECTRUM_FIXED
+
+#define LOG2N (ICM42688_SPECTRUM_N == 64 ? 6 : (ICM42688_SPECTRUM_N == 256 ? 8 : 10))
+
+/**
+ * @brief Saturate a rounded Q15 product to int16
+ * @param v Q30 value
+ * @return Q15 value
+ */
+static inline int16_t sat_q15(int32_t v) {
+    v = (v + 0x4000) >> 15;
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+/**
+ * @brief Number of significant bits
+ * @param v Value
+ * @return Position of the highest set bit plus one, 0 for 0
+ */
+static inline int bit_length(uint32_t v) {
+    int n = 0;
+    while(v) {
+        n++;
+        v >>= 1;
+    }
+    return n;
+}
+
+/**
+ * @brief Branch-free magnitude, one less than |v| for negative v
+ * @param v Value
+ * @return v ^ sign(v)
+ */
+static inline uint32_t ones_mag(int32_t v) {
+    return (uint32_t)(v ^ (v >> 31));
+}
+
+/**
+ * @brief In-place block-floating-point radix-4 DIF FFT, output in base-4 digit-reversed order
+ * @param x Interleaved re/im buffer of N complex values
+ * @param tw Twiddle table, tw[2k] = cos(2*pi*k/N), tw[2k+1] = sin(2*pi*k/N)
+ * @param bits Bit length of the largest input component magnitude
+ * @return Total right shift applied, the result is X / 2^shift
+ * @note A butterfly grows a component by at most 4 * sqrt(2), so a stage
+ *       whose input stays within 2^12 runs unscaled and larger inputs are
+ *       shifted (with rounding) just enough to fit. Scaling only when a stage
+ *       could overflow keeps small signals well above the rounding noise,
+ *       which a fixed 1/4 per stage would let dominate.
+ */
+static int fft_radix4_q15(int16_t *x, const int16_t *tw, int bits) {
+    int total = 0;
+
+    for(uint32_t n2 = N; n2 > 1; n2 >>= 2) {
+        uint32_t n1 = n2 >> 2;
+        uint32_t ie = N / n2;
+        int sh = bits > 12 ? bits - 12 : 0;
+        int32_t half = (1 << sh) >> 1;
+        uint32_t seen = 0;
+
+        for(uint32_t j = 0; j < n1; j++) {
+            int32_t c1 = tw[2 * (j * ie)],     s1 = tw[2 * (j * ie) + 1];
+            int32_t c2 = tw[2 * (2 * j * ie)], s2 = tw[2 * (2 * j * ie) + 1];
+            int32_t c3 = tw[2 * (3 * j * ie)], s3 = tw[2 * (3 * j * ie) + 1];
+
+            for(uint32_t i = j; i < N; i += n2) {
+                int16_t *a = &x[2 * i];
+                int16_t *b = &x[2 * (i + n1)];
+                int16_t *c = &x[2 * (i + 2 * n1)];
+                int16_t *d = &x[2 * (i + 3 * n1)];
+
+                int32_t ar = (a[0] + half) >> sh, ai = (a[1] + half) >> sh;
+                int32_t br = (b[0] + half) >> sh, bi = (b[1] + half) >> sh;
+                int32_t cr = (c[0] + half) >> sh, ci = (c[1] + half) >> sh;
+                int32_t dr = (d[0] + half) >> sh, di = (d[1] + half) >> sh;
+
+                int32_t t0r = ar + cr, t0i = ai + ci;
+                int32_t t1r = ar - cr, t1i = ai - ci;
+                int32_t t2r = br + dr, t2i = bi + di;
+                int32_t t3r = br - dr, t3i = bi - di;
+
+                /* y0 = t0 + t2, y1 = t1 - j*t3, y2 = t0 - t2, y3 = t1 + j*t3 */
+                int32_t y1r = t1r + t3i, y1i = t1i - t3r;
+                int32_t y2r = t0r - t2r, y2i = t0i - t2i;
+                int32_t y3r = t1r - t3i, y3i = t1i + t3r;
+
+                a[0] = (int16_t)(t0r + t2r);
+                a[1] = (int16_t)(t0i + t2i);
+
+                /* Multiply by W^k = cos - j*sin */
+                b[0] = sat_q15(y1r * c1 + y1i * s1);
+                b[1] = sat_q15(y1i * c1 - y1r * s1);
+                c[0] = sat_q15(y2r * c2 + y2i * s2);
+                c[1] = sat_q15(y2i * c2 - y2r * s2);
+                d[0] = sat_q15(y3r * c3 + y3i * s3);
+                d[1] = sat_q15(y3i * c3 - y3r * s3);
+
+                /* OR of one's-complement magnitudes bounds the next stage's input */
+                seen |= ones_mag(a[0]) | ones_mag(a[1]) | ones_mag(b[0]) | ones_mag(b[1]) |
+                        ones_mag(c[0]) | ones_mag(c[1]) | ones_mag(d[0]) | ones_mag(d[1]);
+            }
+        }
+        total += sh;
+        bits = bit_length(seen);
+    }
+    return total;
+}
+
+/**
+ * @brief Window two axes into the work buffer, transform and accumulate both periodograms
+ * @param sp Pointer to analyzer state
+ * @param ax_a Axis placed in real part
+ * @param ax_b Axis placed in imaginary part
+ */
+static void process_pair(icm42688_spectrum_t *sp, int ax_a, int ax_b) {
+    int16_t *x = sp->work;
+    uint32_t seen = 0;
+
+    /* Block exponent of the windowed frame: full Q30 products, normalized below 2^14 */
+    for(uint32_t n = 0; n < N; n++) {
+        uint32_t idx = (sp->pos + n) & (N - 1);
+        int32_t pa = (int32_t)sp->ring[ax_a][idx] * sp->window[n];
+        int32_t pb = (int32_t)sp->ring[ax_b][idx] * sp->window[n];
+        seen |= ones_mag(pa) | ones_mag(pb);
+    }
+    if(!seen) return;
+
+    int norm = bit_length(seen) - 14;
+    for(uint32_t n = 0; n < N; n++) {
+        uint32_t idx = (sp->pos + n) & (N - 1);
+        int32_t pa = (int32_t)sp->ring[ax_a][idx] * sp->window[n];
+        int32_t pb = (int32_t)sp->ring[ax_b][idx] * sp->window[n];
+        if(norm > 0) {
+            int32_t half = 1 << (norm - 1);
+            x[2 * n]     = (int16_t)((pa + half) >> norm);
+            x[2 * n + 1] = (int16_t)((pb + half) >> norm);
+        } else {
+            x[2 * n]     = (int16_t)(pa * (1 << -norm));
+            x[2 * n + 1] = (int16_t)(pb * (1 << -norm));
+        }
+    }
+
+    /* X = FFT(x) * 2^(norm - 15 + shift); accumulators hold |X/N|^2 in Q8, 4|A|^2 below */
+    int shift = fft_radix4_q15(x, sp->twiddle, 14);
+    int exp2 = 2 * (norm - 15 + shift) + 8 - 2 * LOG2N - 2;
+    if(exp2 <= -64) return;
+
+    /* Split Z = A + jB: 2A[k] = Z[k] + Z*[N-k], 2B[k] = (Z[k] - Z*[N-k]) / j */
+    for(uint32_t k = 0; k <= HALF; k++) {
+        const int16_t *zk = &x[2 * sp->reorder[k]];
+        const int16_t *zn = &x[2 * sp->reorder[(N - k) & (N - 1)]];
+
+        int64_t ar = zk[0] + zn[0], ai = zk[1] - zn[1];
+        int64_t br = zk[1] + zn[1], bi = zk[0] - zn[0];
+        uint64_t pa = (uint64_t)(ar * ar + ai * ai);
+        uint64_t pb = (uint64_t)(br * br + bi * bi);
+
+        if(exp2 >= 0) {
+            sp->psd[ax_a][k] += pa << exp2;
+            sp->psd[ax_b][k] += pb << exp2;
+        } else {
+            uint64_t half = (uint64_t)1 << (-exp2 - 1);
+            sp->psd[ax_a][k] += (pa + half) >> -exp2;
+            sp->psd[ax_b][k] += (pb + half) >> -exp2;
+        }
+    }
+}
+
+#else
+
+/**
+ * @brief In-place float radix-2 DIT FFT, input in bit-reversed order
+ * @param sp Pointer to analyzer state (uses re/im work buffers and per-stage twiddles)
+ * @note Twiddles of the stage with half-size h are stored contiguously at
+ *       offset h-1 so the inner loop is unit-stride and vectorizes.
+ */
+static void fft_radix2_f32(icm42688_spectrum_t *sp) {
+    float *restrict re = sp->re;
+    float *restrict im = sp->im;
+
+    for(uint32_t h = 1; h < N; h <<= 1) {
+        const float *restrict wr = &sp->tw_re[h - 1];
+        const float *restrict wi = &sp->tw_im[h - 1];
+
+        for(uint32_t g = 0; g < N; g += 2 * h) {
+            float *restrict ur = &re[g], *restrict ui = &im[g];
+            float *restrict vr = &re[g + h], *restrict vi = &im[g + h];
+
+            for(uint32_t k = 0; k < h; k++) {
+                float tr = vr[k] * wr[k] - vi[k] * wi[k];
+                float ti = vr[k] * wi[k] + vi[k] * wr[k];
+                vr[k] = ur[k] - tr;
+                vi[k] = ui[k] - ti;
+                ur[k] += tr;
+                ui[k] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Window two axes into the work buffers, transform and accumulate both periodograms
+ * @param sp Pointer to analyzer state
+ * @param ax_a Axis placed in real part
+ * @param ax_b Axis placed in imaginary part
+ */
+static void process_pair(icm42688_spectrum_t *sp, int ax_a, int ax_b) {
+    for(uint32_t n = 0; n < N; n++) {
+        uint32_t idx = (sp->pos + n) & (N - 1);
+        uint32_t dst = sp->reorder[n];
+        sp->re[dst] = (float)sp->ring[ax_a][idx] * sp->window[n];
+        sp->im[dst] = (float)sp->ring[ax_b][idx] * sp->window[n];
+    }
+
+    fft_radix2_f32(sp);
+
+    /* Split Z = A + jB: A[k] = (Z[k] + Z*[N-k]) / 2, B[k] = (Z[k] - Z*[N-k]) / 2j */
+    for(uint32_t k = 0; k <= HALF; k++) {
+        uint32_t m = (N - k) & (N - 1);
+        float ar = 0.5f * (sp->re[k] + sp->re[m]), ai = 0.5f * (sp->im[k] - sp->im[m]);
+        float br = 0.5f * (sp->im[k] + sp->im[m]), bi = 0.5f * (sp->re[k] - sp->re[m]);
+
+        sp->psd[ax_a][k] += (double)(ar * ar + ai * ai);
+        sp->psd[ax_b][k] += (double)(br * br + bi * bi);
+    }
+}
+
+#endif /* ICM42688_SPECTRUM_FIXED */
+
+int icm42688_spectrum_init(icm42688_spectrum_t *sp, float fs_hz) {
+    if(!sp || !(fs_hz > 0.0f)) return -1;
+
+    memset(sp, 0, sizeof(*sp));
+    sp->fs_hz = fs_hz;
+
+    /* Periodic Hann window */
+    float power = 0.0f;
+    for(uint32_t n = 0; n < N; n++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * PI_F * (float)n / (float)N);
+#if ICM42688_SPECTRUM_FIXED
+        sp->window[n] = (int16_t)lrintf(w * 32767.0f);
+        w = (float)sp->window[n] / 32768.0f;
+#else
+        sp->window[n] = w;
+#endif
+        power += w * w;
+    }
+    sp->window_power = power;
+
+#if ICM42688_SPECTRUM_FIXED
+    for(uint32_t k = 0; k < N; k++) {
+        float a = 2.0f * PI_F * (float)k / (float)N;
+        sp->twiddle[2 * k]     = (int16_t)lrintf(cosf(a) * 32767.0f);
+        sp->twiddle[2 * k + 1] = (int16_t)lrintf(sinf(a) * 32767.0f);
+    }
+
+    /* Base-4 digit reversal */
+    for(uint32_t k = 0; k < N; k++) {
+        uint32_t r = 0;
+        for(uint32_t v = k, m = N; m > 1; m >>= 2, v >>= 2) {
+            r = (r << 2) | (v & 3);
+        }
+        sp->reorder[k] = (uint16_t)r;
+    }
+#else
+    for(uint32_t h = 1; h < N; h <<= 1) {
+        for(uint32_t k = 0; k < h; k++) {
+            float a = -PI_F * (float)k / (float)h;
+            sp->tw_re[h - 1 + k] = cosf(a);
+            sp->tw_im[h - 1 + k] = sinf(a);
+        }
+    }
+
+    /* Base-2 bit reversal */
+    for(uint32_t k = 0; k < N; k++) {
+        uint32_t r = 0;
+        for(uint32_t v = k, m = N; m > 1; m >>= 1, v >>= 1) {
+            r = (r << 1) | (v & 1);
+        }
+        sp->reorder[k] = (uint16_t)r;
+    }
+#endif
+
+    return 0;
+}
+
+int icm42688_spectrum_push(icm42688_spectrum_t *sp, const icm42688_data_t *data) {
+    if(!sp || !data) return -1;
+
+    uint16_t p = sp->pos;
+    sp->ring[ICM42688_AXIS_ACCEL_X][p] = data->accel_x;
+    sp->ring[ICM42688_AXIS_ACCEL_Y][p] = data->accel_y;
+    sp->ring[ICM42688_AXIS_ACCEL_Z][p] = data->accel_z;
+    sp->ring[ICM42688_AXIS_GYRO_X][p]  = data->gyro_x;
+    sp->ring[ICM42688_AXIS_GYRO_Y][p]  = data->gyro_y;
+    sp->ring[ICM42688_AXIS_GYRO_Z][p]  = data->gyro_z;
+    sp->pos = (uint16_t)((p + 1) & (N - 1));
+
+    if(sp->seen < N) sp->seen++;
+    if(++sp->fill < ICM42688_SPECTRUM_HOP || sp->seen < N) return 0;
+    sp->fill = 0;
+
+    process_pair(sp, ICM42688_AXIS_ACCEL_X, ICM42688_AXIS_ACCEL_Y);
+    process_pair(sp, ICM42688_AXIS_ACCEL_Z, ICM42688_AXIS_GYRO_X);
+    process_pair(sp, ICM42688_AXIS_GYRO_Y, ICM42688_AXIS_GYRO_Z);
+    sp->frames++;
+
+    return 1;
+}
+
+void icm42688_spectrum_reset(icm42688_spectrum_t *sp) {
+    if(!sp) return;
+
+    memset(sp->psd, 0, sizeof(sp->psd));
+    sp->frames = 0;
+}
+
+/**
+ * @brief One-sided PSD value of a single bin
+ * @param sp Pointer to analyzer state
+ * @param axis Axis index
+ * @param k Bin index (0..N/2)
+ * @return PSD in LSB^2/Hz
+ */
+static float bin_psd(const icm42688_spectrum_t *sp, int axis, uint32_t k) {
+    /* Welch: P[k] = c * |X[k]|^2 / (fs * sum(w^2)), c = 2 except at DC and Nyquist */
+    float scale = ((k == 0 || k == HALF) ? 1.0f : 2.0f) / (sp->fs_hz * sp->window_power * (float)sp->frames);
+#if ICM42688_SPECTRUM_FIXED
+    /* Accumulators hold |X/N|^2 in Q8 */
+    scale *= (float)N * (float)N / 256.0f;
+#endif
+    return (float)sp->psd[axis][k] * scale;
+}
+
+int icm42688_spectrum_get_psd(const icm42688_spectrum_t *sp, icm42688_axis_t axis, float *psd) {
+    if(!sp || !psd || (unsigned)axis >= ICM42688_SPECTRUM_AXES) return -1;
+    if(sp->frames == 0) return -3;
+
+    for(uint32_t k = 0; k <= HALF; k++) {
+        psd[k] = bin_psd(sp, axis, k);
+    }
+    return 0;
+}
+
+int icm42688_spectrum_peak(const icm42688_spectrum_t *sp, icm42688_axis_t axis, icm42688_peak_t *peak) {
+    if(!sp || !peak || (unsigned)axis >= ICM42688_SPECTRUM_AXES) return -1;
+    if(sp->frames == 0) return -3;
+
+    uint32_t best = 1;
+    for(uint32_t k = 2; k < HALF; k++) {
+        if(sp->psd[axis][k] > sp->psd[axis][best]) best = k;
+    }
+
+    /* Parabolic interpolation between neighbouring bins */
+    float a = bin_psd(sp, axis, best - 1);
+    float b = bin_psd(sp, axis, best);
+    float c = bin_psd(sp, axis, best + 1);
+    float denom = a - 2.0f * b + c;
+    float delta = (denom != 0.0f) ? 0.5f * (a - c) / denom : 0.0f;
+    if(delta < -0.5f || delta > 0.5f) delta = 0.0f;
+
+    peak->freq_hz = ((float)best + delta) * sp->fs_hz / (float)N;
+    peak->power = b;
+    return 0;
+}
+
+int icm42688_spectrum_band_energy(const icm42688_spectrum_t *sp, icm42688_axis_t axis,
+                                  float f_lo_hz, float f_hi_hz, float *energy) {
+    if(!sp || !energy || (unsigned)axis >= ICM42688_SPECTRUM_AXES) return -1;
+    if(f_hi_hz < f_lo_hz) return -1;
+    if(sp->frames == 0) return -3;
+
+    float df = sp->fs_hz / (float)N;
+    float sum = 0.0f;
+
+    for(uint32_t k = 0; k <= HALF; k++) {
+        float f = (float)k * df;
+        if(f >= f_lo_hz && f <= f_hi_hz) sum += bin_psd(sp, axis, k);
+    }
+
+    *energy = sum * df;
+    return 0;
+}
+
+#endif /* ICM42688_CFG_SPECTRUM */
@@ -6,8 +6,11 @@
  */
 
 #include "spi_driver.h"
+#include "trace.h"
 #include "stm32f1xx_hal.h"
 
+#if ICM42688_CFG_SPI
+
 extern SPI_HandleTypeDef hspi1;
 
 #define READ_FLAG 0x80 /**< SPI read flag bit */
@@ -22,36 +25,46 @@ void spi_cs_disable(void) {
 
 int spi_read_wrapper(uint8_t reg, uint8_t *data, uint16_t len) {
     uint8_t tx_data = reg | READ_FLAG;
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_BUS_READ, len);
     spi_cs_enable();
 
     if(HAL_SPI_Transmit(&hspi1, &tx_data, 1, 1000) != HAL_OK) {
         spi_cs_disable();
+        ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_READ, 0);
         return -1;
     }   
 
     if(HAL_SPI_Receive(&hspi1, data, len, 1000) != HAL_OK) {
         spi_cs_disable();
+        ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_READ, 0);
         return -2;
     }
 
     spi_cs_disable();
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_READ, len);
     return 0;
 }
 
 int spi_write_wrapper(uint8_t reg, uint8_t *data, uint16_t len) {
     uint8_t tx_data = reg & 0x7F;
+    ICM42688_TRACE_BEGIN(ICM42688_TRACE_EV_BUS_WRITE, len);
     spi_cs_enable();
 
     if(HAL_SPI_Transmit(&hspi1, &tx_data, 1, 1000) != HAL_OK) {
         spi_cs_disable();
+        ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_WRITE, 0);
         return -1;
     }
 
     if(HAL_SPI_Transmit(&hspi1, data, len, 1000) != HAL_OK) {
         spi_cs_disable();
+        ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_WRITE, 0);
         return -2;
     }
 
     spi_cs_disable();
+    ICM42688_TRACE_END(ICM42688_TRACE_EV_BUS_WRITE, len);
     return 0;
 }
+
+#endif /* ICM42688_CFG_SPI */
@@ -0,0 +1,255 @@
+/**
+ * @file time_align.c
+ * @brief Cross-sensor clock alignment and k-way timestamp merge implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#include "time_align.h"
+#include <string.h>
+
+#if ICM42688_CFG_TIME_ALIGN
+
+_Static_assert(ICM42688_TIMESYNC_WINDOW >= 2 && ICM42688_TIMESYNC_WINDOW <= 255,
+               "timestamp window must fit the 8-bit count");
+_Static_assert(ICM42688_MERGE_MAX_STREAMS >= 1 && ICM42688_MERGE_MAX_STREAMS <= 127,
+               "heap indices are 8 bit");
+
+/**
+ * @brief Signed distance between two raw counter values
+ * @param est Pointer to estimator
+ * @param raw Raw sensor timestamp
+ * @return raw - last_raw, sign-extended from the counter width
+ */
+static inline int64_t raw_delta(const icm42688_clock_est_t *est, uint32_t raw) {
+    uint32_t d = (raw - est->last_raw) & est->ts_mask;
+    uint32_t half = (est->ts_mask >> 1) + 1;
+    return d >= half ? (int64_t)d - (int64_t)est->ts_mask - 1 : (int64_t)d;
+}
+
+int icm42688_clock_init(icm42688_clock_est_t *est, uint8_t ts_bits) {
+    if(!est || ts_bits < 8 || ts_bits > 32) return -1;
+
+    memset(est, 0, sizeof(*est));
+    est->ts_mask = ts_bits == 32 ? 0xFFFFFFFFu : (1UL << ts_bits) - 1;
+    est->skew = 1.0;
+    return 0;
+}
+
+int icm42688_clock_add(icm42688_clock_est_t *est, uint32_t sensor_us, int64_t host_us) {
+    if(!est || !est->ts_mask) return -1;
+
+    sensor_us &= est->ts_mask;
+    if(est->count == 0) {
+        est->last_unwrapped = sensor_us;
+    } else {
+        est->last_unwrapped += raw_delta(est, sensor_us);
+    }
+    est->last_raw = sensor_us;
+
+    est->sensor_us[est->pos] = est->last_unwrapped;
+    est->host_us[est->pos] = host_us;
+    est->pos = (uint8_t)((est->pos + 1) % ICM42688_TIMESYNC_WINDOW);
+    if(est->count < ICM42688_TIMESYNC_WINDOW) est->count++;
+
+    /* Fit relative to the newest pair so mapping recent timestamps stays exact */
+    est->ref_sensor_us = est->last_unwrapped;
+    est->ref_host_us = host_us;
+
+    double sx = 0.0, sy = 0.0;
+    for(uint8_t i = 0; i < est->count; i++) {
+        sx += (double)(est->sensor_us[i] - est->ref_sensor_us);
+        sy += (double)(est->host_us[i] - est->ref_host_us);
+    }
+    double mx = sx / est->count;
+    double my = sy / est->count;
+
+    double sxx = 0.0, sxy = 0.0;
+    for(uint8_t i = 0; i < est->count; i++) {
+        double dx = (double)(est->sensor_us[i] - est->ref_sensor_us) - mx;
+        double dy = (double)(est->host_us[i] - est->ref_host_us) - my;
+        sxx += dx * dx;
+        sxy += dx * dy;
+    }
+
+    est->skew = (sxx > 0.0) ? sxy / sxx : 1.0;
+    est->offset_us = my - est->skew * mx;
+    est->updates++;
+    return 0;
+}
+
+int64_t icm42688_clock_map(const icm42688_clock_est_t *est, uint32_t sensor_us) {
+    if(!est || est->count == 0) return 0;
+
+    int64_t s = est->last_unwrapped + raw_delta(est, sensor_us);
+    double rel = est->offset_us + est->skew * (double)(s - est->ref_sensor_us);
+    return est->ref_host_us + (int64_t)(rel < 0.0 ? rel - 0.5 : rel + 0.5);
+}
+
+/**
+ * @brief Heap ordering: earlier time first, stream index breaks ties
+ * @param a First node
+ * @param b Second node
+ * @return Nonzero if a sorts before b
+ */
+static inline int node_less(const icm42688_merge_node_t *a, const icm42688_merge_node_t *b) {
+    return a->host_us < b->host_us || (a->host_us == b->host_us && a->stream < b->stream);
+}
+
+/**
+ * @brief Store a node at a heap index and record where its stream lives
+ * @param m Pointer to merger
+ * @param i Heap index
+ * @param node Node to store
+ */
+static inline void heap_place(icm42688_merge_t *m, uint8_t i, icm42688_merge_node_t node) {
+    m->heap[i] = node;
+    m->where[node.stream] = i;
+}
+
+/**
+ * @brief Restore heap order downwards from index i
+ * @param m Pointer to merger
+ * @param i Start index
+ */
+static void sift_down(icm42688_merge_t *m, uint8_t i) {
+    icm42688_merge_node_t node = m->heap[i];
+
+    for(;;) {
+        uint8_t child = (uint8_t)(2 * i + 1);
+        if(child >= m->size) break;
+        if(child + 1 < m->size && node_less(&m->heap[child + 1], &m->heap[child])) child++;
+        if(!node_less(&m->heap[child], &node)) break;
+        heap_place(m, i, m->heap[child]);
+        i = child;
+    }
+    heap_place(m, i, node);
+}
+
+/**
+ * @brief Restore heap order upwards from index i
+ * @param m Pointer to merger
+ * @param i Start index
+ * @return Final index of the node
+ */
+static uint8_t sift_up(icm42688_merge_t *m, uint8_t i) {
+    icm42688_merge_node_t node = m->heap[i];
+
+    while(i > 0) {
+        uint8_t parent = (uint8_t)((i - 1) / 2);
+        if(!node_less(&node, &m->heap[parent])) break;
+        heap_place(m, i, m->heap[parent]);
+        i = parent;
+    }
+    heap_place(m, i, node);
+    return i;
+}
+
+/**
+ * @brief Host time of the next pending sample of a stream
+ * @param s Pointer to stream
+ * @return Host timestamp
+ */
+static inline int64_t head_time(icm42688_merge_stream_t *s) {
+    s->clock_updates = s->clock->updates;
+    return icm42688_clock_map(s->clock, s->sensor_ts[s->pos]);
+}
+
+int icm42688_merge_init(icm42688_merge_t *m, uint8_t k, const icm42688_clock_est_t *clocks) {
+    if(!m || !clocks || k == 0 || k > ICM42688_MERGE_MAX_STREAMS) return -1;
+
+    memset(m, 0, sizeof(*m));
+    m->k = k;
+    for(uint8_t i = 0; i < k; i++) {
+        m->streams[i].clock = &clocks[i];
+        m->streams[i].open = 1;
+    }
+    m->starved = k;
+    m->last_host_us = INT64_MIN;
+    return 0;
+}
+
+int icm42688_merge_feed(icm42688_merge_t *m, uint8_t stream, const icm42688_data_t *samples,
+                        const uint32_t *sensor_ts, uint32_t count) {
+    if(!m || stream >= m->k || (count && (!samples || !sensor_ts))) return -1;
+
+    icm42688_merge_stream_t *s = &m->streams[stream];
+    if(!s->open) return -1;
+    if(s->pos < s->count) return -3;
+    if(count == 0) return 0;
+
+    s->samples = samples;
+    s->sensor_ts = sensor_ts;
+    s->count = count;
+    s->pos = 0;
+
+    icm42688_merge_node_t node = { head_time(s), stream };
+    m->heap[m->size] = node;
+    sift_up(m, m->size++);
+    m->starved--;
+    return 0;
+}
+
+int icm42688_merge_close(icm42688_merge_t *m, uint8_t stream) {
+    if(!m || stream >= m->k) return -1;
+
+    icm42688_merge_stream_t *s = &m->streams[stream];
+    if(!s->open) return 0;
+
+    s->open = 0;
+    if(s->pos >= s->count) m->starved--;
+    return 0;
+}
+
+int icm42688_merge_refit(icm42688_merge_t *m, uint8_t stream) {
+    if(!m || stream >= m->k) return -1;
+
+    icm42688_merge_stream_t *s = &m->streams[stream];
+    if(s->pos >= s->count || s->clock_updates == s->clock->updates) return 0;
+
+    /* Only this stream's key moved: sift it whichever way it went */
+    uint8_t i = m->where[stream];
+    m->heap[i].host_us = head_time(s);
+    sift_down(m, sift_up(m, i));
+    return 0;
+}
+
+int icm42688_merge_next(icm42688_merge_t *m, icm42688_merge_item_t *item) {
+    if(!m || !item) return -1;
+    if(m->starved || m->size == 0) return 0;
+
+    icm42688_merge_node_t top = m->heap[0];
+    icm42688_merge_stream_t *s = &m->streams[top.stream];
+
+    /* A refit can pull a stream head slightly behind what was already emitted */
+    if(top.host_us < m->last_host_us) top.host_us = m->last_host_us;
+    m->last_host_us = top.host_us;
+
+    item->host_us = top.host_us;
+    item->sample = &s->samples[s->pos];
+    item->stream = top.stream;
+    s->pos++;
+
+    if(s->pos < s->count) {
+        /* Replace root with the stream's next head: one sift instead of pop + push */
+        m->heap[0].host_us = head_time(s);
+    } else {
+        heap_place(m, 0, m->heap[--m->size]);
+        if(s->open) m->starved++;
+    }
+    if(m->size) sift_down(m, 0);
+
+    return 1;
+}
+
+int icm42688_merge_starved_stream(const icm42688_merge_t *m) {
+    if(!m || !m->starved) return -1;
+
+    for(uint8_t i = 0; i < m->k; i++) {
+        const icm42688_merge_stream_t *s = &m->streams[i];
+        if(s->open && s->pos >= s->count) return i;
+    }
+    return -1;
+}
+
+#endif /* ICM42688_CFG_TIME_ALIGN */
@@ -0,0 +1,212 @@
+/**
+ * @file trace.c
+ * @brief Pipeline tracing implementation
+ * @author Yusuf Karaböcek
+ * @date October 2026
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* sched_getcpu, syscall */
+#endif
+
+#include "trace.h"
+
+#ifdef ICM42688_TRACE_ENABLE
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(__ARM_ARCH_6M__)
+uint32_t HAL_GetTick(void);
+#endif
+
+#define TRACE_MASK (ICM42688_TRACE_DEPTH - 1)
+
+_Static_assert((ICM42688_TRACE_DEPTH & TRACE_MASK) == 0, "trace depth must be a power of 2");
+
+/* DWT cycle counter and its enable bits (ARMv7-M) */
+#define DEMCR       (*(volatile uint32_t *)0xE000EDFCu)
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004u)
+#define DEMCR_TRCENA      (1u << 24)
+#define DWT_CTRL_CYCCNTENA (1u << 0)
+
+/* SysTick and the pending bit of its interrupt (ARMv6-M fallback) */
+#define SYST_RVR    (*(volatile uint32_t *)0xE000E014u)
+#define SYST_CVR    (*(volatile uint32_t *)0xE000E018u)
+#define SCB_ICSR    (*(volatile uint32_t *)0xE000ED04u)
+#define ICSR_PENDSTSET     (1u << 26)
+
+/**
+ * @brief Per-core ring
+ */
+typedef struct {
+    icm42688_trace_record_t rec[ICM42688_TRACE_DEPTH]; /**< Events */
+    uint32_t next;                                     /**< Total events reserved (wraps) */
+} trace_ring_t;
+
+static trace_ring_t g_trace[ICM42688_TRACE_CORES];
+static uint32_t g_trace_hz;
+
+#if ICM42688_TRACE_TID && defined(__linux__)
+static _Thread_local uint32_t t_tid;
+#endif
+
+#if !defined(__linux__) && defined(__ARM_ARCH_6M__)
+/**
+ * @brief Core cycles from SysTick and the tick count (no DWT on ARMv6-M)
+ *
+ * The tick and the pending flag are re-read until they are stable around the
+ * counter read. A pending SysTick interrupt means the counter has reloaded
+ * but the tick has not been incremented yet (caller in a higher-priority
+ * handler or with interrupts masked), so one period is added.
+ *
+ * @return Cycles, 32 bits wrapping
+ */
+static inline uint32_t systick_now(void) {
+    uint32_t tick, pend, val;
+
+    do {
+        tick = ICM42688_TRACE_TICK();
+        pend = SCB_ICSR & ICSR_PENDSTSET;
+        val = SYST_CVR;
+    } while(tick != ICM42688_TRACE_TICK() || pend != (SCB_ICSR & ICSR_PENDSTSET));
+
+    uint32_t reload = SYST_RVR & 0x00FFFFFFu;
+    if(pend) tick++;
+    return tick * (reload + 1) + (reload - val);
+}
+#endif
+
+/**
+ * @brief Read the timestamp source
+ * @return Cycles (Cortex-M) or nanoseconds (Linux)
+ */
+static inline uint64_t trace_now(void) {
+#if defined(__linux__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#elif defined(__ARM_ARCH_6M__)
+    return systick_now();
+#else
+    return DWT_CYCCNT;
+#endif
+}
+
+#if ICM42688_TRACE_TID
+/**
+ * @brief Thread id of the caller, cached per thread
+ * @return Kernel thread id (Linux), 0 elsewhere
+ */
+static inline uint32_t trace_tid(void) {
+#if defined(__linux__)
+    if(!t_tid) t_tid = (uint32_t)syscall(SYS_gettid);  /* gettid() needs glibc 2.30 */
+    return t_tid;
+#else
+    return 0;
+#endif
+}
+#endif
+
+/**
+ * @brief Current core index
+ * @return Index into g_trace
+ */
+static inline uint32_t trace_core(void) {
+#if defined(__linux__) && ICM42688_TRACE_CORES > 1
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : (uint32_t)cpu % ICM42688_TRACE_CORES;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Reserve the next slot of a ring
+ * @param ring Pointer to ring
+ * @return Reserved sequence number
+ */
+static inline uint32_t trace_reserve(trace_ring_t *ring) {
+#if defined(__ARM_ARCH_6M__)
+    /* No LDREX/STREX on Cortex-M0: mask interrupts instead */
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+    uint32_t idx = ring->next++;
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+    return idx;
+#else
+    return __atomic_fetch_add(&ring->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+void icm42688_trace_init(uint32_t ts_hz) {
+    memset(g_trace, 0, sizeof(g_trace));
+
+#if defined(__linux__)
+    (void)ts_hz;
+    g_trace_hz = 1000000000u;
+#elif defined(__ARM_ARCH_6M__)
+    g_trace_hz = ts_hz;
+#else
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    g_trace_hz = ts_hz;
+#endif
+}
+
+void icm42688_trace_record(uint16_t event, uint8_t phase, uint32_t arg) {
+    uint32_t core = trace_core();
+    trace_ring_t *ring = &g_trace[core];
+    icm42688_trace_record_t *r = &ring->rec[trace_reserve(ring) & TRACE_MASK];
+
+    r->ts = trace_now();
+    r->arg = arg;
+    r->event = event;
+    r->phase = phase;
+    r->core = (uint8_t)core;
+#if ICM42688_TRACE_TID
+    r->tid = trace_tid();
+    r->reserved = 0;
+#endif
+}
+
+int icm42688_trace_dump(icm42688_trace_write_t write, void *ctx) {
+    if(!write) return -1;
+
+    icm42688_trace_header_t hdr;
+    hdr.magic = ICM42688_TRACE_MAGIC;
+    hdr.version = ICM42688_TRACE_VERSION;
+#if defined(__linux__)
+    hdr.ts_bits = 64;
+#else
+    hdr.ts_bits = 32;
+#endif
+    hdr.cores = ICM42688_TRACE_CORES;
+    hdr.ts_hz = g_trace_hz;
+    hdr.depth = ICM42688_TRACE_DEPTH;
+    hdr.record_size = sizeof(icm42688_trace_record_t);
+    hdr.reserved = 0;
+    if(write(ctx, &hdr, sizeof(hdr)) != 0) return -2;
+
+    for(uint32_t c = 0; c < ICM42688_TRACE_CORES; c++) {
+        const trace_ring_t *ring = &g_trace[c];
+        uint32_t next = __atomic_load_n(&ring->next, __ATOMIC_ACQUIRE);
+        uint32_t count = next < ICM42688_TRACE_DEPTH ? next : ICM42688_TRACE_DEPTH;
+        uint32_t start = (next - count) & TRACE_MASK;
+        uint32_t first = ICM42688_TRACE_DEPTH - start;
+        if(first > count) first = count;
+
+        if(write(ctx, &count, sizeof(count)) != 0) return -2;
+        if(first && write(ctx, &ring->rec[start], first * sizeof(icm42688_trace_record_t)) != 0) return -2;
+        if(count > first && write(ctx, &ring->rec[0], (count - first) * sizeof(icm42688_trace_record_t)) != 0) return -2;
+    }
+    return 0;
+}
+
+#endif /* ICM42688_TRACE_ENABLE */